@@ -1,16 +1,25 @@
 import logging
 import math
+import os
 from typing import Dict, List, Any, Tuple
 
-import subprocess
 import pandas as pd
 import phdTester as phd
 from phdTester.common_types import PathStr, DataTypeStr
+from phdTester.exceptions import ExternalProgramFailureError
 from phdTester.datasources.mysql_sources import MySqlDataSource, MySqlASCIIResourceManager, MySqlBinaryResourceManager
 from phdTesterExample import supports
 from phdTesterExample.models import SortSettings, SortEnvironment, SortAlgorithm, SortTestContext, SortAlgorithmMask, \
     SortEnvironmentMask, SortTestContextMask, PerformanceCsvRow
 from phdTesterExample.supports import SortPerformanceCsv
+from phdTesterExample.tester_server import TesterServer
+
+try:
+    # the tester as a Python module (SortAlgorithmTester/src/python/cpp), if it's in PYTHONPATH: test contexts run in
+    # process, without the tester server
+    import sortbench
+except ImportError:
+    sortbench = None
 
 
 class SortResearchField(phd.AbstractSpecificResearchFieldFactory):
@@ -79,6 +88,7 @@ class SortResearchField(phd.AbstractSpecificResearchFieldFactory):
     def setup_filesystem_datasource(self, filesystem: "phd.filesystem.FileSystem", settings: "SortSettings"):
         filesystem.make_folders("images")
         filesystem.make_folders("csvs")
+        filesystem.make_folders("summaries")
         filesystem.make_folders("cwd")
 
     def setup_datasource(self, datasource: "phd.IDataSource", settings: "SortSettings"):
@@ -103,37 +113,98 @@ class SortResearchField(phd.AbstractSpecificResearchFieldFactory):
     def _generate_test_context_mask(self, ut: "SortAlgorithmMask", te: "SortEnvironmentMask") -> "SortTestContextMask":
         return SortTestContextMask(ut=self.generate_stuff_under_test_mask(), te=self.generate_test_environment_mask())
 
+    def _get_tester_server(self) -> TesterServer:
+        # a single tester process executes every test context, keeping its caches warm
+        if getattr(self, "_tester_server", None) is None:
+            self._tester_server = TesterServer(working_directory=self.filesystem_datasource.get_path("cwd"))
+        return self._tester_server
+
+    def _get_sortbench_environment(self) -> "sortbench.Environment":
+        # as the tester server, the environment keeps its sequence cache between test contexts
+        if getattr(self, "_sortbench_environment", None) is None:
+            self._sortbench_environment = sortbench.Environment(sequenceCache=256 << 20)
+        return self._sortbench_environment
+
+    def _execute_in_process(self, context: Dict[str, Any], performance_ks001: str, summary_ks001: str):
+        """
+        Execute a test context with the module sortbench, storing its runs in the datasource straight from the arrays
+        the module returns: the tester writes neither the main nor the summary csv, and nothing parses them
+        """
+        cwd = self.filesystem_datasource.get_path("cwd")
+        # a campaign interrupted halfway resumes without running again what it completed, as with skipIfComplete
+        if self.datasource.contains("csvs", performance_ks001, "csv") and \
+                self.datasource.contains("summaries", summary_ks001, "csv"):
+            return
+
+        context = dict(context)
+        # there are no files recording the completion of the context: the datasource does
+        del context["skipIfComplete"]
+        context["noResultFiles"] = True
+        # the other reports are written relative to the working directory of this process, not the one of the tester
+        # server
+        context["outputTemplate"] = os.path.join(cwd, context["outputTemplate"])
+        try:
+            results = sortbench.run(context, self._get_sortbench_environment())
+        except (sortbench.Error, ValueError) as e:
+            raise ExternalProgramFailureError(exit_code=-1, cwd=cwd, program=f"sortbench.run({context}): {e}")
+        if results.exit_code != 0:
+            raise ExternalProgramFailureError(exit_code=results.exit_code, cwd=cwd, program=f"sortbench.run({context})")
+
+        # the columns are arrays on the memory of the module: the dataframe is the first copy of the runs
+        runs = pd.DataFrame({name: getattr(results, name) for name in results.columns})
+        runs["status"] = runs["status"].map({0: "ok", 1: "timeout"})
+        self.datasource.save_at("csvs", performance_ks001, "csv", runs.to_csv(index=False))
+
+        # the summary the tester writes, from the runs which completed. Times are in microseconds
+        times = runs.time[runs.status == "ok"]
+        summary = pd.DataFrame([{
+            "runs": len(times),
+            "mean": times.mean(),
+            "stddev": times.std(ddof=0),
+            "p50": times.quantile(0.5, interpolation="higher"),
+            "p90": times.quantile(0.9, interpolation="higher"),
+            "p99": times.quantile(0.99, interpolation="higher"),
+            "p999": times.quantile(0.999, interpolation="higher"),
+            "max": times.max(),
+        }]).fillna(0)
+        self.datasource.save_at("summaries", summary_ks001, "csv", summary.to_csv(index=False, float_format="%.3f"))
+
     def perform_test(self, tc: "SortTestContext", global_settings: "phd.IGlobalSettings"):
         output_template_ks001 = tc.to_ks001(identifier='main')
         performance_ks001 = output_template_ks001.append(
             phd.KS001.from_template(output_template_ks001, label="kind", type="main"), in_place=False
         )
+        summary_ks001 = output_template_ks001.append(
+            phd.KS001.from_template(output_template_ks001, label="kind", type="summary"), in_place=False
+        )
 
-        program = [
-            "SortAlgorithmTester",
-            f"--sequenceSize={tc.te.sequenceSize}",
-            f"--sequenceType={tc.te.sequenceType}",
-            f"--algorithm={tc.ut.algorithm}",
-            f"--lowerBound={tc.te.lowerBound}",
-            f"--upperBound={tc.te.upperBound}",
-            f"--seed=0",
-            f'--outputTemplate="{output_template_ks001.dump_str()}"',
-            f'--runs={tc.te.run}'
-        ]
+        context = {
+            "sequenceSize": tc.te.sequenceSize,
+            "sequenceType": tc.te.sequenceType,
+            "algorithm": tc.ut.algorithm,
+            "lowerBound": tc.te.lowerBound,
+            "upperBound": tc.te.upperBound,
+            "seed": 0,
+            "outputTemplate": output_template_ks001.dump_str(),
+            "runs": tc.te.run,
+            # a campaign interrupted halfway resumes without running again what it completed
+            "skipIfComplete": True,
+        }
 
         if tc.ut == "COMBSORT":
-            program.extend([
-                f"--shrinkFactor={tc.ut.shrinkFactor}"
-            ])
-
-        executor = phd.ProgramExecutor()
-        try:
-            executor.execute_external_program(
-                program=' '.join(program),
-                working_directory=self.filesystem_datasource.get_path("cwd")
+            context["shrinkFactor"] = tc.ut.shrinkFactor
+
+        if sortbench is not None:
+            self._execute_in_process(context, performance_ks001.dump_str(), summary_ks001.dump_str())
+            return
+
+        exit_code = self._get_tester_server().execute(context)
+        if exit_code != 0:
+            raise ExternalProgramFailureError(
+                exit_code=exit_code,
+                cwd=self.filesystem_datasource.get_path("cwd"),
+                program=f"SortAlgorithmTester --serve <<< {context}",
             )
-        except subprocess.CalledProcessError as e:
-            raise e
 
         # ok, save the csv in the datasource
         self.filesystem_datasource.move_to(
@@ -143,6 +214,14 @@ class SortResearchField(phd.AbstractSpecificResearchFieldFactory):
             from_data_type='csv',
             to_path="csvs",
         )
+        # percentiles, mean and stddev of the runs, already computed by the tester
+        self.filesystem_datasource.move_to(
+            self.datasource,
+            from_path="cwd",
+            from_ks001=summary_ks001.dump_str(),
+            from_data_type='csv',
+            to_path="summaries",
+        )
 
     def generate_plots(self, settings: "phd.IGlobalSettings",
                        under_test_values: Dict[str, List[Any]], test_environment_values: Dict[str, List[Any]]):
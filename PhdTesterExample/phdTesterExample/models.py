@@ -119,3 +119,10 @@ class PerformanceCsvRow(phd.AbstractCSVRow):
         phd.AbstractCSVRow.__init__(self)
         self.run: int = None
         self.time: int = None
+        self.voluntaryContextSwitches: int = None
+        self.involuntaryContextSwitches: int = None
+        self.cpuMigrations: int = None
+        self.runQueueDelay: int = None
+        self.preempted: int = None
+        self.validationTime: int = None
+        self.status: str = None
@@ -0,0 +1,269 @@
+import io
+import json
+import os
+import sqlite3
+import struct
+import zlib
+from multiprocessing import shared_memory
+from typing import Dict, List, Optional
+
+import numpy as np
+import pandas as pd
+
+
+def read_binary_results(filename: str) -> pd.DataFrame:
+    """
+    Load a main result file written by SortAlgorithmTester with --outputFormat=binary
+
+    Each column is memory mapped: nothing is parsed and nothing is read until used
+
+    :param filename: the ".bin" file to load
+    :return: a dataframe with the same columns of the main csv
+    """
+    with open(filename, "rb") as f:
+        if f.read(8) != b"SORTCOL1":
+            raise ValueError(f"{filename} is not a binary result file")
+        length, = struct.unpack("<Q", f.read(8))
+        header = json.loads(f.read(length))
+
+    rows = header["rows"]
+    columns = {}
+    for column in header["columns"]:
+        values = np.memmap(filename, dtype=column["dtype"], mode="r", offset=column["offset"], shape=(rows,))
+        if "categories" in column:
+            values = pd.Categorical.from_codes(values, categories=column["categories"])
+        columns[column["name"]] = values
+    return pd.DataFrame(columns, copy=False)
+
+
+def read_arrow_results(filename: str) -> pd.DataFrame:
+    """
+    Load a main result file written by SortAlgorithmTester with --outputFormat=arrow
+
+    :param filename: the ".arrow" file to load
+    :return: a dataframe with the same columns of the main csv
+    """
+    import pyarrow as pa
+
+    with pa.memory_map(filename, "r") as source:
+        return pa.ipc.open_file(source).read_all().to_pandas()
+
+
+def read_jsonl_results(filename: str) -> pd.DataFrame:
+    """
+    Load a main result file written by SortAlgorithmTester with --outputFormat=jsonl
+
+    Nested metadata is flattened: e.g., the git revision is in the "build.gitRevision" column
+
+    :param filename: the ".jsonl" file to load
+    :return: a dataframe with the same columns of the main csv, plus one column per metadata field
+    """
+    with open(filename, "r") as f:
+        return pd.json_normalize([json.loads(line) for line in f if line.strip()])
+
+
+def read_compressed_index(filename: str) -> dict:
+    """
+    Read the index of a main result file written by SortAlgorithmTester with --compression
+
+    :param filename: the ".zst" or ".lz4" file
+    :return: the codec, the format, the runs per chunk and, for each chunk, its offset, compressed size ("size"),
+        decompressed size ("length") and number of runs
+    """
+    with open(filename, "rb") as f:
+        f.seek(-12, os.SEEK_END)
+        length, magic = struct.unpack("<I8s", f.read(12))
+        if magic != b"SORTCHK1":
+            raise ValueError(f"{filename} is not a compressed result file")
+        f.seek(-12 - length, os.SEEK_END)
+        return json.loads(f.read(length))
+
+
+def _decompress_chunks(filename: str, index: dict, chunks: List[dict]) -> bytes:
+    if index["codec"] == "zstd":
+        import zstandard
+        decompress = zstandard.ZstdDecompressor().decompress
+    elif index["codec"] == "lz4":
+        import lz4.frame
+        decompress = lz4.frame.decompress
+    else:
+        raise ValueError(f"unknown codec {index['codec']}")
+
+    result = []
+    with open(filename, "rb") as f:
+        for chunk in chunks:
+            f.seek(chunk["offset"])
+            result.append(decompress(f.read(chunk["size"])))
+    return b"".join(result)
+
+
+def read_compressed_results(filename: str, first_run: int = 0, last_run: Optional[int] = None) -> pd.DataFrame:
+    """
+    Load a main result file written by SortAlgorithmTester with --compression. Only the chunks containing the
+    requested runs are decompressed
+
+    :param filename: the ".zst" or ".lz4" file to load
+    :param first_run: the first run to load
+    :param last_run: the run after the last one to load. None to load up to the last run
+    :return: a dataframe with the same columns of the main csv. It may contain some run outside the requested range,
+        as long as they are in the same chunk of a requested one
+    """
+    index = read_compressed_index(filename)
+    chunks = index["chunks"]
+    # the first chunk is the preamble of the format, and is always needed
+    selected = [chunks[0]]
+    start = 0
+    for chunk in chunks[1:]:
+        end = start + chunk["runs"]
+        if (end > first_run and (last_run is None or start < last_run)) or chunk["runs"] == 0:
+            selected.append(chunk)
+        start = end
+
+    content = _decompress_chunks(filename, index, selected)
+    if index["format"] == "csv":
+        return pd.read_csv(io.BytesIO(content))
+    elif index["format"] == "jsonl":
+        return pd.json_normalize([json.loads(line) for line in content.splitlines() if line.strip()])
+    elif index["format"] == "arrow":
+        import pyarrow as pa
+        # without the leading "ARROW1" magic (and its padding) an arrow file is an arrow stream: the selected record
+        # batches, followed by an end of stream marker
+        stream = content[8:] + b"\xff\xff\xff\xff\x00\x00\x00\x00"
+        return pa.ipc.open_stream(pa.py_buffer(stream)).read_all().to_pandas()
+    raise ValueError(f"unknown format {index['format']}")
+
+
+def read_sqlite_results(filename: str, where: str = "1", parameters: tuple = ()) -> pd.DataFrame:
+    """
+    Load the runs a SortAlgorithmTester (or many of them) inserted with --resultDb
+
+    :param filename: the database
+    :param where: SQL condition selecting the configurations, e.g., "algorithm = ? AND sequenceSize = ?"
+    :param parameters: values of the placeholders of where
+    :return: a dataframe with a row per run: the columns of the main csv plus the ones of its configuration
+    """
+    with sqlite3.connect(filename) as connection:
+        return pd.read_sql_query(
+            "SELECT c.id AS configuration, c.algorithm, c.sequenceType, c.sequenceSize, c.lowerBound, c.upperBound, "
+            "c.seed, c.gitRevision, r.run, r.time, r.voluntaryContextSwitches, r.involuntaryContextSwitches, "
+            "r.cpuMigrations, r.runQueueDelay, r.preempted, r.validationTime, r.status "
+            f"FROM configurations c JOIN runs r ON r.configuration = c.id WHERE {where} "
+            "ORDER BY c.id, r.run",
+            connection,
+            params=parameters,
+        )
+
+
+def is_output_complete(output_template: str) -> bool:
+    """
+    Check the completion marker SortAlgorithmTester writes once every file of a test context has been written
+
+    :param output_template: the --outputTemplate of the context
+    :return: true if the marker exists and every file it lists has the size and the CRC-32 it records
+    """
+    try:
+        with open(output_template + "kind:type=complete|.json") as f:
+            marker = json.load(f)
+        for file in marker["files"]:
+            with open(output_template + file["suffix"], "rb") as f:
+                content = f.read()
+            if len(content) != file["size"] or zlib.crc32(content) != file["crc32"]:
+                return False
+    except (OSError, ValueError, KeyError):
+        return False
+    return True
+
+
+class ShmResults(object):
+    """
+    Results written by SortAlgorithmTester with --resultShm, read straight from the shared memory segment
+
+    Columns are numpy arrays backed by the segment itself: nothing is copied. They are valid until close()
+
+    Use it in a with statement:
+
+    with ShmResults("mySegment") as results:
+        results.to_dataframe()...
+    """
+
+    def __init__(self, name: str, unlink: bool = True):
+        """
+        :param name: the name given to --resultShm
+        :param unlink: if true, the segment is removed as soon as it's mapped (the mapping stays valid)
+        """
+        self.__shm = shared_memory.SharedMemory(name=name.lstrip("/"), create=False)
+        if unlink:
+            self.__shm.unlink()
+        buffer = self.__shm.buf
+        if bytes(buffer[0:8]) != b"SORTSHM1":
+            self.__shm.close()
+            raise ValueError(f"{name} is not a result segment")
+        self.__header = np.ndarray(shape=(3,), dtype="<u8", buffer=buffer, offset=8)
+        length = int(self.__header[2])
+        self.__layout = json.loads(bytes(buffer[32:32 + length]))
+        self.__columns: Dict[str, np.ndarray] = {}
+
+    @property
+    def rows(self) -> int:
+        """
+        :return: number of runs written so far
+        """
+        return int(self.__header[0])
+
+    @property
+    def complete(self) -> bool:
+        """
+        :return: true if the tester has closed the segment
+        """
+        return self.__header[1] == 1
+
+    def columns(self) -> Dict[str, np.ndarray]:
+        """
+        :return: a view over each column, as long as the runs written so far
+        """
+        rows = self.rows
+        result = {}
+        for column in self.__layout["columns"]:
+            result[column["name"]] = np.ndarray(shape=(rows,), dtype=column["dtype"], buffer=self.__shm.buf, offset=column["offset"])
+        return result
+
+    def to_dataframe(self) -> pd.DataFrame:
+        """
+        :return: a dataframe with a row per run. Status is converted into categories
+        """
+        columns = self.columns()
+        for column in self.__layout["columns"]:
+            if "categories" in column:
+                columns[column["name"]] = pd.Categorical.from_codes(columns[column["name"]], categories=column["categories"])
+        return pd.DataFrame(columns, copy=False)
+
+    def close(self):
+        # views over the segment need to be gone before it's unmapped
+        self.__header = None
+        self.__shm.close()
+
+    def __enter__(self) -> "ShmResults":
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.close()
+
+
+def read_results(filename: str) -> pd.DataFrame:
+    """
+    Load a main result file written by SortAlgorithmTester, whatever its --outputFormat
+
+    :param filename: the file to load. The format is deduced from its extension
+    :return: a dataframe with a row per run
+    """
+    if filename.endswith(".bin"):
+        return read_binary_results(filename)
+    elif filename.endswith(".arrow"):
+        return read_arrow_results(filename)
+    elif filename.endswith(".jsonl"):
+        return read_jsonl_results(filename)
+    elif filename.endswith(".zst") or filename.endswith(".lz4"):
+        return read_compressed_results(filename)
+    elif filename.endswith(".sqlite"):
+        return read_sqlite_results(filename)
+    return pd.read_csv(filename)
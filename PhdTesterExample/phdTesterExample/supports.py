@@ -26,6 +26,12 @@ class Time(phd.IDataRowExtrapolator):
         return row.time
 
 
+class Preempted(phd.IDataRowExtrapolator):
+    def fetch(self, factory: "SortResearchField", test_context: "phd.ITestContext", path: PathStr, name: phd.KS001Str, ks001: "phd.KS001", content: pd.DataFrame,
+              rowid: int, row: "phd.ICsvRow") -> float:
+        return row.preempted
+
+
 class SequenceSize(phd.IDataRowExtrapolator):
     def fetch(self, factory: "SortResearchField", test_context: "phd.ITestContext", path: PathStr, name: phd.KS001Str, ks001: "phd.KS001", content: pd.DataFrame,
               rowid: int, row: "phd.ICsvRow") -> float:
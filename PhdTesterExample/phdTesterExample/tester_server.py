@@ -0,0 +1,83 @@
+import json
+import subprocess
+from typing import Any, Callable, Dict, Optional
+
+
+class TesterServerError(Exception):
+    """
+    A test context the tester server couldn't execute
+    """
+
+    def __init__(self, context: Dict[str, Any], message: str):
+        self.context = context
+        self.message = message
+
+    def __str__(self):
+        return f"the tester couldn't execute {self.context}: {self.message}"
+
+
+class TesterServer(object):
+    """
+    A long lived "SortAlgorithmTester --serve" process, executing test contexts one after the other without paying a
+    process (and a cold cache) for each of them
+
+    Use it in a with statement:
+
+    with TesterServer(working_directory="cwd") as server:
+        server.execute({"algorithm": "MERGESORT", ...})
+    """
+
+    def __init__(self, program: str = "SortAlgorithmTester", working_directory: Optional[str] = None, sequence_cache: Optional[int] = None):
+        """
+        :param program: the tester executable
+        :param working_directory: where the tester writes the result files
+        :param sequence_cache: megabytes of sequences the tester keeps between test contexts. None for its default
+        """
+        command = [program, "--serve"]
+        if sequence_cache is not None:
+            command.append(f"--sequenceCache={sequence_cache}")
+        self.__process = subprocess.Popen(
+            command, cwd=working_directory, stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+            universal_newlines=True, bufsize=1,
+        )
+        self.__next_id = 0
+
+    def execute(self, context: Dict[str, Any], on_run: Optional[Callable[[Dict[str, Any]], None]] = None) -> int:
+        """
+        Execute a test context
+
+        :param context: the options of the tester (without the leading "--"), e.g. {"algorithm": "MERGESORT"}
+        :param on_run: if not None, called with each run (as a line of the jsonl main file) as soon as it's done
+        :return: the exit code the tester would have returned
+        :raises TesterServerError: if the context can't be executed
+        """
+        request_id = self.__next_id
+        self.__next_id += 1
+        request = dict(context)
+        request["id"] = request_id
+        request["streamRuns"] = on_run is not None
+        self.__process.stdin.write(json.dumps(request) + "\n")
+        self.__process.stdin.flush()
+
+        while True:
+            line = self.__process.stdout.readline()
+            if not line:
+                raise TesterServerError(context, f"the tester died with exit code {self.__process.wait()}")
+            response = json.loads(line)
+            if response["event"] == "run":
+                on_run(response)
+            elif response["event"] == "done":
+                return response["exitCode"]
+            elif response["event"] == "error":
+                raise TesterServerError(context, response["message"])
+
+    def close(self):
+        if self.__process.poll() is None:
+            self.__process.stdin.close()
+            self.__process.wait()
+
+    def __enter__(self) -> "TesterServer":
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        self.close()
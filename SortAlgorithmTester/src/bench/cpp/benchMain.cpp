@@ -0,0 +1,62 @@
+/*
+ * benchMain.cpp
+ *
+ * Catch main of the micro-benchmark executable. Besides the reporters shipped with Catch, it registers a "csv" reporter
+ * which writes one row per BENCHMARK, so that the results can be loaded without parsing the console output:
+ *
+ * SortAlgorithmTesterBench -r csv -o bench.csv
+ */
+
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_NO_POSIX_SIGNALS // https://github.com/catchorg/Catch2/issues/1295 avoid catch catching signals
+#include "catch.hpp"
+
+#include <sstream>
+
+/**
+ * A reporter generating a csv with a row per benchmark.
+ *
+ * Benchmarks are expected to be named "<algorithm>/<sequenceType>/<sequenceSize>": each part becomes a column
+ */
+struct CsvReporter : Catch::StreamingReporterBase<CsvReporter> {
+
+    CsvReporter(Catch::ReporterConfig const& config) : Catch::StreamingReporterBase<CsvReporter>{config} {
+    }
+
+    ~CsvReporter() override {}
+
+    static std::string getDescription() {
+        return "Reports benchmark results as a csv (algorithm,sequenceType,sequenceSize,iterations,elapsedNs,nsPerIteration)";
+    }
+
+    void testRunStarting(Catch::TestRunInfo const& testRunInfo) override {
+        StreamingReporterBase::testRunStarting(testRunInfo);
+        stream << "algorithm,sequenceType,sequenceSize,iterations,elapsedNs,nsPerIteration" << std::endl;
+    }
+
+    void assertionStarting(Catch::AssertionInfo const&) override {
+    }
+
+    bool assertionEnded(Catch::AssertionStats const&) override {
+        return true;
+    }
+
+    void benchmarkEnded(Catch::BenchmarkStats const& stats) override {
+        std::stringstream ss{stats.info.name};
+        std::string part;
+        int columns = 0;
+        while (std::getline(ss, part, '/')) {
+            stream << part << ",";
+            ++columns;
+        }
+        for (; columns<3; ++columns) {
+            stream << ",";
+        }
+        stream << stats.iterations << ","
+            << stats.elapsedTimeInNanoseconds << ","
+            << (stats.elapsedTimeInNanoseconds / stats.iterations)
+            << std::endl;
+    }
+};
+
+CATCH_REGISTER_REPORTER("csv", CsvReporter)
@@ -0,0 +1,34 @@
+#include "catch.hpp"
+
+#include "SortAlgorithms.hpp"
+#include "SequenceGenerators.hpp"
+#include "SequenceValidator.hpp"
+
+#include <cstdlib>
+#include <memory>
+
+TEST_CASE("every engine over every sequence type", "[benchmark]") {
+    const std::vector<int> sizes{100, 1000, 10000};
+    const EngineParameters parameters = deriveEngineParameters(probeMachineTopology());
+
+    for (auto& algorithm : getSortAlgorithmNames()) {
+        for (auto& sequenceType : getSequenceTypeNames()) {
+            for (int size : sizes) {
+                srand(0);
+                // COUNTSORT allocates a counter per value, so keep the range as large as the sequence
+                const std::vector<int> input = generateSequence(sequenceType, size, 0, size);
+                std::unique_ptr<ISortAlgorithm> alg{createSortAlgorithm(algorithm, size, parameters)};
+                std::vector<int> sequence;
+                // the scratch arena is reserved once, out of the measure, as the tester does before each run
+                alg->reset(input.size());
+
+                // each iteration restores the unsorted input, hence the copy is part of the measure
+                BENCHMARK(algorithm + "/" + sequenceType + "/" + std::to_string(size)) {
+                    sequence = input;
+                    alg->sort(sequence);
+                }
+                REQUIRE(isSorted(sequence));
+            }
+        }
+    }
+}
@@ -0,0 +1,342 @@
+#include "ResultWriter.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+// see https://arrow.apache.org/docs/format/Columnar.html#ipc-file-format and the flatbuffers schemas (Schema.fbs,
+// Message.fbs, File.fbs) of the arrow repository for the meaning of the field ids below
+
+static const short METADATA_VERSION_V5 = 4;
+static const unsigned char MESSAGE_HEADER_SCHEMA = 1;
+static const unsigned char MESSAGE_HEADER_RECORD_BATCH = 3;
+static const unsigned char TYPE_INT = 2;
+static const unsigned char TYPE_UTF8 = 5;
+
+/**
+ * Minimal flatbuffers builder. Like the official one, the buffer is built from its end: an object is referred to by
+ * its distance from the end of the buffer, so children need to be built before their parents
+ */
+class FlatBufferBuilder {
+public:
+    FlatBufferBuilder() : bytes{}, minAlign{1}, fields{}, tableStart{0} {}
+
+    std::size_t size() const {
+        return this->bytes.size();
+    }
+
+    /**
+     * pad the buffer so that, after other bytes are prepended, the buffer is aligned to align
+     */
+    void prep(std::size_t align, std::size_t other) {
+        if (align > this->minAlign) {
+            this->minAlign = align;
+        }
+        std::size_t padding = (align - ((this->size() + other) % align)) % align;
+        this->bytes.insert(this->bytes.begin(), padding, 0);
+    }
+
+    template <typename T>
+    void prependScalar(T value) {
+        this->prep(sizeof(T), 0);
+        this->prependRaw(&value, sizeof(T));
+    }
+
+    /**
+     * @return reference to the string
+     */
+    std::size_t createString(const std::string& s) {
+        this->prep(4, s.size() + 1);
+        this->bytes.insert(this->bytes.begin(), 0);
+        this->prependRaw(s.data(), s.size());
+        this->prependRaw32(static_cast<uint32_t>(s.size()));
+        return this->size();
+    }
+
+    /**
+     * @return reference to a vector of references to other objects
+     */
+    std::size_t createOffsetVector(const std::vector<std::size_t>& references) {
+        this->prep(4, 4 * references.size());
+        for (std::size_t i=references.size(); i>0; --i) {
+            this->prependOffset(references[i - 1]);
+        }
+        this->prependRaw32(static_cast<uint32_t>(references.size()));
+        return this->size();
+    }
+
+    /**
+     * @param structs the structs, already laid out (in order) as they need to be in the buffer
+     * @return reference to a vector of count structs, aligned to 8 bytes
+     */
+    std::size_t createStructVector(const std::string& structs, std::size_t count) {
+        this->prep(8, structs.size());
+        this->prependRaw(structs.data(), structs.size());
+        this->prep(4, 4);
+        this->prependRaw32(static_cast<uint32_t>(count));
+        return this->size();
+    }
+
+    void startTable() {
+        this->fields.clear();
+        this->tableStart = this->size();
+    }
+
+    template <typename T>
+    void addScalar(int id, T value) {
+        this->prependScalar(value);
+        this->fields.push_back(std::make_pair(id, this->size()));
+    }
+
+    void addOffset(int id, std::size_t reference) {
+        this->prependOffset(reference);
+        this->fields.push_back(std::make_pair(id, this->size()));
+    }
+
+    /**
+     * @return reference to the table
+     */
+    std::size_t endTable() {
+        this->prependScalar<int32_t>(0);
+        std::size_t table = this->size();
+
+        int fieldCount = 0;
+        for (auto& field : this->fields) {
+            fieldCount = std::max(fieldCount, field.first + 1);
+        }
+        std::vector<uint16_t> vtable(2 + fieldCount, 0);
+        vtable[0] = static_cast<uint16_t>(2 * vtable.size());
+        vtable[1] = static_cast<uint16_t>(table - this->tableStart);
+        for (auto& field : this->fields) {
+            vtable[2 + field.first] = static_cast<uint16_t>(table - field.second);
+        }
+        this->prependRaw(vtable.data(), 2 * vtable.size());
+
+        // the table starts with the (signed) distance to its vtable, which precedes it
+        int32_t vtableDistance = static_cast<int32_t>(this->size() - table);
+        memcpy(&this->bytes[this->size() - table], &vtableDistance, sizeof(vtableDistance));
+        return table;
+    }
+
+    /**
+     * @return the whole buffer, with root as its root table
+     */
+    std::string finish(std::size_t root) {
+        this->prep(this->minAlign, 4);
+        this->prependOffset(root);
+        return std::string{this->bytes.begin(), this->bytes.end()};
+    }
+private:
+    void prependRaw(const void* data, std::size_t size) {
+        const char* p = static_cast<const char*>(data);
+        this->bytes.insert(this->bytes.begin(), p, p + size);
+    }
+
+    void prependRaw32(uint32_t value) {
+        this->prependRaw(&value, sizeof(value));
+    }
+
+    void prependOffset(std::size_t reference) {
+        this->prep(4, 0);
+        // offsets are relative to the position they are stored in
+        this->prependRaw32(static_cast<uint32_t>(this->size() + 4 - reference));
+    }
+private:
+    std::vector<char> bytes;
+    std::size_t minAlign;
+    std::vector<std::pair<int, std::size_t>> fields;
+    std::size_t tableStart;
+};
+
+static void appendInt64(std::string& s, int64_t value) {
+    s.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @return reference to a Schema table describing the columns of RunRecord
+ */
+static std::size_t buildSchema(FlatBufferBuilder& builder) {
+    const std::vector<std::string>& names = getRunRecordColumnNames();
+    std::vector<std::size_t> fields{};
+    for (std::size_t column=0; column<names.size(); ++column) {
+        bool integer = static_cast<int>(column) < RUN_RECORD_INTEGER_COLUMNS;
+        std::size_t name = builder.createString(names[column]);
+        std::size_t children = builder.createOffsetVector({});
+        builder.startTable();
+        if (integer) {
+            builder.addScalar<int32_t>(0, 64);
+            builder.addScalar<uint8_t>(1, 1);
+        }
+        std::size_t type = builder.endTable();
+
+        builder.startTable();
+        builder.addOffset(0, name);
+        builder.addScalar<uint8_t>(1, 0);
+        builder.addScalar<uint8_t>(2, integer ? TYPE_INT : TYPE_UTF8);
+        builder.addOffset(3, type);
+        builder.addOffset(5, children);
+        fields.push_back(builder.endTable());
+    }
+    std::size_t fieldVector = builder.createOffsetVector(fields);
+    builder.startTable();
+    // little endian
+    builder.addScalar<int16_t>(0, 0);
+    builder.addOffset(1, fieldVector);
+    return builder.endTable();
+}
+
+static std::string buildMessage(FlatBufferBuilder& builder, unsigned char headerType, std::size_t header, uint64_t bodyLength) {
+    builder.startTable();
+    builder.addScalar<int64_t>(3, bodyLength);
+    builder.addOffset(2, header);
+    builder.addScalar<int16_t>(0, METADATA_VERSION_V5);
+    builder.addScalar<uint8_t>(1, headerType);
+    return builder.finish(builder.endTable());
+}
+
+ArrowResultWriter::ArrowResultWriter(const std::string& fileName) : ArrowResultWriter{fopen(fileName.c_str(), "wb")} {
+}
+
+ArrowResultWriter::ArrowResultWriter(FILE* file) :
+        BlockResultWriter{4096}, file{file}, position{0},
+        batchOffsets{}, batchMetadataLengths{}, batchBodyLengths{} {
+    if (this->file == NULL) {
+        throw std::domain_error{"can't open file"};
+    }
+    this->writePadded("ARROW1", 6);
+
+    FlatBufferBuilder builder{};
+    std::size_t schema = buildSchema(builder);
+    this->writeMessage(buildMessage(builder, MESSAGE_HEADER_SCHEMA, schema, 0));
+}
+
+ArrowResultWriter::~ArrowResultWriter() {
+    this->close();
+}
+
+void ArrowResultWriter::writePadded(const void* data, std::size_t size) {
+    static const char zeros[8] = {0};
+    if (size > 0 && fwrite(data, 1, size, this->file) != size) {
+        throw std::domain_error{"can't write the results"};
+    }
+    std::size_t padding = (8 - size % 8) % 8;
+    if (padding > 0 && fwrite(zeros, 1, padding, this->file) != padding) {
+        throw std::domain_error{"can't write the results"};
+    }
+    this->position += size + padding;
+}
+
+std::size_t ArrowResultWriter::writeMessage(const std::string& flatbuffer) {
+    // the metadata length includes the padding, so that the body starts aligned to 8 bytes
+    uint32_t prefix[2] = {0xFFFFFFFFU, static_cast<uint32_t>((flatbuffer.size() + 7) & ~static_cast<std::size_t>(7))};
+    if (fwrite(prefix, 1, sizeof(prefix), this->file) != sizeof(prefix)) {
+        throw std::domain_error{"can't write the results"};
+    }
+    this->position += sizeof(prefix);
+    this->writePadded(flatbuffer.data(), flatbuffer.size());
+    return sizeof(prefix) + prefix[1];
+}
+
+void ArrowResultWriter::flushBlock(const std::vector<RunRecord>& block) {
+    // the body holds, for each column, an (empty) validity bitmap and the values. utf8 values need offsets too
+    std::vector<std::string> buffers{};
+    for (int column=0; column<RUN_RECORD_INTEGER_COLUMNS; ++column) {
+        std::string values{};
+        values.reserve(block.size() * sizeof(int64_t));
+        for (auto& record : block) {
+            appendInt64(values, getRunRecordIntegerColumn(record, column));
+        }
+        buffers.push_back(std::string{});
+        buffers.push_back(std::move(values));
+    }
+    std::string offsets{};
+    std::string characters{};
+    int32_t offset = 0;
+    offsets.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    for (auto& record : block) {
+        characters.append(getRunStatusName(record.status));
+        offset = static_cast<int32_t>(characters.size());
+        offsets.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+    buffers.push_back(std::string{});
+    buffers.push_back(std::move(offsets));
+    buffers.push_back(std::move(characters));
+
+    std::string bufferStructs{};
+    uint64_t bodyLength = 0;
+    for (auto& buffer : buffers) {
+        appendInt64(bufferStructs, bodyLength);
+        appendInt64(bufferStructs, buffer.size());
+        bodyLength += (buffer.size() + 7) & ~static_cast<uint64_t>(7);
+    }
+    std::string nodeStructs{};
+    for (std::size_t column=0; column<getRunRecordColumnNames().size(); ++column) {
+        // length and null count
+        appendInt64(nodeStructs, block.size());
+        appendInt64(nodeStructs, 0);
+    }
+
+    FlatBufferBuilder builder{};
+    std::size_t nodes = builder.createStructVector(nodeStructs, getRunRecordColumnNames().size());
+    std::size_t bufferVector = builder.createStructVector(bufferStructs, buffers.size());
+    builder.startTable();
+    builder.addScalar<int64_t>(0, block.size());
+    builder.addOffset(1, nodes);
+    builder.addOffset(2, bufferVector);
+    std::size_t recordBatch = builder.endTable();
+
+    this->batchOffsets.push_back(this->position);
+    this->batchMetadataLengths.push_back(this->writeMessage(buildMessage(builder, MESSAGE_HEADER_RECORD_BATCH, recordBatch, bodyLength)));
+    this->batchBodyLengths.push_back(bodyLength);
+    for (auto& buffer : buffers) {
+        this->writePadded(buffer.data(), buffer.size());
+    }
+}
+
+void ArrowResultWriter::close() {
+    if (this->file == NULL) {
+        return;
+    }
+    try {
+        this->writeFooter();
+    } catch (...) {
+        // the destructor must not try again
+        fclose(this->file);
+        this->file = NULL;
+        throw;
+    }
+    fclose(this->file);
+    this->file = NULL;
+}
+
+void ArrowResultWriter::writeFooter() {
+    this->flush();
+    // end of stream marker
+    uint32_t endOfStream[2] = {0xFFFFFFFFU, 0};
+    this->writePadded(endOfStream, sizeof(endOfStream));
+
+    FlatBufferBuilder builder{};
+    std::size_t schema = buildSchema(builder);
+    // Block structs: offset (int64), metadata length (int32, padded to 8 bytes) and body length (int64)
+    std::string blocks{};
+    for (std::size_t i=0; i<this->batchOffsets.size(); ++i) {
+        appendInt64(blocks, this->batchOffsets[i]);
+        appendInt64(blocks, static_cast<int64_t>(static_cast<uint32_t>(this->batchMetadataLengths[i])));
+        appendInt64(blocks, this->batchBodyLengths[i]);
+    }
+    std::size_t recordBatches = builder.createStructVector(blocks, this->batchOffsets.size());
+    std::size_t dictionaries = builder.createStructVector(std::string{}, 0);
+    builder.startTable();
+    builder.addOffset(1, schema);
+    builder.addOffset(2, dictionaries);
+    builder.addOffset(3, recordBatches);
+    builder.addScalar<int16_t>(0, METADATA_VERSION_V5);
+    std::string footer = builder.finish(builder.endTable());
+
+    if (fwrite(footer.data(), 1, footer.size(), this->file) != footer.size()) {
+        throw std::domain_error{"can't write the results"};
+    }
+    int32_t footerLength = static_cast<int32_t>(footer.size());
+    fwrite(&footerLength, 1, sizeof(footerLength), this->file);
+    fwrite("ARROW1", 1, 6, this->file);
+}
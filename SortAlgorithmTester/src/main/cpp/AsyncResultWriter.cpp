@@ -0,0 +1,196 @@
+#include "AsyncResultWriter.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <time.h>
+
+/**
+ * signals after which the buffered records are written before the process dies
+ */
+static const int TERMINATION_SIGNALS[] = {SIGINT, SIGTERM, SIGHUP, SIGSEGV, SIGBUS, SIGFPE, SIGABRT};
+static_assert(sizeof(TERMINATION_SIGNALS) / sizeof(TERMINATION_SIGNALS[0]) == AsyncResultWriter::TERMINATION_SIGNAL_COUNT, "a previous action per termination signal");
+
+/**
+ * how long the writer thread sleeps when there's nothing to write
+ */
+static const std::chrono::milliseconds DRAIN_INTERVAL{10};
+
+/**
+ * how long a signal handler waits for the writer thread
+ */
+static const long TERMINATION_TIMEOUT_MILLISECONDS = 5000;
+
+/**
+ * the writer flushed by the signal handlers, if any
+ */
+static std::atomic<AsyncResultWriter*> activeWriter{nullptr};
+
+static void onTerminationSignal(int signal) {
+    AsyncResultWriter* writer = activeWriter.exchange(nullptr);
+    if (writer != nullptr) {
+        writer->onTermination();
+    }
+    // let the signal do what it would have done without us
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_DFL;
+    sigemptyset(&action.sa_mask);
+    sigaction(signal, &action, nullptr);
+    raise(signal);
+}
+
+AsyncResultWriter::AsyncResultWriter(ResultWriter* sink, std::size_t capacity, int cpu) :
+        sink{sink}, buffer{capacity}, cpu{cpu}, stopping{false}, finished{false}, error{}, closed{false}, writer{} {
+    AsyncResultWriter* expected = nullptr;
+    if (!activeWriter.compare_exchange_strong(expected, this)) {
+        throw std::domain_error{"only one asynchronous result writer can exist at a time"};
+    }
+
+    // the writer thread must never run the handlers: they wait for it
+    sigset_t blocked;
+    sigset_t previousMask;
+    sigemptyset(&blocked);
+    for (int i=0; i<TERMINATION_SIGNAL_COUNT; ++i) {
+        sigaddset(&blocked, TERMINATION_SIGNALS[i]);
+    }
+    pthread_sigmask(SIG_BLOCK, &blocked, &previousMask);
+    this->writer = std::thread{&AsyncResultWriter::drainLoop, this};
+    pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onTerminationSignal;
+    sigemptyset(&action.sa_mask);
+    for (int i=0; i<TERMINATION_SIGNAL_COUNT; ++i) {
+        sigaction(TERMINATION_SIGNALS[i], &action, &this->previousActions[i]);
+    }
+}
+
+AsyncResultWriter::~AsyncResultWriter() {
+    try {
+        this->close();
+    } catch (...) {
+        // nobody to report it to
+    }
+}
+
+void AsyncResultWriter::write(const RunRecord& record) {
+    while (!this->buffer.tryPush(record)) {
+        if (this->finished.load()) {
+            // the wrapped writer failed and the writer thread is gone: nobody will ever make room
+            if (this->error) {
+                std::rethrow_exception(this->error);
+            }
+            throw std::domain_error{"the writer thread of the results has stopped"};
+        }
+        // the writer thread is late: we can only wait for it
+        std::this_thread::yield();
+    }
+}
+
+void AsyncResultWriter::close() {
+    if (this->closed) {
+        return;
+    }
+    this->closed = true;
+    this->restoreSignalHandlers();
+    this->stopping.store(true);
+    this->writer.join();
+    if (this->error) {
+        std::rethrow_exception(this->error);
+    }
+}
+
+void AsyncResultWriter::restoreSignalHandlers() {
+    AsyncResultWriter* expected = this;
+    if (activeWriter.compare_exchange_strong(expected, nullptr)) {
+        for (int i=0; i<TERMINATION_SIGNAL_COUNT; ++i) {
+            sigaction(TERMINATION_SIGNALS[i], &this->previousActions[i], nullptr);
+        }
+    }
+}
+
+void AsyncResultWriter::onTermination() {
+    this->stopping.store(true);
+    struct timespec pause{0, 1000000};
+    for (long waited=0; !this->finished.load() && waited<TERMINATION_TIMEOUT_MILLISECONDS; ++waited) {
+        nanosleep(&pause, nullptr);
+    }
+}
+
+void AsyncResultWriter::drain() {
+    RunRecord record;
+    while (this->buffer.tryPop(record)) {
+        this->sink->write(record);
+    }
+}
+
+void AsyncResultWriter::drainLoop() {
+    if (this->cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(this->cpu, &cpus);
+        // not being able to pin the thread is not a reason to lose results
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+    try {
+        while (!this->stopping.load()) {
+            this->drain();
+            std::this_thread::sleep_for(DRAIN_INTERVAL);
+        }
+        // the producer doesn't push anymore once stopping is set
+        this->drain();
+        this->sink->close();
+    } catch (...) {
+        this->error = std::current_exception();
+    }
+    this->finished.store(true);
+}
+
+std::vector<int> getAllowedCpus() {
+    std::vector<int> result{};
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) != 0) {
+        return result;
+    }
+    for (int cpu=0; cpu<CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &cpus)) {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+int chooseWriterCpu(const MachineTopology& topology, const std::vector<int>& allowedCpus, int benchmarkCpu) {
+    const CpuLocation* benchmark = nullptr;
+    for (auto& location : topology.cpus) {
+        if (location.cpu == benchmarkCpu) {
+            benchmark = &location;
+        }
+    }
+    int sameCore = -1;
+    // the last CPUs are usually the least used ones
+    for (auto it = allowedCpus.rbegin(); it != allowedCpus.rend(); ++it) {
+        if (*it == benchmarkCpu) {
+            continue;
+        }
+        bool sibling = false;
+        for (auto& location : topology.cpus) {
+            if (benchmark != nullptr && location.cpu == *it && location.core == benchmark->core && location.package == benchmark->package) {
+                sibling = true;
+            }
+        }
+        if (!sibling) {
+            return *it;
+        }
+        if (sameCore < 0) {
+            sameCore = *it;
+        }
+    }
+    return sameCore;
+}
@@ -0,0 +1,219 @@
+#include "Checkpoint.hpp"
+
+#include "Json.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * bytes read at a time when checksumming a file
+ */
+static const std::size_t CHECKSUM_BUFFER_SIZE = 1 << 16;
+
+/**
+ * table of the reflected polynomial 0xEDB88320, one entry per byte
+ */
+struct Crc32Table {
+    uint32_t entries[256];
+
+    Crc32Table() {
+        for (uint32_t i=0; i<256; ++i) {
+            uint32_t crc = i;
+            for (int bit=0; bit<8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320U : crc >> 1;
+            }
+            this->entries[i] = crc;
+        }
+    }
+};
+
+static const uint32_t* getCrc32Table() {
+    // built by the initializer of the static, which C++11 runs once even if contexts of the library checkpoint from
+    // several threads
+    static const Crc32Table table{};
+    return table.entries;
+}
+
+uint32_t crc32(const void* data, std::size_t size, uint32_t crc) {
+    const uint32_t* table = getCrc32Table();
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (std::size_t i=0; i<size; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t fileCrc32(const std::string& fileName, uint64_t& size) {
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (file == NULL) {
+        throw std::domain_error{"can't open file " + fileName};
+    }
+    std::vector<char> buffer(CHECKSUM_BUFFER_SIZE);
+    uint32_t result = 0;
+    size = 0;
+    std::size_t read;
+    while ((read = fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+        result = crc32(buffer.data(), read, result);
+        size += read;
+    }
+    bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed) {
+        throw std::domain_error{"can't read file " + fileName};
+    }
+    return result;
+}
+
+std::string getCompletionMarkerName(const std::string& outputTemplate) {
+    return outputTemplate + "kind:type=complete|.json";
+}
+
+/**
+ * write the whole content in fileName and flush it on disk
+ */
+static void writeSynced(const std::string& fileName, const std::string& content) {
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (file == NULL) {
+        throw std::domain_error{"can't open file " + fileName};
+    }
+    bool failed = fwrite(content.data(), 1, content.size(), file) != content.size();
+    failed = fflush(file) != 0 || failed;
+    failed = fsync(fileno(file)) != 0 || failed;
+    failed = fclose(file) != 0 || failed;
+    if (failed) {
+        throw std::domain_error{"can't write file " + fileName};
+    }
+}
+
+void writeCompletionMarker(const std::string& outputTemplate, const std::vector<std::string>& suffixes, long rows, int exitCode) {
+    JsonValue files = JsonValue::array();
+    for (auto& suffix : suffixes) {
+        uint64_t size;
+        uint32_t crc = fileCrc32(outputTemplate + suffix, size);
+        files.push(JsonValue::object()
+            .set("suffix", suffix)
+            .set("size", static_cast<unsigned long>(size))
+            .set("crc32", static_cast<unsigned long>(crc))
+        );
+    }
+    JsonValue marker = JsonValue::object()
+        .set("rows", rows)
+        .set("exitCode", exitCode)
+        .set("files", files);
+
+    std::string markerName = getCompletionMarkerName(outputTemplate);
+    // a name of this thread only: executions writing the same outputTemplate don't rename or remove each other's file
+    std::string temporaryName = markerName + "." + std::to_string(getpid()) + "." + std::to_string(syscall(SYS_gettid)) + ".tmp";
+    writeSynced(temporaryName, marker.dump() + "\n");
+    if (rename(temporaryName.c_str(), markerName.c_str()) != 0) {
+        unlink(temporaryName.c_str());
+        throw std::domain_error{"can't write file " + markerName};
+    }
+}
+
+void removeCompletionMarker(const std::string& outputTemplate) {
+    unlink(getCompletionMarkerName(outputTemplate).c_str());
+}
+
+/**
+ * @return the whole content of the file, or false if it can't be read
+ */
+static bool readWhole(const std::string& fileName, std::string& content) {
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (file == NULL) {
+        return false;
+    }
+    char buffer[4096];
+    std::size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        content.append(buffer, read);
+    }
+    bool failed = ferror(file) != 0;
+    fclose(file);
+    return !failed;
+}
+
+bool isOutputComplete(const std::string& outputTemplate, int& exitCode) {
+    std::string content{};
+    if (!readWhole(getCompletionMarkerName(outputTemplate), content)) {
+        return false;
+    }
+    try {
+        JsonValue marker = JsonValue::parse(content);
+        for (auto& file : marker.get("files").asArray()) {
+            uint64_t size;
+            uint32_t crc = fileCrc32(outputTemplate + file.get("suffix").asString(), size);
+            if (size != static_cast<uint64_t>(file.get("size").asNumber()) || crc != static_cast<uint32_t>(file.get("crc32").asNumber())) {
+                return false;
+            }
+        }
+        exitCode = static_cast<int>(marker.get("exitCode").asInt());
+    } catch (const std::domain_error& e) {
+        // a missing file or a damaged marker: the context needs to run again
+        return false;
+    }
+    return true;
+}
+
+CampaignJournal::CampaignJournal(const std::string& fileName) : file{nullptr}, finished{} {
+    std::string content{};
+    readWhole(fileName, content);
+    std::size_t start = 0;
+    while (start < content.size()) {
+        std::size_t end = content.find('\n', start);
+        if (end == std::string::npos) {
+            // torn by a crash: the context is not journaled
+            break;
+        }
+        try {
+            JsonValue entry = JsonValue::parse(content.substr(start, end - start));
+            this->finished[entry.get("outputTemplate").asString()] = static_cast<int>(entry.get("exitCode").asInt());
+        } catch (const std::domain_error& e) {
+            // a line we can't understand is a context we run again
+        }
+        start = end + 1;
+    }
+    this->file = fopen(fileName.c_str(), "a");
+    if (this->file == NULL) {
+        throw std::domain_error{"can't open journal " + fileName};
+    }
+    if (!content.empty() && content.back() != '\n') {
+        // the torn line needs to end, or it would spoil the next one
+        fputc('\n', this->file);
+    }
+}
+
+CampaignJournal::~CampaignJournal() {
+    if (this->file != nullptr) {
+        fclose(this->file);
+    }
+}
+
+bool CampaignJournal::isFinished(const std::string& outputTemplate, int& exitCode) const {
+    auto entry = this->finished.find(outputTemplate);
+    if (entry == this->finished.end()) {
+        return false;
+    }
+    int markerExitCode;
+    if (!isOutputComplete(outputTemplate, markerExitCode)) {
+        return false;
+    }
+    exitCode = entry->second;
+    return true;
+}
+
+void CampaignJournal::record(const std::string& outputTemplate, int exitCode) {
+    std::string line = JsonValue::object().set("outputTemplate", outputTemplate).set("exitCode", exitCode).dump();
+    fprintf(this->file, "%s\n", line.c_str());
+    if (fflush(this->file) != 0 || fsync(fileno(this->file)) != 0) {
+        throw std::domain_error{"can't write in the journal"};
+    }
+    this->finished[outputTemplate] = exitCode;
+}
+
+std::size_t CampaignJournal::getFinishedCount() const {
+    return this->finished.size();
+}
@@ -0,0 +1,194 @@
+#include "CompressedFile.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef WITH_LZ4
+#include <lz4frame.h>
+#endif
+
+/**
+ * magic of the skippable frame holding the index. Both zstd and lz4 skip frames with a magic in 0x184D2A50-0x184D2A5F
+ */
+static const uint32_t SKIPPABLE_FRAME_MAGIC = 0x184D2A5E;
+
+/**
+ * compression level of zstd: its default one, which compresses csv files about as well as gzip -9 at a fraction of the time
+ */
+static const int ZSTD_LEVEL = 3;
+
+static void appendUint32(std::string& out, uint32_t value) {
+    // little endian, whatever the machine
+    for (int i=0; i<4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+const std::vector<std::string>& getCompressionNames() {
+    static const std::vector<std::string> names{"none", "zstd", "lz4"};
+    return names;
+}
+
+bool isCompressionAvailable(const std::string& codec) {
+#ifdef WITH_ZSTD
+    if (codec == std::string{"zstd"}) {
+        return true;
+    }
+#endif
+#ifdef WITH_LZ4
+    if (codec == std::string{"lz4"}) {
+        return true;
+    }
+#endif
+    return codec == std::string{"none"};
+}
+
+std::string getCompressionExtension(const std::string& codec) {
+    if (codec == std::string{"zstd"}) {
+        return ".zst";
+    } else if (codec == std::string{"lz4"}) {
+        return ".lz4";
+    }
+    throw std::domain_error{"invalid compression " + codec};
+}
+
+CompressedFile::CompressedFile(const std::string& fileName, const std::string& codec, const JsonValue& description) :
+        file{nullptr}, stream{nullptr}, codec{codec}, description{description}, pending{}, position{0}, chunks{JsonValue::array()} {
+    if (codec == std::string{"none"} || !isCompressionAvailable(codec)) {
+        throw std::domain_error{"the tester has been built without the compression " + codec};
+    }
+    if (!description.isObject()) {
+        throw std::domain_error{"the description of a compressed file needs to be a json object"};
+    }
+    this->file = fopen(fileName.c_str(), "wb");
+    if (this->file == nullptr) {
+        throw std::domain_error{"can't open file " + fileName};
+    }
+    cookie_io_functions_t functions;
+    memset(&functions, 0, sizeof(functions));
+    functions.write = &CompressedFile::onStreamWrite;
+    functions.close = &CompressedFile::onStreamClose;
+    this->stream = fopencookie(this, "w", functions);
+    if (this->stream == nullptr) {
+        fclose(this->file);
+        throw std::domain_error{"can't create the compressed stream"};
+    }
+}
+
+CompressedFile::~CompressedFile() {
+    try {
+        this->close();
+    } catch (...) {
+        // nobody to report it to
+    }
+}
+
+ssize_t CompressedFile::onStreamWrite(void* cookie, const char* data, std::size_t size) {
+    static_cast<CompressedFile*>(cookie)->pending.append(data, size);
+    return size;
+}
+
+int CompressedFile::onStreamClose(void* cookie) {
+    static_cast<CompressedFile*>(cookie)->stream = nullptr;
+    return 0;
+}
+
+FILE* CompressedFile::getStream() const {
+    return this->stream;
+}
+
+std::string CompressedFile::compress(const std::string& data) const {
+    std::string result{};
+#ifdef WITH_ZSTD
+    if (this->codec == std::string{"zstd"}) {
+        result.resize(ZSTD_compressBound(data.size()));
+        std::size_t size = ZSTD_compress(&result[0], result.size(), data.data(), data.size(), ZSTD_LEVEL);
+        if (ZSTD_isError(size)) {
+            throw std::domain_error{std::string{"zstd: "} + ZSTD_getErrorName(size)};
+        }
+        result.resize(size);
+        return result;
+    }
+#endif
+#ifdef WITH_LZ4
+    if (this->codec == std::string{"lz4"}) {
+        LZ4F_preferences_t preferences;
+        memset(&preferences, 0, sizeof(preferences));
+        // lets the reader allocate the chunk upfront
+        preferences.frameInfo.contentSize = data.size();
+        result.resize(LZ4F_compressFrameBound(data.size(), &preferences));
+        std::size_t size = LZ4F_compressFrame(&result[0], result.size(), data.data(), data.size(), &preferences);
+        if (LZ4F_isError(size)) {
+            throw std::domain_error{std::string{"lz4: "} + LZ4F_getErrorName(size)};
+        }
+        result.resize(size);
+        return result;
+    }
+#endif
+    throw std::domain_error{"invalid compression " + this->codec};
+}
+
+void CompressedFile::writeAll(const std::string& data) {
+    if (!data.empty() && fwrite(data.data(), 1, data.size(), this->file) != data.size()) {
+        throw std::domain_error{"can't write the compressed file"};
+    }
+    this->position += data.size();
+}
+
+void CompressedFile::endChunk(std::size_t runs) {
+    if (this->file == nullptr) {
+        throw std::domain_error{"compressed file already closed"};
+    }
+    if (this->stream != nullptr) {
+        fflush(this->stream);
+    }
+    std::string compressed = this->compress(this->pending);
+    this->chunks.push(JsonValue::object()
+        .set("offset", static_cast<unsigned long>(this->position))
+        .set("size", static_cast<unsigned long>(compressed.size()))
+        .set("length", static_cast<unsigned long>(this->pending.size()))
+        .set("runs", static_cast<unsigned long>(runs))
+    );
+    this->writeAll(compressed);
+    this->pending.clear();
+}
+
+void CompressedFile::close() {
+    if (this->file == nullptr) {
+        return;
+    }
+    try {
+        if (this->stream != nullptr) {
+            // onStreamClose resets it
+            fclose(this->stream);
+        }
+        if (!this->pending.empty()) {
+            this->endChunk(0);
+        }
+
+        JsonValue index = this->description;
+        index.set("codec", this->codec);
+        index.set("chunks", this->chunks);
+        std::string document = index.dump();
+        std::string frame{};
+        appendUint32(frame, SKIPPABLE_FRAME_MAGIC);
+        appendUint32(frame, static_cast<uint32_t>(document.size() + 4 + 8));
+        frame.append(document);
+        appendUint32(frame, static_cast<uint32_t>(document.size()));
+        frame.append("SORTCHK1");
+        this->writeAll(frame);
+    } catch (...) {
+        // the destructor must not try again
+        fclose(this->file);
+        this->file = nullptr;
+        throw;
+    }
+    if (fclose(this->file) != 0) {
+        this->file = nullptr;
+        throw std::domain_error{"can't write the compressed file"};
+    }
+    this->file = nullptr;
+}
@@ -0,0 +1,22 @@
+#include "EngineParameters.hpp"
+
+#include <algorithm>
+
+EngineParameters deriveEngineParameters(const MachineTopology& topology) {
+    EngineParameters result;
+    // best shrink factor according to the original comb sort paper (Lacey, Box, 1991)
+    result.shrinkFactor = 1 / 1.3;
+
+    // insertion sort beats merging while the subsequence spans a couple of cache lines
+    result.smallSortThreshold = std::max(8, 2 * topology.cacheLineSize / static_cast<int>(sizeof(int)));
+
+    // the counters of a pass (one int per digit value) should take at most half of the L1 data cache
+    long counters = topology.l1DataCacheSize / 2 / static_cast<long>(sizeof(int));
+    int bits = 0;
+    while ((2L << bits) <= counters) {
+        ++bits;
+    }
+    result.radixDigitBits = std::min(16, std::max(4, bits));
+    result.pages = PageKind::DEFAULT;
+    return result;
+}
@@ -0,0 +1,172 @@
+#include "EngineTuner.hpp"
+
+#include "Json.hpp"
+#include "SortAlgorithms.hpp"
+#include "SequenceValidator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+EngineTuner::EngineTuner(const std::string& algorithm, int upperBound, const std::vector<int>& input, int runs) :
+        algorithm{algorithm}, upperBound{upperBound}, input(input), runs{std::max(1, runs)} {
+}
+
+std::vector<std::string> EngineTuner::getTunables(const std::string& algorithm) {
+    if (algorithm == std::string{"MERGESORT"}) {
+        return {"smallSortThreshold"};
+    } else if (algorithm == std::string{"RADIXSORT"}) {
+        return {"radixDigitBits"};
+    } else if (algorithm == std::string{"COMBSORT"}) {
+        return {"shrinkFactor"};
+    }
+    return {};
+}
+
+EngineParameters EngineTuner::tune(const EngineParameters& start) {
+    EngineParameters result = start;
+    if (this->algorithm == std::string{"MERGESORT"}) {
+        std::vector<int> thresholds{};
+        for (int threshold=1; threshold<=256; threshold *= 2) {
+            thresholds.push_back(threshold);
+        }
+        result.smallSortThreshold = this->successiveHalving(result, thresholds, [](EngineParameters& p, int v) { p.smallSortThreshold = v; });
+    } else if (this->algorithm == std::string{"RADIXSORT"}) {
+        std::vector<int> bits{};
+        for (int b=4; b<=16; ++b) {
+            bits.push_back(b);
+        }
+        result.radixDigitBits = this->successiveHalving(result, bits, [](EngineParameters& p, int v) { p.radixDigitBits = v; });
+    } else if (this->algorithm == std::string{"COMBSORT"}) {
+        // below 0.5 comb sort degenerates into (slow) bubble sort passes, above 0.95 it barely shrinks the gap
+        result.shrinkFactor = this->goldenSection(result, 0.5, 0.95, 0.005, [](EngineParameters& p, double v) { p.shrinkFactor = v; });
+    }
+    return result;
+}
+
+double EngineTuner::measure(const EngineParameters& parameters, int runs) {
+    std::unique_ptr<ISortAlgorithm> alg{createSortAlgorithm(this->algorithm, this->upperBound, parameters)};
+    std::vector<double> times{};
+    times.reserve(runs);
+    std::vector<int> sequence{};
+    for (int run=0; run<runs; ++run) {
+        sequence = this->input;
+        alg->reset(sequence.size());
+        auto start = std::chrono::steady_clock::now();
+        alg->sort(sequence);
+        auto end = std::chrono::steady_clock::now();
+        if (!isSorted(sequence)) {
+            throw std::domain_error{"sorting failed while tuning!"};
+        }
+        times.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+int EngineTuner::successiveHalving(EngineParameters parameters, std::vector<int> candidates, const std::function<void(EngineParameters&, int)>& apply) {
+    int roundRuns = this->runs;
+    while (candidates.size() > 1) {
+        std::vector<std::pair<double, int>> timed{};
+        for (int candidate : candidates) {
+            apply(parameters, candidate);
+            timed.push_back(std::make_pair(this->measure(parameters, roundRuns), candidate));
+        }
+        std::sort(timed.begin(), timed.end());
+        candidates.clear();
+        for (std::size_t i=0; i<(timed.size() + 1) / 2; ++i) {
+            candidates.push_back(timed[i].second);
+        }
+        roundRuns *= 2;
+    }
+    return candidates[0];
+}
+
+double EngineTuner::goldenSection(EngineParameters parameters, double lower, double upper, double tolerance, const std::function<void(EngineParameters&, double)>& apply) {
+    const double invPhi = (std::sqrt(5.0) - 1) / 2;
+    double a = lower;
+    double b = upper;
+    double c = b - invPhi * (b - a);
+    double d = a + invPhi * (b - a);
+    apply(parameters, c);
+    double fc = this->measure(parameters, this->runs);
+    apply(parameters, d);
+    double fd = this->measure(parameters, this->runs);
+    while ((b - a) > tolerance) {
+        // keep the bracket containing the fastest point: only one new point needs to be timed per iteration
+        if (fc < fd) {
+            b = d;
+            d = c;
+            fd = fc;
+            c = b - invPhi * (b - a);
+            apply(parameters, c);
+            fc = this->measure(parameters, this->runs);
+        } else {
+            a = c;
+            c = d;
+            fc = fd;
+            d = a + invPhi * (b - a);
+            apply(parameters, d);
+            fd = this->measure(parameters, this->runs);
+        }
+    }
+    return fc < fd ? c : d;
+}
+
+static JsonValue readTuningProfile(const std::string& fileName) {
+    std::ifstream file{fileName};
+    if (!file) {
+        throw std::domain_error{"can't open tuning profile " + fileName};
+    }
+    std::stringstream content{};
+    content << file.rdbuf();
+    JsonValue profile = JsonValue::parse(content.str());
+    if (!profile.isObject()) {
+        throw std::domain_error{"tuning profile " + fileName + " is not a json object"};
+    }
+    return profile;
+}
+
+void applyTuningProfile(const std::string& fileName, EngineParameters& parameters) {
+    JsonValue profile = readTuningProfile(fileName);
+    if (profile.has("shrinkFactor")) {
+        parameters.shrinkFactor = profile.get("shrinkFactor").asNumber();
+    }
+    if (profile.has("smallSortThreshold")) {
+        parameters.smallSortThreshold = static_cast<int>(profile.get("smallSortThreshold").asInt());
+    }
+    if (profile.has("radixDigitBits")) {
+        parameters.radixDigitBits = static_cast<int>(profile.get("radixDigitBits").asInt());
+    }
+}
+
+void saveTuningProfile(const std::string& fileName, const EngineParameters& parameters, const std::vector<std::string>& tunables, const std::string& input) {
+    JsonValue profile = JsonValue::object();
+    if (std::ifstream{fileName}) {
+        profile = readTuningProfile(fileName);
+    }
+    for (auto& tunable : tunables) {
+        if (tunable == std::string{"shrinkFactor"}) {
+            profile.set(tunable, parameters.shrinkFactor);
+        } else if (tunable == std::string{"smallSortThreshold"}) {
+            profile.set(tunable, parameters.smallSortThreshold);
+        } else if (tunable == std::string{"radixDigitBits"}) {
+            profile.set(tunable, parameters.radixDigitBits);
+        } else {
+            throw std::domain_error{"unknown tunable " + tunable};
+        }
+        profile.set(tunable + "TunedOn", input);
+    }
+
+    FILE* f = fopen(fileName.c_str(), "w");
+    if (f == NULL) {
+        throw std::domain_error{"can't open file"};
+    }
+    fprintf(f, "%s\n", profile.dump().c_str());
+    fclose(f);
+}
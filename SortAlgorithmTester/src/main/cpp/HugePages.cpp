@@ -0,0 +1,213 @@
+#include "HugePages.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+ * flags choosing the size of MAP_HUGETLB pages, as in <linux/mman.h>: log2 of the size, shifted. They are part of the
+ * kernel ABI, but old C libraries don't define them
+ */
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+static const std::size_t TWO_MEGABYTES = 2UL << 20;
+static const std::size_t ONE_GIGABYTE = 1UL << 30;
+
+static std::size_t roundUp(std::size_t bytes, std::size_t pageSize) {
+    return (std::max<std::size_t>(bytes, 1) + pageSize - 1) / pageSize * pageSize;
+}
+
+PageKind parsePageKind(const std::string& name) {
+    if (name == "default") {
+        return PageKind::DEFAULT;
+    } else if (name == "thp") {
+        return PageKind::THP;
+    } else if (name == "hugetlb2M") {
+        return PageKind::HUGETLB_2M;
+    } else if (name == "hugetlb1G") {
+        return PageKind::HUGETLB_1G;
+    }
+    throw std::domain_error{"invalid pages " + name + ": they need to be default, thp, hugetlb2M or hugetlb1G"};
+}
+
+std::string getPageKindName(PageKind kind) {
+    switch (kind) {
+    case PageKind::THP:
+        return "thp";
+    case PageKind::HUGETLB_2M:
+        return "hugetlb2M";
+    case PageKind::HUGETLB_1G:
+        return "hugetlb1G";
+    default:
+        return "default";
+    }
+}
+
+std::size_t getHugePageSize(PageKind kind) {
+    switch (kind) {
+    case PageKind::THP: {
+        std::ifstream file{"/sys/kernel/mm/transparent_hugepage/hpage_pmd_size"};
+        std::size_t result = 0;
+        if (file >> result && result > 0) {
+            return result;
+        }
+        return TWO_MEGABYTES;
+    }
+    case PageKind::HUGETLB_2M:
+        return TWO_MEGABYTES;
+    case PageKind::HUGETLB_1G:
+        return ONE_GIGABYTE;
+    default:
+        return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+}
+
+PageKind adviseHugePages(void* data, std::size_t bytes) {
+    // only the pages fully inside the range: the others may hold someone else's memory
+    uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t start = (reinterpret_cast<uintptr_t>(data) + pageSize - 1) & ~(pageSize - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(pageSize - 1);
+    if (start >= end) {
+        return PageKind::DEFAULT;
+    }
+    if (madvise(reinterpret_cast<void*>(start), end - start, MADV_HUGEPAGE) != 0) {
+        return PageKind::DEFAULT;
+    }
+    return PageKind::THP;
+}
+
+PageAllocation::PageAllocation(PageKind requested, std::size_t bytes) :
+        requested{requested}, obtained{PageKind::DEFAULT}, bytes{bytes}, mapping{nullptr}, mappedBytes{0} {
+    if ((requested == PageKind::HUGETLB_2M || requested == PageKind::HUGETLB_1G) && this->map(requested)) {
+        return;
+    }
+    if (requested != PageKind::DEFAULT && this->map(PageKind::THP)) {
+        return;
+    }
+    if (!this->map(PageKind::DEFAULT)) {
+        throw std::domain_error{"can't map " + std::to_string(bytes) + " bytes"};
+    }
+}
+
+PageAllocation::~PageAllocation() {
+    munmap(this->mapping, this->mappedBytes);
+}
+
+void* PageAllocation::getData() const {
+    return this->mapping;
+}
+
+std::size_t PageAllocation::getBytes() const {
+    return this->bytes;
+}
+
+PageKind PageAllocation::getRequested() const {
+    return this->requested;
+}
+
+PageKind PageAllocation::getObtained() const {
+    return this->obtained;
+}
+
+bool PageAllocation::map(PageKind kind) {
+    std::size_t pageSize = getHugePageSize(kind);
+    std::size_t length = roundUp(this->bytes, pageSize);
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    if (kind == PageKind::HUGETLB_2M || kind == PageKind::HUGETLB_1G) {
+        // the pool of pages of that size, which the administrator reserves: the kernel aligns them
+        int shift = kind == PageKind::HUGETLB_2M ? 21 : 30;
+        void* result = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT), -1, 0);
+        if (result == MAP_FAILED) {
+            return false;
+        }
+        this->mapping = result;
+        this->mappedBytes = length;
+        this->obtained = kind;
+        return true;
+    }
+    if (kind == PageKind::DEFAULT) {
+        void* result = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (result == MAP_FAILED) {
+            return false;
+        }
+        this->mapping = result;
+        this->mappedBytes = length;
+        this->obtained = kind;
+        return true;
+    }
+    // transparent huge pages fill only aligned ranges: map a page more and trim it
+    void* result = mmap(nullptr, length + pageSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (result == MAP_FAILED) {
+        return false;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t>(result);
+    uintptr_t aligned = (start + pageSize - 1) & ~(static_cast<uintptr_t>(pageSize) - 1);
+    if (aligned > start) {
+        munmap(result, aligned - start);
+    }
+    if (start + pageSize > aligned) {
+        munmap(reinterpret_cast<void*>(aligned + length), start + pageSize - aligned);
+    }
+    if (adviseHugePages(reinterpret_cast<void*>(aligned), length) != PageKind::THP) {
+        munmap(reinterpret_cast<void*>(aligned), length);
+        return false;
+    }
+    this->mapping = reinterpret_cast<void*>(aligned);
+    this->mappedBytes = length;
+    this->obtained = kind;
+    return true;
+}
+
+std::size_t countHugePageBytes(const void* data, std::size_t bytes) {
+    std::ifstream smaps{"/proc/self/smaps"};
+    uintptr_t first = reinterpret_cast<uintptr_t>(data);
+    uintptr_t last = first + bytes;
+    std::size_t result = 0;
+    // the part of the current mapping inside the range. 0 if they don't overlap
+    std::size_t overlap = 0;
+    std::size_t mappingHugeBytes = 0;
+    std::string line;
+    while (std::getline(smaps, line)) {
+        std::size_t dash = line.find('-');
+        std::size_t space = line.find(' ');
+        if (dash != std::string::npos && space != std::string::npos && dash < space && line.find(':') > space) {
+            // the header of a new mapping: start-end perms offset device inode path
+            result += std::min(overlap, mappingHugeBytes);
+            uintptr_t start = strtoull(line.c_str(), nullptr, 16);
+            uintptr_t end = strtoull(line.c_str() + dash + 1, nullptr, 16);
+            overlap = std::max(start, first) < std::min(end, last) ? std::min(end, last) - std::max(start, first) : 0;
+            mappingHugeBytes = 0;
+            continue;
+        }
+        if (overlap == 0) {
+            continue;
+        }
+        std::istringstream fields{line};
+        std::string key;
+        std::size_t kilobytes = 0;
+        if (fields >> key >> kilobytes && (key == "AnonHugePages:" || key == "Private_Hugetlb:" || key == "Shared_Hugetlb:")) {
+            mappingHugeBytes += kilobytes * 1024;
+        }
+    }
+    result += std::min(overlap, mappingHugeBytes);
+    return result;
+}
+
+void writePagesReport(FILE* file, const std::vector<PageReport>& reports) {
+    fprintf(file, "buffer,requested,obtained,bytes,hugePages,hugePageBytes\n");
+    for (auto& report : reports) {
+        std::size_t hugePageSize = getHugePageSize(report.obtained == PageKind::DEFAULT ? report.requested : report.obtained);
+        fprintf(file, "%s,%s,%s,%lu,%lu,%lu\n", report.buffer.c_str(),
+            getPageKindName(report.requested).c_str(), getPageKindName(report.obtained).c_str(),
+            static_cast<unsigned long>(report.bytes), static_cast<unsigned long>(report.hugePageBytes / hugePageSize),
+            static_cast<unsigned long>(report.hugePageBytes)
+        );
+    }
+}
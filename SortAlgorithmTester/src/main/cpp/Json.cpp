@@ -0,0 +1,384 @@
+#include "Json.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+JsonValue::JsonValue() : type{Type::NUL}, boolean{false}, number{0} {
+}
+
+JsonValue::JsonValue(bool value) : type{Type::BOOLEAN}, boolean{value}, number{0} {
+}
+
+JsonValue::JsonValue(int value) : type{Type::NUMBER}, boolean{false}, number{static_cast<double>(value)} {
+}
+
+JsonValue::JsonValue(long value) : type{Type::NUMBER}, boolean{false}, number{static_cast<double>(value)} {
+}
+
+JsonValue::JsonValue(unsigned long value) : type{Type::NUMBER}, boolean{false}, number{static_cast<double>(value)} {
+}
+
+JsonValue::JsonValue(double value) : type{Type::NUMBER}, boolean{false}, number{value} {
+}
+
+JsonValue::JsonValue(const char* value) : type{Type::STRING}, boolean{false}, number{0}, string{value} {
+}
+
+JsonValue::JsonValue(const std::string& value) : type{Type::STRING}, boolean{false}, number{0}, string{value} {
+}
+
+JsonValue JsonValue::array() {
+    JsonValue result;
+    result.type = Type::ARRAY;
+    return result;
+}
+
+JsonValue JsonValue::object() {
+    JsonValue result;
+    result.type = Type::OBJECT;
+    return result;
+}
+
+JsonValue::Type JsonValue::getType() const {
+    return this->type;
+}
+
+bool JsonValue::isNull() const {
+    return this->type == Type::NUL;
+}
+
+bool JsonValue::isObject() const {
+    return this->type == Type::OBJECT;
+}
+
+void JsonValue::checkType(Type expected) const {
+    if (this->type != expected) {
+        throw std::domain_error{"unexpected json type"};
+    }
+}
+
+bool JsonValue::asBool() const {
+    this->checkType(Type::BOOLEAN);
+    return this->boolean;
+}
+
+double JsonValue::asNumber() const {
+    this->checkType(Type::NUMBER);
+    return this->number;
+}
+
+long JsonValue::asInt() const {
+    this->checkType(Type::NUMBER);
+    return static_cast<long>(this->number);
+}
+
+const std::string& JsonValue::asString() const {
+    this->checkType(Type::STRING);
+    return this->string;
+}
+
+const std::vector<JsonValue>& JsonValue::asArray() const {
+    this->checkType(Type::ARRAY);
+    return this->elements;
+}
+
+const std::vector<std::pair<std::string, JsonValue>>& JsonValue::asObject() const {
+    this->checkType(Type::OBJECT);
+    return this->members;
+}
+
+bool JsonValue::has(const std::string& key) const {
+    if (this->type != Type::OBJECT) {
+        return false;
+    }
+    for (auto& member : this->members) {
+        if (member.first == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const JsonValue& JsonValue::get(const std::string& key) const {
+    this->checkType(Type::OBJECT);
+    for (auto& member : this->members) {
+        if (member.first == key) {
+            return member.second;
+        }
+    }
+    throw std::domain_error{"json object has no member " + key};
+}
+
+JsonValue& JsonValue::set(const std::string& key, const JsonValue& value) {
+    this->checkType(Type::OBJECT);
+    for (auto& member : this->members) {
+        if (member.first == key) {
+            member.second = value;
+            return *this;
+        }
+    }
+    this->members.push_back(std::make_pair(key, value));
+    return *this;
+}
+
+JsonValue& JsonValue::push(const JsonValue& value) {
+    this->checkType(Type::ARRAY);
+    this->elements.push_back(value);
+    return *this;
+}
+
+void appendJsonString(std::string& out, const std::string& s) {
+    out.push_back('"');
+    for (char c : s) {
+        switch (c) {
+        case '"': out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out.append(escaped);
+            } else {
+                out.push_back(c);
+            }
+        }
+    }
+    out.push_back('"');
+}
+
+void JsonValue::dump(std::string& out) const {
+    switch (this->type) {
+    case Type::NUL:
+        out.append("null");
+        break;
+    case Type::BOOLEAN:
+        out.append(this->boolean ? "true" : "false");
+        break;
+    case Type::NUMBER: {
+        char buffer[32];
+        if (!std::isfinite(this->number)) {
+            // JSON has no representation for them
+            out.append("null");
+            break;
+        }
+        if (this->number == std::floor(this->number) && std::fabs(this->number) < 1e15) {
+            snprintf(buffer, sizeof(buffer), "%.0f", this->number);
+        } else {
+            snprintf(buffer, sizeof(buffer), "%.17g", this->number);
+        }
+        out.append(buffer);
+        break;
+    }
+    case Type::STRING:
+        appendJsonString(out, this->string);
+        break;
+    case Type::ARRAY:
+        out.push_back('[');
+        for (std::size_t i=0; i<this->elements.size(); ++i) {
+            if (i > 0) {
+                out.push_back(',');
+            }
+            this->elements[i].dump(out);
+        }
+        out.push_back(']');
+        break;
+    case Type::OBJECT:
+        out.push_back('{');
+        for (std::size_t i=0; i<this->members.size(); ++i) {
+            if (i > 0) {
+                out.push_back(',');
+            }
+            appendJsonString(out, this->members[i].first);
+            out.push_back(':');
+            this->members[i].second.dump(out);
+        }
+        out.push_back('}');
+        break;
+    }
+}
+
+std::string JsonValue::dump() const {
+    std::string result;
+    this->dump(result);
+    return result;
+}
+
+/**
+ * recursive descent parser over a string
+ */
+class JsonParser {
+public:
+    JsonParser(const std::string& text) : text{text}, position{0} {}
+
+    JsonValue parseDocument() {
+        JsonValue result = this->parseValue();
+        this->skipSpaces();
+        if (this->position != this->text.size()) {
+            this->fail("trailing characters");
+        }
+        return result;
+    }
+private:
+    void fail(const std::string& message) const {
+        throw std::domain_error{"invalid json at " + std::to_string(this->position) + ": " + message};
+    }
+
+    void skipSpaces() {
+        while (this->position < this->text.size() && isspace(static_cast<unsigned char>(this->text[this->position]))) {
+            ++this->position;
+        }
+    }
+
+    bool consume(char c) {
+        this->skipSpaces();
+        if (this->position < this->text.size() && this->text[this->position] == c) {
+            ++this->position;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!this->consume(c)) {
+            this->fail(std::string{"expected "} + c);
+        }
+    }
+
+    bool consumeWord(const char* word) {
+        std::string w{word};
+        if (this->text.compare(this->position, w.size(), w) == 0) {
+            this->position += w.size();
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parseValue() {
+        this->skipSpaces();
+        if (this->position >= this->text.size()) {
+            this->fail("unexpected end");
+        }
+        char c = this->text[this->position];
+        if (c == '{') {
+            return this->parseObject();
+        } else if (c == '[') {
+            return this->parseArray();
+        } else if (c == '"') {
+            return JsonValue{this->parseString()};
+        } else if (this->consumeWord("true")) {
+            return JsonValue{true};
+        } else if (this->consumeWord("false")) {
+            return JsonValue{false};
+        } else if (this->consumeWord("null")) {
+            return JsonValue{};
+        }
+        return this->parseNumber();
+    }
+
+    JsonValue parseObject() {
+        JsonValue result = JsonValue::object();
+        this->expect('{');
+        if (this->consume('}')) {
+            return result;
+        }
+        do {
+            this->skipSpaces();
+            std::string key = this->parseString();
+            this->expect(':');
+            result.set(key, this->parseValue());
+        } while (this->consume(','));
+        this->expect('}');
+        return result;
+    }
+
+    JsonValue parseArray() {
+        JsonValue result = JsonValue::array();
+        this->expect('[');
+        if (this->consume(']')) {
+            return result;
+        }
+        do {
+            result.push(this->parseValue());
+        } while (this->consume(','));
+        this->expect(']');
+        return result;
+    }
+
+    std::string parseString() {
+        if (this->position >= this->text.size() || this->text[this->position] != '"') {
+            this->fail("expected string");
+        }
+        ++this->position;
+        std::string result;
+        while (this->position < this->text.size()) {
+            char c = this->text[this->position++];
+            if (c == '"') {
+                return result;
+            }
+            if (c != '\\') {
+                result.push_back(c);
+                continue;
+            }
+            if (this->position >= this->text.size()) {
+                break;
+            }
+            char escaped = this->text[this->position++];
+            switch (escaped) {
+            case '"': result.push_back('"'); break;
+            case '\\': result.push_back('\\'); break;
+            case '/': result.push_back('/'); break;
+            case 'b': result.push_back('\b'); break;
+            case 'f': result.push_back('\f'); break;
+            case 'n': result.push_back('\n'); break;
+            case 'r': result.push_back('\r'); break;
+            case 't': result.push_back('\t'); break;
+            case 'u': {
+                if (this->position + 4 > this->text.size()) {
+                    this->fail("truncated unicode escape");
+                }
+                unsigned long code = strtoul(this->text.substr(this->position, 4).c_str(), nullptr, 16);
+                this->position += 4;
+                // encode as UTF-8 (surrogate pairs are not combined)
+                if (code < 0x80) {
+                    result.push_back(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    result.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                    result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    result.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                    result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                this->fail("invalid escape");
+            }
+        }
+        this->fail("unterminated string");
+        return result;
+    }
+
+    JsonValue parseNumber() {
+        const char* begin = this->text.c_str() + this->position;
+        char* end;
+        double result = strtod(begin, &end);
+        if (end == begin) {
+            this->fail("unexpected character");
+        }
+        this->position += (end - begin);
+        return JsonValue{result};
+    }
+private:
+    const std::string& text;
+    std::size_t position;
+};
+
+JsonValue JsonValue::parse(const std::string& text) {
+    return JsonParser{text}.parseDocument();
+}
@@ -0,0 +1,158 @@
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+LatencyHistogram::LatencyHistogram(uint64_t highestTrackableValue, int significantDigits) :
+        highestTrackableValue{highestTrackableValue},
+        counts{},
+        totalCount{0}, min{std::numeric_limits<uint64_t>::max()}, max{0}, mean{0}, m2{0} {
+    if (significantDigits < 1 || significantDigits > 5) {
+        throw std::domain_error{"significant digits of histogram need to be between 1 and 5"};
+    }
+    if (highestTrackableValue < 2) {
+        throw std::domain_error{"highest trackable value of histogram needs to be at least 2"};
+    }
+    // we need at least 2*10^digits sub buckets to keep the requested precision in every power of 2
+    uint64_t largestValueWithSingleUnitResolution = 2 * static_cast<uint64_t>(std::pow(10, significantDigits));
+    int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(static_cast<double>(largestValueWithSingleUnitResolution))));
+    this->subBucketHalfCountMagnitude = subBucketCountMagnitude - 1;
+    uint64_t subBucketCount = 1ULL << subBucketCountMagnitude;
+    this->subBucketHalfCount = subBucketCount / 2;
+    this->subBucketMask = subBucketCount - 1;
+
+    // first bucket covers [0, subBucketCount), each following one doubles the range
+    int bucketCount = 1;
+    uint64_t smallestUntrackableValue = subBucketCount;
+    while (smallestUntrackableValue <= highestTrackableValue) {
+        if (smallestUntrackableValue > (std::numeric_limits<uint64_t>::max() / 2)) {
+            ++bucketCount;
+            break;
+        }
+        smallestUntrackableValue <<= 1;
+        ++bucketCount;
+    }
+    this->counts.resize((bucketCount + 1) * this->subBucketHalfCount, 0);
+}
+
+int LatencyHistogram::getBucketIndex(uint64_t value) const {
+    // 63 is the index of the most significant bit of a uint64_t
+    return (63 - this->subBucketHalfCountMagnitude) - __builtin_clzll(value | this->subBucketMask);
+}
+
+std::size_t LatencyHistogram::getCountsIndex(uint64_t value) const {
+    int bucketIndex = this->getBucketIndex(value);
+    uint64_t subBucketIndex = value >> bucketIndex;
+    return (static_cast<std::size_t>(bucketIndex + 1) << this->subBucketHalfCountMagnitude) + (subBucketIndex - this->subBucketHalfCount);
+}
+
+uint64_t LatencyHistogram::getHighestEquivalentValue(std::size_t countsIndex) const {
+    int bucketIndex = static_cast<int>(countsIndex >> this->subBucketHalfCountMagnitude) - 1;
+    uint64_t subBucketIndex = (countsIndex & (this->subBucketHalfCount - 1)) + this->subBucketHalfCount;
+    if (bucketIndex < 0) {
+        // first half of the first bucket
+        subBucketIndex -= this->subBucketHalfCount;
+        bucketIndex = 0;
+    }
+    uint64_t lowestEquivalentValue = subBucketIndex << bucketIndex;
+    return lowestEquivalentValue + (1ULL << bucketIndex) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    uint64_t clamped = value > this->highestTrackableValue ? this->highestTrackableValue : value;
+    std::size_t index = this->getCountsIndex(clamped);
+    if (index >= this->counts.size()) {
+        index = this->counts.size() - 1;
+    }
+    ++this->counts[index];
+
+    ++this->totalCount;
+    if (value < this->min) {
+        this->min = value;
+    }
+    if (value > this->max) {
+        this->max = value;
+    }
+    double delta = value - this->mean;
+    this->mean += delta / this->totalCount;
+    this->m2 += delta * (value - this->mean);
+}
+
+void LatencyHistogram::reset() {
+    std::fill(this->counts.begin(), this->counts.end(), 0);
+    this->totalCount = 0;
+    this->min = std::numeric_limits<uint64_t>::max();
+    this->max = 0;
+    this->mean = 0;
+    this->m2 = 0;
+}
+
+uint64_t LatencyHistogram::getTotalCount() const {
+    return this->totalCount;
+}
+
+uint64_t LatencyHistogram::getMin() const {
+    return this->totalCount > 0 ? this->min : 0;
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return this->max;
+}
+
+double LatencyHistogram::getMean() const {
+    return this->mean;
+}
+
+double LatencyHistogram::getStdDev() const {
+    if (this->totalCount < 2) {
+        return 0;
+    }
+    return std::sqrt(this->m2 / (this->totalCount - 1));
+}
+
+uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+    if (this->totalCount == 0) {
+        return 0;
+    }
+    if (percentile < 0) {
+        percentile = 0;
+    } else if (percentile > 100) {
+        percentile = 100;
+    }
+    uint64_t countAtPercentile = static_cast<uint64_t>(std::ceil((percentile / 100.0) * this->totalCount));
+    if (countAtPercentile < 1) {
+        countAtPercentile = 1;
+    }
+    uint64_t total = 0;
+    for (std::size_t i=0; i<this->counts.size(); ++i) {
+        total += this->counts[i];
+        if (total >= countAtPercentile) {
+            uint64_t result = this->getHighestEquivalentValue(i);
+            // a bucket may be wider than the values actually recorded in it
+            if (result > this->max) {
+                return this->max;
+            }
+            if (result < this->min) {
+                return this->min;
+            }
+            return result;
+        }
+    }
+    return this->max;
+}
+
+void writeLatencySummary(FILE* f, const LatencyHistogram& histogram) {
+    fprintf(f, "runs,mean,stddev,p50,p90,p99,p999,max\n");
+    fprintf(f, "%lu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+        static_cast<unsigned long>(histogram.getTotalCount()),
+        histogram.getMean() / 1e3,
+        histogram.getStdDev() / 1e3,
+        histogram.getValueAtPercentile(50) / 1e3,
+        histogram.getValueAtPercentile(90) / 1e3,
+        histogram.getValueAtPercentile(99) / 1e3,
+        histogram.getValueAtPercentile(99.9) / 1e3,
+        histogram.getMax() / 1e3
+    );
+}
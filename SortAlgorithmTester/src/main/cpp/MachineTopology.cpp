@@ -0,0 +1,223 @@
+#include "MachineTopology.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <dirent.h>
+
+/**
+ * @return the first line of the file, empty if the file can't be read
+ */
+static std::string readLine(const std::string& fileName) {
+    std::ifstream file{fileName};
+    std::string result;
+    std::getline(file, result);
+    return result;
+}
+
+static int readInt(const std::string& fileName, int defaultValue) {
+    std::string line = readLine(fileName);
+    if (line.empty()) {
+        return defaultValue;
+    }
+    return atoi(line.c_str());
+}
+
+/**
+ * parse sizes like "48K", "2048K" or "8M"
+ */
+static long parseSize(const std::string& size) {
+    char* suffix;
+    long result = strtol(size.c_str(), &suffix, 10);
+    switch (*suffix) {
+    case 'K': return result * 1024;
+    case 'M': return result * 1024 * 1024;
+    case 'G': return result * 1024 * 1024 * 1024;
+    default: return result;
+    }
+}
+
+/**
+ * @return the numbers N of the entries named "<prefix>N" inside folder
+ */
+static std::vector<int> listNumberedEntries(const std::string& folder, const std::string& prefix) {
+    std::vector<int> result{};
+    DIR* dir = opendir(folder.c_str());
+    if (dir == nullptr) {
+        return result;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name{entry->d_name};
+        if (name.compare(0, prefix.size(), prefix) != 0 || name.size() == prefix.size()) {
+            continue;
+        }
+        char* end;
+        long number = strtol(name.c_str() + prefix.size(), &end, 10);
+        if (*end == '\0') {
+            result.push_back(static_cast<int>(number));
+        }
+    }
+    closedir(dir);
+    std::set<int> sorted{result.begin(), result.end()};
+    return std::vector<int>{sorted.begin(), sorted.end()};
+}
+
+std::vector<int> parseCpuList(const std::string& cpuList) {
+    std::vector<int> result{};
+    std::stringstream ss{cpuList};
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        std::size_t dash = range.find('-');
+        int first = atoi(range.substr(0, dash).c_str());
+        int last = (dash == std::string::npos) ? first : atoi(range.substr(dash + 1).c_str());
+        for (int cpu=first; cpu<=last; ++cpu) {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+int MachineTopology::getLogicalCores() const {
+    return static_cast<int>(this->cpus.size());
+}
+
+int MachineTopology::getPhysicalCores() const {
+    std::set<std::pair<int, int>> cores{};
+    for (auto& cpu : this->cpus) {
+        cores.insert(std::make_pair(cpu.package, cpu.core));
+    }
+    return static_cast<int>(cores.size());
+}
+
+MachineTopology probeMachineTopology(const std::string& sysfsCpuRoot, const std::string& sysfsNodeRoot) {
+    MachineTopology result;
+    // conservative defaults, used when sysfs is not available
+    result.l1DataCacheSize = 32 * 1024;
+    result.l2CacheSize = 256 * 1024;
+    result.lastLevelCacheSize = 0;
+    result.cacheLineSize = 64;
+    result.numaNodes = 1;
+
+    std::string online = readLine(sysfsCpuRoot + "/online");
+    std::vector<int> cpus = online.empty() ? listNumberedEntries(sysfsCpuRoot, "cpu") : parseCpuList(online);
+    for (int cpu : cpus) {
+        std::string topology = sysfsCpuRoot + "/cpu" + std::to_string(cpu) + "/topology/";
+        CpuLocation location;
+        location.cpu = cpu;
+        location.core = readInt(topology + "core_id", cpu);
+        location.package = readInt(topology + "physical_package_id", 0);
+        location.node = 0;
+        result.cpus.push_back(location);
+    }
+
+    // caches of the first cpu: we assume every cpu has the same ones
+    if (!cpus.empty()) {
+        std::string cache = sysfsCpuRoot + "/cpu" + std::to_string(cpus[0]) + "/cache";
+        int lastLevel = 0;
+        for (int index : listNumberedEntries(cache, "index")) {
+            std::string folder = cache + "/index" + std::to_string(index) + "/";
+            int level = readInt(folder + "level", 0);
+            std::string type = readLine(folder + "type");
+            long size = parseSize(readLine(folder + "size"));
+            if (type == "Instruction" || size <= 0) {
+                continue;
+            }
+            if (level == 1) {
+                result.l1DataCacheSize = size;
+                result.cacheLineSize = readInt(folder + "coherency_line_size", result.cacheLineSize);
+            } else if (level == 2) {
+                result.l2CacheSize = size;
+            }
+            if (level >= lastLevel) {
+                lastLevel = level;
+                result.lastLevelCacheSize = size;
+            }
+        }
+    }
+
+    std::vector<int> nodes = listNumberedEntries(sysfsNodeRoot, "node");
+    if (!nodes.empty()) {
+        result.numaNodes = static_cast<int>(nodes.size());
+        for (int node : nodes) {
+            for (int cpu : parseCpuList(readLine(sysfsNodeRoot + "/node" + std::to_string(node) + "/cpulist"))) {
+                for (auto& location : result.cpus) {
+                    if (location.cpu == cpu) {
+                        location.node = node;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+void saveMachineTopology(const std::string& fileName, const MachineTopology& topology) {
+    FILE* f = fopen(fileName.c_str(), "w");
+    if (f == NULL) {
+        throw std::domain_error{"can't open file"};
+    }
+    fprintf(f, "l1DataCacheSize=%ld\n", topology.l1DataCacheSize);
+    fprintf(f, "l2CacheSize=%ld\n", topology.l2CacheSize);
+    fprintf(f, "lastLevelCacheSize=%ld\n", topology.lastLevelCacheSize);
+    fprintf(f, "cacheLineSize=%d\n", topology.cacheLineSize);
+    fprintf(f, "numaNodes=%d\n", topology.numaNodes);
+    // cpu=<cpu>,<core>,<package>,<node>
+    for (auto& cpu : topology.cpus) {
+        fprintf(f, "cpu=%d,%d,%d,%d\n", cpu.cpu, cpu.core, cpu.package, cpu.node);
+    }
+    fclose(f);
+}
+
+MachineTopology loadMachineTopology(const std::string& fileName) {
+    std::ifstream file{fileName};
+    if (!file) {
+        throw std::domain_error{"can't open topology file"};
+    }
+    MachineTopology result = MachineTopology{32 * 1024, 256 * 1024, 0, 64, 1, {}};
+    std::string line;
+    while (std::getline(file, line)) {
+        std::size_t equal = line.find('=');
+        if (equal == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, equal);
+        std::string value = line.substr(equal + 1);
+        if (key == "l1DataCacheSize") {
+            result.l1DataCacheSize = atol(value.c_str());
+        } else if (key == "l2CacheSize") {
+            result.l2CacheSize = atol(value.c_str());
+        } else if (key == "lastLevelCacheSize") {
+            result.lastLevelCacheSize = atol(value.c_str());
+        } else if (key == "cacheLineSize") {
+            result.cacheLineSize = atoi(value.c_str());
+        } else if (key == "numaNodes") {
+            result.numaNodes = atoi(value.c_str());
+        } else if (key == "cpu") {
+            CpuLocation cpu;
+            if (sscanf(value.c_str(), "%d,%d,%d,%d", &cpu.cpu, &cpu.core, &cpu.package, &cpu.node) == 4) {
+                result.cpus.push_back(cpu);
+            }
+        }
+    }
+    return result;
+}
+
+MachineTopology getMachineTopology(const std::string& cacheFileName) {
+    if (cacheFileName.empty()) {
+        return probeMachineTopology();
+    }
+    std::ifstream cache{cacheFileName};
+    if (cache) {
+        return loadMachineTopology(cacheFileName);
+    }
+    MachineTopology result = probeMachineTopology();
+    saveMachineTopology(cacheFileName, result);
+    return result;
+}
@@ -0,0 +1,311 @@
+#include "ManifestScheduler.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * exit code of a context which couldn't be executed
+ */
+static const int FAILURE_EXIT_CODE = 1;
+
+Placement parsePlacement(const std::string& name) {
+    if (name == "core") {
+        return Placement::CORE;
+    } else if (name == "socket") {
+        return Placement::SOCKET;
+    }
+    throw std::domain_error{"invalid placement " + name + ": it needs to be either core or socket"};
+}
+
+std::vector<CoreSlot> getCoreSlots(const MachineTopology& topology, const std::vector<int>& allowedCpus) {
+    // (package, core) -> cpus. Unknown CPUs get a core of their own, after every known one
+    std::map<std::pair<int, int>, std::vector<int>> cores{};
+    int unknownCore = 0;
+    for (auto& location : topology.cpus) {
+        unknownCore = std::max(unknownCore, location.core + 1);
+    }
+    for (int cpu : allowedCpus) {
+        auto location = std::find_if(topology.cpus.begin(), topology.cpus.end(), [cpu](const CpuLocation& l) { return l.cpu == cpu; });
+        if (location == topology.cpus.end()) {
+            cores[std::make_pair(0, unknownCore++)].push_back(cpu);
+        } else {
+            cores[std::make_pair(location->package, location->core)].push_back(cpu);
+        }
+    }
+    std::vector<CoreSlot> result{};
+    for (auto& core : cores) {
+        std::sort(core.second.begin(), core.second.end());
+        result.push_back(CoreSlot{core.first.first, core.second});
+    }
+    return result;
+}
+
+CoreScheduler::CoreScheduler(const std::vector<CoreSlot>& cores) : cores{cores}, reserved(cores.size(), false) {
+}
+
+std::vector<std::size_t> CoreScheduler::acquire(Placement placement) {
+    std::vector<std::size_t> result{};
+    if (placement == Placement::CORE) {
+        for (std::size_t i=0; i<this->cores.size(); ++i) {
+            if (!this->reserved[i]) {
+                result.push_back(i);
+                break;
+            }
+        }
+    } else {
+        // cores of the same package are contiguous
+        for (std::size_t first=0; first<this->cores.size() && result.empty(); ) {
+            std::size_t last = first;
+            bool free = true;
+            while (last < this->cores.size() && this->cores[last].package == this->cores[first].package) {
+                free = free && !this->reserved[last];
+                ++last;
+            }
+            if (free) {
+                for (std::size_t i=first; i<last; ++i) {
+                    result.push_back(i);
+                }
+            }
+            first = last;
+        }
+    }
+    for (std::size_t core : result) {
+        this->reserved[core] = true;
+    }
+    return result;
+}
+
+void CoreScheduler::release(const std::vector<std::size_t>& cores) {
+    for (std::size_t core : cores) {
+        this->reserved.at(core) = false;
+    }
+}
+
+std::vector<int> CoreScheduler::getCpus(const std::vector<std::size_t>& cores) const {
+    std::vector<int> result{};
+    for (std::size_t core : cores) {
+        const std::vector<int>& cpus = this->cores.at(core).cpus;
+        result.insert(result.end(), cpus.begin(), cpus.end());
+    }
+    return result;
+}
+
+std::size_t CoreScheduler::getCoreCount() const {
+    return this->cores.size();
+}
+
+std::size_t CoreScheduler::getFreeCoreCount() const {
+    return static_cast<std::size_t>(std::count(this->reserved.begin(), this->reserved.end(), false));
+}
+
+std::vector<ManifestEntry> readManifest(const std::string& fileName) {
+    FILE* manifest = fopen(fileName.c_str(), "r");
+    if (manifest == NULL) {
+        throw std::domain_error{"can't open manifest " + fileName};
+    }
+    std::vector<ManifestEntry> result{};
+    SortPluginRegistry plugins{};
+    char* buffer = nullptr;
+    std::size_t capacity = 0;
+    ssize_t length;
+    int line = 0;
+    try {
+        while ((length = getline(&buffer, &capacity, manifest)) >= 0) {
+            ++line;
+            std::string text{buffer, static_cast<std::size_t>(length)};
+            if (text.find_first_not_of(" \t\r\n") == std::string::npos) {
+                continue;
+            }
+            try {
+                JsonValue options = JsonValue::parse(text);
+                ManifestEntry entry{line, TestContext{}, JsonValue{}, Placement::CORE};
+                entry.parameters = parseTestContext(options, {"placement"}, entry.context);
+                if (options.has("placement")) {
+                    entry.placement = parsePlacement(options.get("placement").asString());
+                } else if (!entry.context.plugins.empty()) {
+                    // parallel plugin engines need a socket of their own
+                    for (auto& plugin : entry.context.plugins) {
+                        plugins.load(plugin);
+                    }
+                    const SortPluginEngine* engine = plugins.find(entry.context.algorithm);
+                    if (engine != nullptr && (engine->capabilities & SORT_PLUGIN_PARALLEL) != 0) {
+                        entry.placement = Placement::SOCKET;
+                    }
+                }
+                result.push_back(entry);
+            } catch (const std::exception& e) {
+                throw std::domain_error{fileName + ":" + std::to_string(line) + ": " + e.what()};
+            }
+        }
+    } catch (...) {
+        free(buffer);
+        fclose(manifest);
+        throw;
+    }
+    free(buffer);
+    fclose(manifest);
+    return result;
+}
+
+/**
+ * body of the process executing a context: it never returns
+ */
+static void executeInChild(const ManifestEntry& entry, const std::vector<int>& cpus) {
+    int exitCode = FAILURE_EXIT_CODE;
+    try {
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (int cpu : cpus) {
+            CPU_SET(cpu, &mask);
+        }
+        if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+            throw std::domain_error{"can't pin the context on its cpus"};
+        }
+        // the validation threads would steal the cores of the other contexts otherwise
+        TestContext context = entry.context;
+        context.validationThreads = std::max(1, std::min(context.validationThreads, static_cast<int>(cpus.size())));
+        JsonValue parameters = entry.parameters;
+        parameters.set("validationThreads", context.validationThreads);
+
+        TestEnvironment environment{};
+        exitCode = executeTestContext(context, parameters, environment);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "line %d: %s\n", entry.line, e.what());
+    }
+    // the destructors of the parent state must not run here: they belong to the parent
+    fflush(nullptr);
+    _exit(exitCode);
+}
+
+int runManifest(const std::vector<ManifestEntry>& entries, const std::vector<CoreSlot>& cores, FILE* report, CampaignJournal* journal) {
+    if (cores.empty()) {
+        throw std::domain_error{"there are no cores to run the manifest on"};
+    }
+    struct Running {
+        std::size_t entry;
+        std::vector<std::size_t> cores;
+        std::chrono::steady_clock::time_point start;
+    };
+    CoreScheduler scheduler{cores};
+    std::map<pid_t, Running> running{};
+    bool failed = false;
+    bool regressed = false;
+    // why no more contexts can be started, if something went wrong. The running ones are still waited for
+    std::string error{};
+    /**
+     * report a context whose process is over, journal it and give its cores back
+     */
+    auto finish = [&](std::map<pid_t, Running>::iterator finished, int exitCode) {
+        const ManifestEntry& entry = entries[finished->second.entry];
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - finished->second.start;
+        JsonValue cpus = JsonValue::array();
+        for (int cpu : scheduler.getCpus(finished->second.cores)) {
+            cpus.push(cpu);
+        }
+        std::string line = JsonValue::object()
+            .set("line", entry.line)
+            .set("outputTemplate", entry.context.outputTemplate)
+            .set("cpus", cpus)
+            .set("exitCode", exitCode)
+            .set("seconds", seconds.count())
+            .dump();
+        fprintf(report, "%s\n", line.c_str());
+        fflush(report);
+
+        if (exitCode == REGRESSION_EXIT_CODE) {
+            regressed = true;
+        } else if (exitCode != 0) {
+            failed = true;
+        }
+        if (journal != nullptr && (exitCode == 0 || exitCode == REGRESSION_EXIT_CODE)) {
+            journal->record(entry.context.outputTemplate, exitCode);
+        }
+        scheduler.release(finished->second.cores);
+        running.erase(finished);
+    };
+    std::size_t next = 0;
+    while ((error.empty() && next < entries.size()) || !running.empty()) {
+        while (error.empty() && next < entries.size()) {
+            int journaledExitCode;
+            if (journal != nullptr && journal->isFinished(entries[next].context.outputTemplate, journaledExitCode)) {
+                std::string line = JsonValue::object()
+                    .set("line", entries[next].line)
+                    .set("outputTemplate", entries[next].context.outputTemplate)
+                    .set("skipped", true)
+                    .set("exitCode", journaledExitCode)
+                    .dump();
+                fprintf(report, "%s\n", line.c_str());
+                fflush(report);
+                regressed = regressed || journaledExitCode == REGRESSION_EXIT_CODE;
+                ++next;
+                continue;
+            }
+            std::vector<std::size_t> reserved = scheduler.acquire(entries[next].placement);
+            if (reserved.empty()) {
+                break;
+            }
+            // the child would write again whatever is still buffered
+            fflush(nullptr);
+            pid_t child = fork();
+            if (child < 0) {
+                scheduler.release(reserved);
+                error = "can't fork the process of line " + std::to_string(entries[next].line);
+                break;
+            }
+            if (child == 0) {
+                executeInChild(entries[next], scheduler.getCpus(reserved));
+            }
+            running[child] = Running{next, reserved, std::chrono::steady_clock::now()};
+            ++next;
+        }
+        if (running.empty()) {
+            // an error, or every remaining entry has been journaled: nothing left to wait for
+            if (!error.empty() || next >= entries.size()) {
+                break;
+            }
+            // nothing will ever free a core: the placement can't be satisfied at all
+            throw std::domain_error{"line " + std::to_string(entries[next].line) + " can't be placed on the available cores"};
+        }
+
+        int status;
+        pid_t child = waitpid(-1, &status, 0);
+        if (child < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (error.empty()) {
+                error = "can't wait for the contexts";
+            }
+            // wait for each child by its pid: the ones which can't be waited for are reported as failed
+            while (!running.empty()) {
+                auto waited = running.begin();
+                pid_t result;
+                do {
+                    result = waitpid(waited->first, &status, 0);
+                } while (result < 0 && errno == EINTR);
+                // a child we can't wait for has an unknown outcome: a failure
+                finish(waited, result < 0 ? FAILURE_EXIT_CODE : (WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status)));
+            }
+            break;
+        }
+        auto finished = running.find(child);
+        if (finished == running.end()) {
+            continue;
+        }
+        finish(finished, WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status));
+    }
+    if (!error.empty()) {
+        throw std::domain_error{error};
+    }
+    if (failed) {
+        return FAILURE_EXIT_CODE;
+    }
+    return regressed ? REGRESSION_EXIT_CODE : 0;
+}
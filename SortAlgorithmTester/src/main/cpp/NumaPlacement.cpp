@@ -0,0 +1,268 @@
+#include "NumaPlacement.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*
+ * memory policies and flags of mbind, as in <linux/mempolicy.h>. They are part of the kernel ABI
+ */
+static const int MEMORY_POLICY_BIND = 2;
+static const int MEMORY_POLICY_INTERLEAVE = 3;
+static const unsigned int MEMORY_POLICY_MOVE = 1 << 1;
+
+/**
+ * pages whose node move_pages asks for in each call
+ */
+static const std::size_t PAGES_PER_QUERY = 4096;
+
+NumaPolicy parseNumaPolicy(const std::string& name) {
+    if (name == "none") {
+        return NumaPolicy::NONE;
+    } else if (name == "interleave") {
+        return NumaPolicy::INTERLEAVE;
+    } else if (name == "local") {
+        return NumaPolicy::LOCAL;
+    } else if (name == "firstTouchParallel") {
+        return NumaPolicy::FIRST_TOUCH_PARALLEL;
+    }
+    throw std::domain_error{"invalid numa policy " + name + ": it needs to be none, interleave, local or firstTouchParallel"};
+}
+
+NumaPlacement::NumaPlacement(NumaPolicy policy, const MachineTopology& topology, const std::vector<int>& allowedCpus, int currentCpu) :
+        policy{policy}, nodes{}, cpus{} {
+    int localNode = -1;
+    for (auto& location : topology.cpus) {
+        if (std::find(allowedCpus.begin(), allowedCpus.end(), location.cpu) == allowedCpus.end()) {
+            continue;
+        }
+        this->cpus[location.node].push_back(location.cpu);
+        if (location.cpu == currentCpu) {
+            localNode = location.node;
+        }
+    }
+    if (this->cpus.empty()) {
+        // a topology we couldn't probe: everything is on node 0
+        this->cpus[0] = allowedCpus;
+    }
+    if (localNode < 0) {
+        localNode = this->cpus.begin()->first;
+    }
+    this->nodes.push_back(localNode);
+    for (auto& node : this->cpus) {
+        if (node.first != localNode) {
+            this->nodes.push_back(node.first);
+        }
+    }
+}
+
+NumaPolicy NumaPlacement::getPolicy() const {
+    return this->policy;
+}
+
+const std::vector<int>& NumaPlacement::getNodes() const {
+    return this->nodes;
+}
+
+std::vector<int> NumaPlacement::getChunkNodes(std::size_t chunks) const {
+    std::vector<int> result(chunks, -1);
+    for (std::size_t i=0; i<chunks; ++i) {
+        switch (this->policy) {
+        case NumaPolicy::LOCAL:
+            result[i] = this->nodes[0];
+            break;
+        case NumaPolicy::FIRST_TOUCH_PARALLEL:
+            // consecutive chunks on the same node, so that each node gets a contiguous part of the buffer
+            result[i] = this->nodes[i * this->nodes.size() / chunks];
+            break;
+        default:
+            break;
+        }
+    }
+    return result;
+}
+
+std::vector<int> NumaPlacement::getCallerCpus() const {
+    if (this->policy == NumaPolicy::LOCAL || this->policy == NumaPolicy::FIRST_TOUCH_PARALLEL) {
+        return this->getNodeCpus(this->nodes[0]);
+    }
+    return std::vector<int>{};
+}
+
+std::vector<std::vector<int>> NumaPlacement::getWorkerCpus(std::size_t chunks) const {
+    std::vector<std::vector<int>> result{};
+    std::vector<int> chunkNodes = this->getChunkNodes(chunks);
+    for (std::size_t i=1; i<chunks; ++i) {
+        result.push_back(chunkNodes[i] < 0 ? std::vector<int>{} : this->getNodeCpus(chunkNodes[i]));
+    }
+    return result;
+}
+
+std::vector<int> NumaPlacement::getNodeCpus(int node) const {
+    auto it = this->cpus.find(node);
+    return it == this->cpus.end() ? std::vector<int>{} : it->second;
+}
+
+void NumaPlacement::place(std::vector<int>& buffer, const std::vector<std::pair<std::size_t, std::size_t>>& chunks) const {
+    if (this->policy == NumaPolicy::NONE || buffer.empty()) {
+        return;
+    }
+    if (this->policy == NumaPolicy::INTERLEAVE) {
+        this->bind(buffer.data(), buffer.size() * sizeof(int), MEMORY_POLICY_INTERLEAVE, this->nodes);
+        return;
+    }
+    std::vector<int> chunkNodes = this->getChunkNodes(chunks.size());
+    for (std::size_t i=0; i<chunks.size(); ++i) {
+        // chunks on the same node are bound together
+        std::size_t last = i;
+        while (last + 1 < chunks.size() && chunkNodes[last + 1] == chunkNodes[i]) {
+            ++last;
+        }
+        std::size_t end = std::min(chunks[last].second, buffer.size());
+        if (chunks[i].first < end) {
+            this->bind(buffer.data() + chunks[i].first, (end - chunks[i].first) * sizeof(int), MEMORY_POLICY_BIND, std::vector<int>{chunkNodes[i]});
+        }
+        i = last;
+    }
+}
+
+void NumaPlacement::bind(const void* data, std::size_t bytes, int mode, const std::vector<int>& nodes) const {
+    const std::size_t bitsPerWord = 8 * sizeof(unsigned long);
+    int maxNode = *std::max_element(nodes.begin(), nodes.end());
+    std::vector<unsigned long> mask(maxNode / bitsPerWord + 1, 0);
+    for (int node : nodes) {
+        mask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+    }
+    // a page shared with the previous chunk goes with this one: chunks are bound in order
+    uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t start = reinterpret_cast<uintptr_t>(data) & ~(pageSize - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes + pageSize - 1) & ~(pageSize - 1);
+    // the kernel wants the number of bits of the mask plus one
+    long result = syscall(SYS_mbind, start, end - start, mode, mask.data(), mask.size() * bitsPerWord + 1, MEMORY_POLICY_MOVE);
+    if (result != 0) {
+        throw std::domain_error{std::string{"can't place the sorted buffer on its numa nodes: "} + strerror(errno)};
+    }
+}
+
+ThreadAffinityGuard::ThreadAffinityGuard(const std::vector<int>& cpus) : pinned{false} {
+    CPU_ZERO(&this->previous);
+    if (cpus.empty()) {
+        return;
+    }
+    if (sched_getaffinity(0, sizeof(this->previous), &this->previous) != 0) {
+        throw std::domain_error{"can't read the affinity of the sorting thread"};
+    }
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &mask);
+    }
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+        throw std::domain_error{"can't pin the sorting thread on its numa node"};
+    }
+    this->pinned = true;
+}
+
+ThreadAffinityGuard::~ThreadAffinityGuard() {
+    if (this->pinned) {
+        sched_setaffinity(0, sizeof(this->previous), &this->previous);
+    }
+}
+
+std::map<int, long> countPagesPerNode(const void* data, std::size_t bytes) {
+    std::map<int, long> result{};
+    uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t start = reinterpret_cast<uintptr_t>(data) & ~(pageSize - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes + pageSize - 1) & ~(pageSize - 1);
+    std::vector<void*> pages{};
+    std::vector<int> status{};
+    for (uintptr_t page=start; page<end; ) {
+        pages.clear();
+        for (; page<end && pages.size()<PAGES_PER_QUERY; page+=pageSize) {
+            pages.push_back(reinterpret_cast<void*>(page));
+        }
+        status.assign(pages.size(), 0);
+        // without target nodes, move_pages only tells where each page is
+        if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+            return result;
+        }
+        for (int node : status) {
+            // negative statuses are errors, as -ENOENT for pages never touched
+            if (node >= 0) {
+                ++result[node];
+            }
+        }
+    }
+    return result;
+}
+
+std::map<int, NumaNodeCounters> readNumaCounters(const std::string& sysfsNodeRoot) {
+    std::map<int, NumaNodeCounters> result{};
+    DIR* dir = opendir(sysfsNodeRoot.c_str());
+    if (dir == nullptr) {
+        return result;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name{entry->d_name};
+        if (name.compare(0, 4, "node") != 0 || name.size() == 4) {
+            continue;
+        }
+        char* end;
+        long node = strtol(name.c_str() + 4, &end, 10);
+        if (*end != '\0') {
+            continue;
+        }
+        std::ifstream numastat{sysfsNodeRoot + "/" + name + "/numastat"};
+        if (!numastat) {
+            continue;
+        }
+        NumaNodeCounters counters{0, 0};
+        std::string key;
+        long value;
+        while (numastat >> key >> value) {
+            if (key == "local_node") {
+                counters.localNode = value;
+            } else if (key == "other_node") {
+                counters.otherNode = value;
+            }
+        }
+        result[static_cast<int>(node)] = counters;
+    }
+    closedir(dir);
+    return result;
+}
+
+void writeNumaReport(FILE* file, const std::map<int, long>& pages, const std::map<int, NumaNodeCounters>& before, const std::map<int, NumaNodeCounters>& after, double sortSeconds, long runs) {
+    long pageSize = sysconf(_SC_PAGESIZE);
+    std::map<int, bool> nodes{};
+    for (auto& node : pages) {
+        nodes[node.first] = true;
+    }
+    for (auto& node : after) {
+        nodes[node.first] = true;
+    }
+    fprintf(file, "node,pages,bytes,bytesPerSecond,localAllocations,remoteAllocations\n");
+    for (auto& node : nodes) {
+        auto nodePages = pages.find(node.first);
+        long count = nodePages == pages.end() ? 0 : nodePages->second;
+        double bytes = static_cast<double>(count) * pageSize;
+        double bytesPerSecond = sortSeconds > 0 ? bytes * runs / sortSeconds : 0;
+        long local = 0;
+        long remote = 0;
+        auto first = before.find(node.first);
+        auto last = after.find(node.first);
+        if (first != before.end() && last != after.end()) {
+            local = last->second.localNode - first->second.localNode;
+            remote = last->second.otherNode - first->second.otherNode;
+        }
+        fprintf(file, "%d,%ld,%.0f,%.0f,%ld,%ld\n", node.first, count, bytes, bytesPerSecond, local, remote);
+    }
+}
@@ -0,0 +1,150 @@
+#include "RegressionGate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+static std::vector<std::string> splitCsvLine(const std::string& line) {
+    std::vector<std::string> result{};
+    std::stringstream ss{line};
+    std::string cell;
+    while (std::getline(ss, cell, ',')) {
+        result.push_back(cell);
+    }
+    return result;
+}
+
+Baseline loadBaseline(const std::string& fileName) {
+    std::ifstream file{fileName};
+    if (!file) {
+        throw std::domain_error{"can't open baseline file"};
+    }
+    std::string line;
+    if (!std::getline(file, line)) {
+        throw std::domain_error{"baseline file is empty"};
+    }
+    std::vector<std::string> header = splitCsvLine(line);
+    auto time = std::find(header.begin(), header.end(), std::string{"time"});
+    auto p50 = std::find(header.begin(), header.end(), std::string{"p50"});
+    if (time == header.end() && p50 == header.end()) {
+        throw std::domain_error{"baseline file has neither a time nor a p50 column"};
+    }
+    std::size_t column = (time != header.end()) ? (time - header.begin()) : (p50 - header.begin());
+
+    std::vector<double> values{};
+    while (std::getline(file, line)) {
+        std::vector<std::string> cells = splitCsvLine(line);
+        if (cells.size() <= column) {
+            continue;
+        }
+        values.push_back(strtod(cells[column].c_str(), nullptr));
+    }
+    if (values.empty()) {
+        throw std::domain_error{"baseline file has no data"};
+    }
+
+    Baseline result;
+    if (time != header.end()) {
+        result.samples = values;
+        result.median = computeMedian(values);
+    } else {
+        result.median = values[0];
+    }
+    return result;
+}
+
+double parseThreshold(const std::string& threshold) {
+    std::string number{threshold};
+    bool percentage = !number.empty() && number.back() == '%';
+    if (percentage) {
+        number.pop_back();
+    }
+    char* end;
+    double result = strtod(number.c_str(), &end);
+    if (number.empty() || *end != '\0' || result < 0) {
+        throw std::domain_error{"invalid threshold"};
+    }
+    return percentage ? result / 100 : result;
+}
+
+double computeMedian(std::vector<double> samples) {
+    if (samples.empty()) {
+        return 0;
+    }
+    std::size_t middle = samples.size() / 2;
+    std::nth_element(samples.begin(), samples.begin() + middle, samples.end());
+    double result = samples[middle];
+    if ((samples.size() % 2) == 0) {
+        result = (result + *std::max_element(samples.begin(), samples.begin() + middle)) / 2;
+    }
+    return result;
+}
+
+double mannWhitneyUGreaterPValue(const std::vector<double>& current, const std::vector<double>& baseline) {
+    double n1 = current.size();
+    double n2 = baseline.size();
+    if (current.empty() || baseline.empty()) {
+        return 1;
+    }
+    // (value, true if it belongs to current)
+    std::vector<std::pair<double, bool>> all{};
+    all.reserve(current.size() + baseline.size());
+    for (double x : current) {
+        all.push_back(std::make_pair(x, true));
+    }
+    for (double x : baseline) {
+        all.push_back(std::make_pair(x, false));
+    }
+    std::sort(all.begin(), all.end());
+
+    // sum of the ranks of current, tied values get the average of their ranks
+    double rankSum = 0;
+    double tieCorrection = 0;
+    for (std::size_t i=0; i<all.size(); ) {
+        std::size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) {
+            ++j;
+        }
+        double ties = j - i;
+        double averageRank = (i + 1 + j) / 2.0;
+        for (std::size_t k=i; k<j; ++k) {
+            if (all[k].second) {
+                rankSum += averageRank;
+            }
+        }
+        tieCorrection += ties * ties * ties - ties;
+        i = j;
+    }
+
+    double n = n1 + n2;
+    double u = rankSum - n1 * (n1 + 1) / 2;
+    double mean = n1 * n2 / 2;
+    double variance = (n1 * n2 / 12) * ((n + 1) - tieCorrection / (n * (n - 1)));
+    if (variance <= 0) {
+        // every value is the same
+        return 1;
+    }
+    double z = (u - mean - 0.5) / std::sqrt(variance);
+    // 1 - Phi(z)
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+RegressionReport checkRegression(const Baseline& baseline, const std::vector<double>& current, double threshold, double significance) {
+    RegressionReport result;
+    result.baselineMedian = baseline.median;
+    result.currentMedian = computeMedian(current);
+    result.relativeChange = (baseline.median > 0) ? (result.currentMedian - baseline.median) / baseline.median : 0;
+    result.pValue = baseline.samples.empty() ? -1 : mannWhitneyUGreaterPValue(current, baseline.samples);
+    result.regression = result.relativeChange > threshold && (result.pValue < 0 || result.pValue < significance);
+    return result;
+}
+
+void writeRegressionReport(FILE* f, const RegressionReport& report) {
+    fprintf(f, "baselineMedian,currentMedian,relativeChange,pValue,regression\n");
+    fprintf(f, "%.3f,%.3f,%.4f,%.6g,%d\n",
+        report.baselineMedian, report.currentMedian, report.relativeChange, report.pValue, report.regression ? 1 : 0
+    );
+}
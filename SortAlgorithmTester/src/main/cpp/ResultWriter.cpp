@@ -0,0 +1,450 @@
+#include "ResultWriter.hpp"
+
+#include "CompressedFile.hpp"
+#include "Json.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * rows transposed at once by the columnar writers
+ */
+static const std::size_t BLOCK_SIZE = 4096;
+
+/**
+ * size of the header of the binary and shared memory formats. The columns start after it
+ */
+static const uint64_t BINARY_HEADER_SIZE = 4096;
+
+/**
+ * offsets of the fields in the header of the shared memory segment
+ */
+static const std::size_t SHM_ROWS_OFFSET = 8;
+static const std::size_t SHM_COMPLETE_OFFSET = 16;
+static const std::size_t SHM_DOCUMENT_LENGTH_OFFSET = 24;
+static const std::size_t SHM_DOCUMENT_OFFSET = 32;
+
+const char* getRunStatusName(RunStatus status) {
+    switch (status) {
+    case RunStatus::OK: return "ok";
+    case RunStatus::TIMEOUT: return "timeout";
+    }
+    return "unknown";
+}
+
+const std::vector<std::string>& getRunRecordColumnNames() {
+    static const std::vector<std::string> names{
+        "run", "time", "voluntaryContextSwitches", "involuntaryContextSwitches", "cpuMigrations", "runQueueDelay",
+        "preempted", "validationTime", "status"
+    };
+    return names;
+}
+
+int64_t getRunRecordIntegerColumn(const RunRecord& record, int column) {
+    switch (column) {
+    case 0: return record.run;
+    case 1: return record.time;
+    case 2: return record.voluntaryContextSwitches;
+    case 3: return record.involuntaryContextSwitches;
+    case 4: return record.cpuMigrations;
+    case 5: return record.runQueueDelay;
+    case 6: return record.preempted ? 1 : 0;
+    case 7: return record.validationTime;
+    }
+    throw std::domain_error{"invalid column"};
+}
+
+std::vector<uint64_t> getColumnarLayout(std::size_t capacity, uint64_t start, uint64_t& end) {
+    std::vector<uint64_t> result{};
+    // integer columns are int64, status is uint8. Each column starts on a cache line
+    uint64_t offset = start;
+    for (int column=0; column<RUN_RECORD_INTEGER_COLUMNS; ++column) {
+        result.push_back(offset);
+        offset += (capacity * sizeof(int64_t) + 63) & ~static_cast<uint64_t>(63);
+    }
+    result.push_back(offset);
+    end = offset + capacity;
+    return result;
+}
+
+JsonValue describeColumnarLayout(const std::vector<uint64_t>& offsets) {
+    JsonValue columns = JsonValue::array();
+    const std::vector<std::string>& names = getRunRecordColumnNames();
+    for (int column=0; column<RUN_RECORD_INTEGER_COLUMNS; ++column) {
+        columns.push(JsonValue::object()
+            .set("name", names[column])
+            .set("dtype", "<i8")
+            .set("offset", static_cast<unsigned long>(offsets[column]))
+        );
+    }
+    columns.push(JsonValue::object()
+        .set("name", names[RUN_RECORD_INTEGER_COLUMNS])
+        .set("dtype", "|u1")
+        .set("offset", static_cast<unsigned long>(offsets[RUN_RECORD_INTEGER_COLUMNS]))
+        .set("categories", JsonValue::array().push(getRunStatusName(RunStatus::OK)).push(getRunStatusName(RunStatus::TIMEOUT)))
+    );
+    return columns;
+}
+
+CsvResultWriter::CsvResultWriter(const std::string& fileName) : CsvResultWriter{fopen(fileName.c_str(), "w")} {
+}
+
+CsvResultWriter::CsvResultWriter(FILE* file) : file{file} {
+    if (this->file == NULL) {
+        throw std::domain_error{"can't open file"};
+    }
+    fprintf(this->file, "run,time,voluntaryContextSwitches,involuntaryContextSwitches,cpuMigrations,runQueueDelay,preempted,validationTime,status\n");
+}
+
+CsvResultWriter::~CsvResultWriter() {
+    this->close();
+}
+
+void CsvResultWriter::write(const RunRecord& record) {
+    fprintf(this->file, "%ld,%ld,%ld,%ld,%ld,%ld,%d,%ld,%s\n",
+        record.run, record.time,
+        record.voluntaryContextSwitches, record.involuntaryContextSwitches,
+        record.cpuMigrations, record.runQueueDelay,
+        record.preempted ? 1 : 0,
+        record.validationTime,
+        getRunStatusName(record.status)
+    );
+}
+
+void CsvResultWriter::close() {
+    if (this->file != NULL) {
+        fclose(this->file);
+        this->file = NULL;
+    }
+}
+
+JsonlResultWriter::JsonlResultWriter(const std::string& fileName, const JsonValue& metadata) :
+        JsonlResultWriter{fopen(fileName.c_str(), "w"), metadata} {
+}
+
+JsonlResultWriter::JsonlResultWriter(FILE* file, const JsonValue& metadata) : file{file}, metadata{} {
+    if (this->file == NULL) {
+        throw std::domain_error{"can't open file"};
+    }
+    if (!metadata.isObject()) {
+        fclose(this->file);
+        throw std::domain_error{"metadata needs to be a json object"};
+    }
+    std::string dumped = metadata.dump();
+    this->metadata = dumped.substr(1, dumped.size() - 2);
+}
+
+JsonlResultWriter::~JsonlResultWriter() {
+    this->close();
+}
+
+void JsonlResultWriter::write(const RunRecord& record) {
+    fprintf(this->file, "{\"run\":%ld,\"time\":%ld,\"voluntaryContextSwitches\":%ld,\"involuntaryContextSwitches\":%ld,\"cpuMigrations\":%ld,\"runQueueDelay\":%ld,\"preempted\":%s,\"validationTime\":%ld,\"status\":\"%s\"%s%s}\n",
+        record.run, record.time,
+        record.voluntaryContextSwitches, record.involuntaryContextSwitches,
+        record.cpuMigrations, record.runQueueDelay,
+        record.preempted ? "true" : "false",
+        record.validationTime,
+        getRunStatusName(record.status),
+        this->metadata.empty() ? "" : ",", this->metadata.c_str()
+    );
+}
+
+void JsonlResultWriter::close() {
+    if (this->file != NULL) {
+        fclose(this->file);
+        this->file = NULL;
+    }
+}
+
+BlockResultWriter::BlockResultWriter(std::size_t blockSize) : blockSize{blockSize}, block{} {
+    this->block.reserve(blockSize);
+}
+
+void BlockResultWriter::write(const RunRecord& record) {
+    this->block.push_back(record);
+    if (this->block.size() >= this->blockSize) {
+        this->flush();
+    }
+}
+
+void BlockResultWriter::flush() {
+    if (!this->block.empty()) {
+        this->flushBlock(this->block);
+        this->block.clear();
+    }
+}
+
+BinaryResultWriter::BinaryResultWriter(const std::string& fileName, std::size_t capacity) :
+        BlockResultWriter{BLOCK_SIZE}, fd{-1}, capacity{capacity}, rows{0}, columnOffsets{} {
+    this->fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (this->fd < 0) {
+        throw std::domain_error{"can't open file"};
+    }
+    try {
+        uint64_t size;
+        this->columnOffsets = getColumnarLayout(capacity, BINARY_HEADER_SIZE, size);
+        if (ftruncate(this->fd, size) != 0) {
+            throw std::domain_error{std::string{"can't reserve the columns: "} + strerror(errno)};
+        }
+        // a file truncated by a crash still has a valid (empty) header
+        this->writeHeader();
+    } catch (...) {
+        // the destructor of a writer which failed to be built doesn't run
+        ::close(this->fd);
+        this->fd = -1;
+        throw;
+    }
+}
+
+BinaryResultWriter::~BinaryResultWriter() {
+    this->close();
+}
+
+void BinaryResultWriter::writeAt(const void* data, std::size_t size, uint64_t offset) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(this->fd, bytes, size, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::domain_error{std::string{"can't write the results: "} + strerror(errno)};
+        }
+        bytes += written;
+        size -= written;
+        offset += written;
+    }
+}
+
+void BinaryResultWriter::writeHeader() {
+    std::string document = JsonValue::object()
+        .set("rows", static_cast<unsigned long>(this->rows))
+        .set("columns", describeColumnarLayout(this->columnOffsets))
+        .dump();
+
+    std::string header{"SORTCOL1"};
+    uint64_t length = document.size();
+    header.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    header.append(document);
+    if (header.size() > BINARY_HEADER_SIZE) {
+        throw std::domain_error{"binary header too long"};
+    }
+    header.resize(BINARY_HEADER_SIZE, ' ');
+    this->writeAt(header.data(), header.size(), 0);
+}
+
+void BinaryResultWriter::flushBlock(const std::vector<RunRecord>& block) {
+    if (this->rows + block.size() > this->capacity) {
+        throw std::domain_error{"more runs than the binary result file can hold"};
+    }
+    std::vector<int64_t> integers(block.size());
+    for (int column=0; column<RUN_RECORD_INTEGER_COLUMNS; ++column) {
+        for (std::size_t i=0; i<block.size(); ++i) {
+            integers[i] = getRunRecordIntegerColumn(block[i], column);
+        }
+        this->writeAt(integers.data(), integers.size() * sizeof(int64_t), this->columnOffsets[column] + this->rows * sizeof(int64_t));
+    }
+    std::vector<unsigned char> statuses(block.size());
+    for (std::size_t i=0; i<block.size(); ++i) {
+        statuses[i] = static_cast<unsigned char>(block[i].status);
+    }
+    this->writeAt(statuses.data(), statuses.size(), this->columnOffsets[RUN_RECORD_INTEGER_COLUMNS] + this->rows);
+    this->rows += block.size();
+}
+
+void BinaryResultWriter::close() {
+    if (this->fd < 0) {
+        return;
+    }
+    try {
+        this->flush();
+        this->writeHeader();
+    } catch (...) {
+        // the destructor must not try again
+        ::close(this->fd);
+        this->fd = -1;
+        throw;
+    }
+    ::close(this->fd);
+    this->fd = -1;
+}
+
+ShmResultWriter::ShmResultWriter(const std::string& name, std::size_t capacity) :
+        memory{nullptr}, size{0}, capacity{capacity}, rows{0}, columnOffsets{} {
+    std::string segment = (!name.empty() && name[0] == '/') ? name : "/" + name;
+    uint64_t size;
+    this->columnOffsets = getColumnarLayout(capacity, BINARY_HEADER_SIZE, size);
+    this->size = size;
+    // checked before creating anything: nothing is left to clean up
+    std::string document = JsonValue::object()
+        .set("capacity", static_cast<unsigned long>(capacity))
+        .set("columns", describeColumnarLayout(this->columnOffsets))
+        .dump();
+    if (SHM_DOCUMENT_OFFSET + document.size() > BINARY_HEADER_SIZE) {
+        throw std::domain_error{"shared memory header too long"};
+    }
+
+    int fd = shm_open(segment.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        throw std::domain_error{"can't open shared memory segment " + segment + ": " + strerror(errno)};
+    }
+    // the segment we created would outlive us: a failed writer removes it
+    if (ftruncate(fd, this->size) != 0) {
+        std::string error = strerror(errno);
+        ::close(fd);
+        shm_unlink(segment.c_str());
+        throw std::domain_error{"can't reserve the columns: " + error};
+    }
+    void* memory = mmap(nullptr, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    std::string error = strerror(errno);
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        shm_unlink(segment.c_str());
+        throw std::domain_error{"can't map the shared memory segment: " + error};
+    }
+    this->memory = static_cast<char*>(memory);
+
+    memcpy(this->memory, "SORTSHM1", 8);
+    uint64_t length = document.size();
+    memcpy(this->memory + SHM_DOCUMENT_LENGTH_OFFSET, &length, sizeof(length));
+    memcpy(this->memory + SHM_DOCUMENT_OFFSET, document.data(), document.size());
+}
+
+ShmResultWriter::~ShmResultWriter() {
+    this->close();
+}
+
+void ShmResultWriter::write(const RunRecord& record) {
+    if (this->rows >= this->capacity) {
+        throw std::domain_error{"more runs than the shared memory segment can hold"};
+    }
+    for (int column=0; column<RUN_RECORD_INTEGER_COLUMNS; ++column) {
+        int64_t value = getRunRecordIntegerColumn(record, column);
+        memcpy(this->memory + this->columnOffsets[column] + this->rows * sizeof(int64_t), &value, sizeof(value));
+    }
+    this->memory[this->columnOffsets[RUN_RECORD_INTEGER_COLUMNS] + this->rows] = static_cast<char>(record.status);
+    ++this->rows;
+    // a reader polling the segment sees the counter only after the values
+    __atomic_store_n(reinterpret_cast<uint64_t*>(this->memory + SHM_ROWS_OFFSET), static_cast<uint64_t>(this->rows), __ATOMIC_RELEASE);
+}
+
+void ShmResultWriter::close() {
+    if (this->memory == nullptr) {
+        return;
+    }
+    __atomic_store_n(reinterpret_cast<uint64_t*>(this->memory + SHM_COMPLETE_OFFSET), static_cast<uint64_t>(1), __ATOMIC_RELEASE);
+    munmap(this->memory, this->size);
+    this->memory = nullptr;
+}
+
+CompressedResultWriter::CompressedResultWriter(CompressedFile* file, ResultWriter* writer, std::size_t runsPerChunk) :
+        file{file}, writer{writer}, runsPerChunk{runsPerChunk}, runsInChunk{0} {
+    // what the format wrote so far is the preamble of every chunk
+    this->file->endChunk(0);
+}
+
+CompressedResultWriter::~CompressedResultWriter() {
+    try {
+        this->close();
+    } catch (...) {
+        // nobody to report it to
+    }
+    delete this->writer;
+    delete this->file;
+}
+
+void CompressedResultWriter::write(const RunRecord& record) {
+    this->writer->write(record);
+    if (++this->runsInChunk == this->runsPerChunk) {
+        this->file->endChunk(this->runsInChunk);
+        this->runsInChunk = 0;
+    }
+}
+
+void CompressedResultWriter::close() {
+    if (this->file->getStream() == nullptr) {
+        // the format closes the stream, hence close has already been called
+        return;
+    }
+    try {
+        this->writer->close();
+        if (this->runsInChunk > 0) {
+            this->file->endChunk(this->runsInChunk);
+            this->runsInChunk = 0;
+        }
+        this->file->close();
+    } catch (...) {
+        this->file->close();
+        throw;
+    }
+}
+
+const std::vector<std::string>& getResultFormatNames() {
+    static const std::vector<std::string> names{"csv", "jsonl", "binary", "arrow"};
+    return names;
+}
+
+/**
+ * @param format csv, jsonl or arrow: the formats written sequentially
+ */
+static ResultWriter* createCompressedResultWriter(const std::string& format, const std::string& fileName, const std::string& compression, const JsonValue& metadata) {
+    std::unique_ptr<CompressedFile> file{new CompressedFile{
+        fileName + getCompressionExtension(compression), compression,
+        JsonValue::object().set("format", format).set("runsPerChunk", static_cast<unsigned long>(BLOCK_SIZE))
+    }};
+    std::unique_ptr<ResultWriter> writer{};
+    if (format == std::string{"csv"}) {
+        writer.reset(new CsvResultWriter{file->getStream()});
+    } else if (format == std::string{"jsonl"}) {
+        writer.reset(new JsonlResultWriter{file->getStream(), metadata});
+    } else if (format == std::string{"arrow"}) {
+        // arrow writes a record batch every BLOCK_SIZE runs, hence each chunk has whole record batches
+        writer.reset(new ArrowResultWriter{file->getStream()});
+    } else {
+        throw std::domain_error{format + " results can't be compressed"};
+    }
+    ResultWriter* result = new CompressedResultWriter{file.get(), writer.get(), BLOCK_SIZE};
+    file.release();
+    writer.release();
+    return result;
+}
+
+std::string getResultFileSuffix(const std::string& format, const std::string& compression) {
+    std::string result{"kind:type=main|."};
+    if (format == std::string{"binary"}) {
+        result.append("bin");
+    } else if (format == std::string{"csv"} || format == std::string{"jsonl"} || format == std::string{"arrow"}) {
+        result.append(format);
+    } else {
+        throw std::domain_error{"invalid output format!"};
+    }
+    if (compression != std::string{"none"}) {
+        result.append(getCompressionExtension(compression));
+    }
+    return result;
+}
+
+ResultWriter* createResultWriter(const std::string& format, const std::string& outputTemplate, std::size_t expectedRuns, const JsonValue& metadata, const std::string& compression) {
+    if (compression != std::string{"none"}) {
+        if (format == std::string{"binary"}) {
+            throw std::domain_error{"binary results are memory mapped: they can't be compressed"};
+        }
+        return createCompressedResultWriter(format, outputTemplate + getResultFileSuffix(format), compression, metadata);
+    }
+    std::string fileName = outputTemplate + getResultFileSuffix(format);
+    if (format == std::string{"csv"}) {
+        return new CsvResultWriter{fileName};
+    } else if (format == std::string{"jsonl"}) {
+        return new JsonlResultWriter{fileName, metadata};
+    } else if (format == std::string{"binary"}) {
+        return new BinaryResultWriter{fileName, expectedRuns};
+    } else {
+        return new ArrowResultWriter{fileName};
+    }
+}
@@ -0,0 +1,87 @@
+#include "RunMetadata.hpp"
+
+#include "BuildInfo.hpp"
+
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sched.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+JsonValue getBuildMetadata() {
+    return JsonValue::object()
+        .set("gitRevision", BUILD_GIT_REVISION)
+        .set("buildType", BUILD_TYPE)
+        .set("compiler", BUILD_COMPILER)
+        .set("flags", BUILD_CXX_FLAGS);
+}
+
+/**
+ * @return the value of the first "key : value" line of /proc/cpuinfo with the given key, in the section of the
+ *  given processor (or in the first section, if cpu is -1). Empty if there's no such line
+ */
+static std::string readCpuInfo(const std::string& procRoot, const std::string& key, int cpu) {
+    std::ifstream file{procRoot + "/cpuinfo"};
+    std::string line;
+    int processor = -1;
+    while (std::getline(file, line)) {
+        std::size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string name = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+        std::string value = colon + 2 <= line.size() ? line.substr(colon + 2) : std::string{};
+        if (name == "processor") {
+            processor = std::atoi(value.c_str());
+        } else if (name == key && (cpu < 0 || processor == cpu)) {
+            return value;
+        }
+    }
+    return std::string{};
+}
+
+JsonValue getHostMetadata(const std::string& procRoot, const std::string& sysfsCpuRoot) {
+    JsonValue result = JsonValue::object();
+
+    char hostName[256] = {0};
+    if (gethostname(hostName, sizeof(hostName) - 1) == 0) {
+        result.set("hostName", hostName);
+    } else {
+        result.set("hostName", JsonValue{});
+    }
+
+    struct utsname system;
+    if (uname(&system) == 0) {
+        result.set("kernel", std::string{system.sysname} + " " + system.release + " " + system.version + " " + system.machine);
+    } else {
+        result.set("kernel", JsonValue{});
+    }
+
+    std::string model = readCpuInfo(procRoot, "model name", -1);
+    result.set("cpuModel", model.empty() ? JsonValue{} : JsonValue{model});
+
+    // cpufreq knows the frequency better than cpuinfo, but it is not available on every machine (e.g. in VMs)
+    int cpu = sched_getcpu();
+    JsonValue frequency{};
+    long kiloHertz = 0;
+    std::ifstream scaling{sysfsCpuRoot + "/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq"};
+    if (scaling >> kiloHertz) {
+        frequency = JsonValue{kiloHertz / 1000.0};
+    } else {
+        std::string megaHertz = readCpuInfo(procRoot, "cpu MHz", cpu);
+        if (!megaHertz.empty()) {
+            frequency = JsonValue{std::atof(megaHertz.c_str())};
+        }
+    }
+    result.set("cpu", cpu);
+    result.set("cpuFrequency", frequency);
+
+    char timestamp[32];
+    std::time_t now = std::time(nullptr);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    result.set("timestamp", timestamp);
+    return result;
+}
@@ -0,0 +1,83 @@
+#include "RunWatchdog.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+
+/**
+ * the watchdog receiving SIGALRM, if any
+ */
+static std::atomic<RunWatchdog*> activeWatchdog{nullptr};
+
+static void onSigalrm(int signal) {
+    int savedErrno = errno;
+    RunWatchdog* watchdog = activeWatchdog.load();
+    if (watchdog != nullptr) {
+        watchdog->onTimeout();
+    }
+    errno = savedErrno;
+}
+
+RunWatchdog::RunWatchdog(double timeout) :
+        timeoutMicroseconds{static_cast<long>(timeout * 1e6)},
+        tid{static_cast<pid_t>(syscall(SYS_gettid))}, running{0} {
+    if (this->timeoutMicroseconds <= 0) {
+        throw std::domain_error{"run timeout needs to be positive"};
+    }
+    RunWatchdog* expected = nullptr;
+    if (!activeWatchdog.compare_exchange_strong(expected, this)) {
+        throw std::domain_error{"only one watchdog can exist at a time"};
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = onSigalrm;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGALRM, &action, &this->previousAction);
+}
+
+RunWatchdog::~RunWatchdog() {
+    this->setTimer(0);
+    sigaction(SIGALRM, &this->previousAction, nullptr);
+    activeWatchdog.store(nullptr);
+}
+
+void RunWatchdog::setTimer(long microseconds) {
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    timer.it_value.tv_sec = microseconds / 1000000;
+    timer.it_value.tv_usec = microseconds % 1000000;
+    setitimer(ITIMER_REAL, &timer, nullptr);
+}
+
+bool RunWatchdog::run(const std::function<void()>& job) {
+    // the mask is saved, so SIGALRM is unblocked again after the jump
+    if (sigsetjmp(this->environment, 1) != 0) {
+        this->running = 0;
+        this->setTimer(0);
+        return false;
+    }
+    this->running = 1;
+    this->setTimer(this->timeoutMicroseconds);
+    job();
+    // disarmed before running is cleared: a late SIGALRM of the timer either finds running at 0 or is never sent
+    this->setTimer(0);
+    this->running = 0;
+    return true;
+}
+
+void RunWatchdog::onTimeout() {
+    if (!this->running) {
+        return;
+    }
+    // SIGALRM is sent to the process, so any thread may receive it: jumping is allowed only in the one running the job
+    if (static_cast<pid_t>(syscall(SYS_gettid)) != this->tid) {
+        syscall(SYS_tgkill, getpid(), this->tid, SIGALRM);
+        return;
+    }
+    siglongjmp(this->environment, 1);
+}
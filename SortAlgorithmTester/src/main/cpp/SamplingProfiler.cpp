@@ -0,0 +1,209 @@
+#include "SamplingProfiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+
+/**
+ * frames backtrace collects per sample where the stack can't be walked by frame pointers, signal handler included
+ */
+static const int MAX_BACKTRACE_FRAMES = 256;
+
+/**
+ * the profiler receiving SIGPROF, if any
+ */
+static std::atomic<SamplingProfiler*> activeProfiler{nullptr};
+
+static void onSigprof(int signal, siginfo_t* info, void* context) {
+    int savedErrno = errno;
+    SamplingProfiler* profiler = activeProfiler.load();
+    if (profiler != nullptr) {
+        profiler->takeSample(context);
+    }
+    errno = savedErrno;
+}
+
+SamplingProfiler::SamplingProfiler(int frequency, std::size_t maxSamples, int maxDepth) :
+        frequency{frequency}, maxSamples{maxSamples}, maxDepth{maxDepth},
+        tid{static_cast<pid_t>(syscall(SYS_gettid))}, stackLow{0}, stackHigh{0},
+        frames(maxSamples * maxDepth, 0), depths(maxSamples, 0), sampleCount{0}, lostSampleCount{0},
+        remainingMicroseconds{0} {
+    if (frequency <= 0 || frequency > 1000000) {
+        throw std::domain_error{"profiler frequency needs to be in (0, 1000000]"};
+    }
+    SamplingProfiler* expected = nullptr;
+    if (!activeProfiler.compare_exchange_strong(expected, this)) {
+        throw std::domain_error{"only one profiler can exist at a time"};
+    }
+    this->remainingMicroseconds = 1000000 / frequency;
+
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+        void* address;
+        size_t size;
+        if (pthread_attr_getstack(&attributes, &address, &size) == 0) {
+            this->stackLow = reinterpret_cast<uintptr_t>(address);
+            this->stackHigh = this->stackLow + size;
+        }
+        pthread_attr_destroy(&attributes);
+    }
+
+    // backtrace loads libgcc the first time it's called: that can't happen inside a signal handler
+    void* warmup[1];
+    backtrace(warmup, 1);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = onSigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &this->previousAction);
+}
+
+SamplingProfiler::~SamplingProfiler() {
+    this->disarm();
+    sigaction(SIGPROF, &this->previousAction, nullptr);
+    activeProfiler.store(nullptr);
+}
+
+void SamplingProfiler::arm() {
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000000 / this->frequency;
+    timer.it_value.tv_sec = this->remainingMicroseconds / 1000000;
+    timer.it_value.tv_usec = this->remainingMicroseconds % 1000000;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+void SamplingProfiler::disarm() {
+    struct itimerval timer;
+    struct itimerval previous;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, &previous);
+    long remaining = previous.it_value.tv_sec * 1000000 + previous.it_value.tv_usec;
+    if (remaining > 0) {
+        this->remainingMicroseconds = remaining;
+    }
+}
+
+void SamplingProfiler::takeSample(void* context) {
+    // ITIMER_PROF signals the process: any thread may receive it
+    if (static_cast<pid_t>(syscall(SYS_gettid)) != this->tid) {
+        return;
+    }
+    if (this->sampleCount >= this->maxSamples) {
+        this->lostSampleCount = this->lostSampleCount + 1;
+        return;
+    }
+    uintptr_t* stack = &this->frames[this->sampleCount * this->maxDepth];
+    int depth = 0;
+#if defined(__x86_64__)
+    const ucontext_t* uc = static_cast<const ucontext_t*>(context);
+    stack[depth++] = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RIP]);
+    uintptr_t fp = static_cast<uintptr_t>(uc->uc_mcontext.gregs[REG_RBP]);
+    // each frame starts with the caller frame pointer, followed by the return address
+    while (depth < this->maxDepth && fp >= this->stackLow && (fp + 2 * sizeof(uintptr_t)) <= this->stackHigh && (fp % sizeof(uintptr_t)) == 0) {
+        const uintptr_t* frame = reinterpret_cast<const uintptr_t*>(fp);
+        uintptr_t returnAddress = frame[1];
+        if (returnAddress == 0) {
+            break;
+        }
+        // the return address points after the call: move inside it so it is attributed to the caller
+        stack[depth++] = returnAddress - 1;
+        if (frame[0] <= fp) {
+            break;
+        }
+        fp = frame[0];
+    }
+#else
+    void* addresses[MAX_BACKTRACE_FRAMES];
+    int found = backtrace(addresses, std::min(this->maxDepth, MAX_BACKTRACE_FRAMES));
+    // skip the signal handler frames
+    for (int i=2; i<found; ++i) {
+        stack[depth++] = reinterpret_cast<uintptr_t>(addresses[i]);
+    }
+#endif
+    this->depths[this->sampleCount] = depth;
+    this->sampleCount = this->sampleCount + 1;
+}
+
+std::size_t SamplingProfiler::getSampleCount() const {
+    return this->sampleCount;
+}
+
+std::size_t SamplingProfiler::getLostSampleCount() const {
+    return this->lostSampleCount;
+}
+
+/**
+ * @return the demangled name of the function containing the address or "module+0xoffset" if it has no symbol.
+ *  Folded stacks use ';' as separator, so it is replaced
+ */
+static std::string symbolize(uintptr_t address) {
+    Dl_info info;
+    std::string result;
+    // info is left uninitialized when dladdr fails
+    bool found = dladdr(reinterpret_cast<void*>(address), &info) != 0;
+    if (found && info.dli_sname != nullptr) {
+        int status;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        if (status == 0 && demangled != nullptr) {
+            result = demangled;
+        } else {
+            result = info.dli_sname;
+        }
+        free(demangled);
+    } else if (found && info.dli_fname != nullptr) {
+        const char* module = strrchr(info.dli_fname, '/');
+        char offset[32];
+        snprintf(offset, sizeof(offset), "+0x%lx", static_cast<unsigned long>(address - reinterpret_cast<uintptr_t>(info.dli_fbase)));
+        result = std::string{module != nullptr ? module + 1 : info.dli_fname} + offset;
+    } else {
+        char unknown[32];
+        snprintf(unknown, sizeof(unknown), "0x%lx", static_cast<unsigned long>(address));
+        result = unknown;
+    }
+    for (auto& c : result) {
+        if (c == ';') {
+            c = '_';
+        }
+    }
+    return result;
+}
+
+void SamplingProfiler::writeFoldedStacks(FILE* f) const {
+    std::map<uintptr_t, std::string> names{};
+    std::map<std::string, std::size_t> stacks{};
+    for (std::size_t sample=0; sample<this->sampleCount; ++sample) {
+        const uintptr_t* stack = &this->frames[sample * this->maxDepth];
+        std::string folded{};
+        for (int i=this->depths[sample] - 1; i>=0; --i) {
+            auto name = names.find(stack[i]);
+            if (name == names.end()) {
+                name = names.insert(std::make_pair(stack[i], symbolize(stack[i]))).first;
+            }
+            if (!folded.empty()) {
+                folded.append(";");
+            }
+            folded.append(name->second);
+        }
+        ++stacks[folded];
+    }
+    for (auto& stack : stacks) {
+        fprintf(f, "%s %lu\n", stack.first.c_str(), static_cast<unsigned long>(stack.second));
+    }
+}
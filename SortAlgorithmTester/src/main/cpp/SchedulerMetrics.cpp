@@ -0,0 +1,132 @@
+#include "SchedulerMetrics.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <string>
+
+bool SchedulerSample::isPreempted() const {
+    return this->involuntaryContextSwitches > 0 || this->cpuMigrations > 0 || this->runQueueDelay > 0;
+}
+
+SchedulerSample operator-(const SchedulerSample& after, const SchedulerSample& before) {
+    SchedulerSample result;
+    result.voluntaryContextSwitches = after.voluntaryContextSwitches - before.voluntaryContextSwitches;
+    result.involuntaryContextSwitches = after.involuntaryContextSwitches - before.involuntaryContextSwitches;
+    result.cpuMigrations = (after.cpuMigrations < 0 || before.cpuMigrations < 0) ? -1 : after.cpuMigrations - before.cpuMigrations;
+    result.runQueueDelay = (after.runQueueDelay < 0 || before.runQueueDelay < 0) ? -1 : after.runQueueDelay - before.runQueueDelay;
+    return result;
+}
+
+/**
+ * read the whole content of a /proc file from the beginning
+ *
+ * @return number of bytes read, -1 on error
+ */
+static ssize_t readProcFile(int fd, char* buffer, size_t size) {
+    ssize_t bytes = pread(fd, buffer, size - 1, 0);
+    if (bytes < 0) {
+        return -1;
+    }
+    buffer[bytes] = '\0';
+    return bytes;
+}
+
+/**
+ * open a /proc file of the calling thread: /proc/self describes the main thread only
+ *
+ * @return the file descriptor, -1 on error
+ */
+static int openThreadProcFile(const char* name) {
+    int fd = open((std::string{"/proc/thread-self/"} + name).c_str(), O_RDONLY);
+    if (fd < 0) {
+        // kernels older than 3.17 have no /proc/thread-self
+        long tid = syscall(SYS_gettid);
+        fd = open(("/proc/self/task/" + std::to_string(tid) + "/" + name).c_str(), O_RDONLY);
+    }
+    return fd;
+}
+
+SchedulerProbe::SchedulerProbe() : migrationsEventFd{-1}, schedFd{-1}, schedstatFd{-1} {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.config = PERF_COUNT_SW_CPU_MIGRATIONS;
+    // migrations are counted by the kernel: we can't exclude it
+    this->migrationsEventFd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    if (this->migrationsEventFd < 0) {
+        // perf is often forbidden inside containers
+        this->migrationsEventFd = -1;
+        this->schedFd = openThreadProcFile("sched");
+    }
+    this->schedstatFd = openThreadProcFile("schedstat");
+}
+
+SchedulerProbe::~SchedulerProbe() {
+    if (this->migrationsEventFd >= 0) {
+        close(this->migrationsEventFd);
+    }
+    if (this->schedFd >= 0) {
+        close(this->schedFd);
+    }
+    if (this->schedstatFd >= 0) {
+        close(this->schedstatFd);
+    }
+}
+
+long SchedulerProbe::readMigrations() const {
+    if (this->migrationsEventFd >= 0) {
+        uint64_t value;
+        if (read(this->migrationsEventFd, &value, sizeof(value)) != sizeof(value)) {
+            return -1;
+        }
+        return static_cast<long>(value);
+    }
+    if (this->schedFd >= 0) {
+        // a line looks like "se.nr_migrations                             :                    3"
+        char buffer[4096];
+        if (readProcFile(this->schedFd, buffer, sizeof(buffer)) < 0) {
+            return -1;
+        }
+        const char* line = strstr(buffer, "se.nr_migrations");
+        if (line == nullptr) {
+            return -1;
+        }
+        const char* colon = strchr(line, ':');
+        if (colon == nullptr) {
+            return -1;
+        }
+        return strtol(colon + 1, nullptr, 10);
+    }
+    return -1;
+}
+
+int64_t SchedulerProbe::readRunQueueDelay() const {
+    if (this->schedstatFd < 0) {
+        return -1;
+    }
+    // content is "<time on cpu> <time waiting on a runqueue> <timeslices run>", times in nanoseconds
+    char buffer[128];
+    if (readProcFile(this->schedstatFd, buffer, sizeof(buffer)) < 0) {
+        return -1;
+    }
+    char* end;
+    strtoull(buffer, &end, 10);
+    return static_cast<int64_t>(strtoull(end, nullptr, 10));
+}
+
+SchedulerSample SchedulerProbe::sample() const {
+    SchedulerSample result;
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    result.voluntaryContextSwitches = usage.ru_nvcsw;
+    result.involuntaryContextSwitches = usage.ru_nivcsw;
+    result.cpuMigrations = this->readMigrations();
+    result.runQueueDelay = this->readRunQueueDelay();
+    return result;
+}
@@ -0,0 +1,31 @@
+#include "ScratchArena.hpp"
+
+#include <stdexcept>
+#include <string>
+
+const std::size_t ScratchArena::ALIGNMENT;
+
+ScratchArena::ScratchArena(PageKind pages) : pages{pages}, memory{}, used{0} {
+}
+
+void ScratchArena::reserve(std::size_t bytes) {
+    this->used = 0;
+    if (this->memory && bytes <= this->getCapacity()) {
+        return;
+    }
+    // the old block goes first: both may not fit
+    this->memory.reset();
+    this->memory.reset(new PageAllocation{this->pages, bytes});
+}
+
+std::size_t ScratchArena::getCapacity() const {
+    return this->memory ? this->memory->getBytes() : 0;
+}
+
+const PageAllocation* ScratchArena::getMemory() const {
+    return this->memory.get();
+}
+
+void ScratchArena::exhausted(std::size_t bytes) const {
+    throw std::domain_error{"scratch arena exhausted: " + std::to_string(bytes) + " bytes needed, " + std::to_string(this->getCapacity() - this->used) + " left"};
+}
@@ -0,0 +1,112 @@
+#include "SequenceGenerators.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+RandomGenerator::RandomGenerator() : shared{true} {
+    memset(this->state, 0, sizeof(this->state));
+    memset(&this->data, 0, sizeof(this->data));
+}
+
+RandomGenerator::RandomGenerator(unsigned int seed) : shared{false} {
+    memset(this->state, 0, sizeof(this->state));
+    // initstate_r needs the state pointer to be null
+    memset(&this->data, 0, sizeof(this->data));
+    // glibc implements rand() as random() on a state of 128 bytes: srand(seed) is initstate_r(seed) on such a state
+    initstate_r(seed, this->state, sizeof(this->state), &this->data);
+}
+
+int RandomGenerator::next() {
+    if (this->shared) {
+        return rand();
+    }
+    int32_t result;
+    random_r(&this->data, &result);
+    return static_cast<int>(result);
+}
+
+int generateRandomNumber(int lb, int ub, bool lbIn, bool ubIn, RandomGenerator& generator) {
+    lb += lbIn ? 0: 1;
+    ub += ubIn ? 1: 0;
+    if (lb > ub) {
+        throw std::domain_error{"cannot generate random number"};
+    }
+    return lb + (generator.next() % (ub - lb));
+}
+
+int generateRandomNumber(int lb, int ub, bool lbIn, bool ubIn) {
+    RandomGenerator generator{};
+    return generateRandomNumber(lb, ub, lbIn, ubIn, generator);
+}
+
+std::vector<int> generateRandomSequence(int size, int lowerBound, int upperBound, RandomGenerator& generator) {
+    std::vector<int> result{};
+    result.reserve(size);
+    for (int i=0; i<size; ++i) {
+        result.push_back(generateRandomNumber(lowerBound, upperBound, true, true, generator));
+    }
+    return result;
+}
+
+std::vector<int> generateRandomSequence(int size, int lowerBound, int upperBound) {
+    RandomGenerator generator{};
+    return generateRandomSequence(size, lowerBound, upperBound, generator);
+}
+
+std::vector<int> generateSameSequence(int size, int lowerBound, int upperBound, RandomGenerator& generator) {
+    std::vector<int> result{};
+    result.reserve(size);
+    int x = generateRandomNumber(lowerBound, upperBound, true, true, generator);
+    for (int i=0; i<size; ++i) {
+        result.push_back(x);
+    }
+    return result;
+}
+
+std::vector<int> generateSameSequence(int size, int lowerBound, int upperBound) {
+    RandomGenerator generator{};
+    return generateSameSequence(size, lowerBound, upperBound, generator);
+}
+
+std::vector<int> generateSortedSequence(int size, int lowerBound, int upperBound) {
+    std::vector<int> result{};
+    result.reserve(size);
+    for (int i=0; i<size; ++i) {
+        result.push_back(lowerBound + i);
+    }
+    return result;
+}
+
+std::vector<int> generateReverseSortedSequence(int size, int lowerBound, int upperBound) {
+    std::vector<int> result{};
+    result.reserve(size);
+    for (int i=0; i<size; ++i) {
+        result.push_back(upperBound - i);
+    }
+    return result;
+}
+
+const std::vector<std::string>& getSequenceTypeNames() {
+    static const std::vector<std::string> names{"RANDOM", "SAME", "SORTED", "REVERSESORTED"};
+    return names;
+}
+
+std::vector<int> generateSequence(const std::string& sequenceType, int size, int lowerBound, int upperBound, RandomGenerator& generator) {
+    if (sequenceType == std::string{"RANDOM"}) {
+        return generateRandomSequence(size, lowerBound, upperBound, generator);
+    } else if (sequenceType == std::string{"SAME"}) {
+        return generateSameSequence(size, lowerBound, upperBound, generator);
+    } else if (sequenceType == std::string{"SORTED"}) {
+        return generateSortedSequence(size, lowerBound, upperBound);
+    } else if (sequenceType == std::string{"REVERSESORTED"}) {
+        return generateReverseSortedSequence(size, lowerBound, upperBound);
+    } else{
+        throw std::domain_error{"invalid type!"};
+    }
+}
+
+std::vector<int> generateSequence(const std::string& sequenceType, int size, int lowerBound, int upperBound) {
+    RandomGenerator generator{};
+    return generateSequence(sequenceType, size, lowerBound, upperBound, generator);
+}
@@ -0,0 +1,176 @@
+#include "SequenceValidator.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * below this number of elements per thread, spawning threads costs more than the check itself
+ */
+static const std::size_t MIN_ELEMENTS_PER_THREAD = 1 << 18;
+
+std::vector<std::pair<std::size_t, std::size_t>> getValidationChunks(std::size_t size, int threads) {
+    std::size_t chunks = std::max<std::size_t>(1, std::min<std::size_t>(std::max(1, threads), size / MIN_ELEMENTS_PER_THREAD));
+    std::size_t chunkSize = size / chunks;
+    std::vector<std::pair<std::size_t, std::size_t>> result{};
+    for (std::size_t i=0; i<chunks; ++i) {
+        std::size_t begin = i * chunkSize;
+        std::size_t end = (i == (chunks - 1)) ? size : begin + chunkSize;
+        result.push_back(std::make_pair(begin, end));
+    }
+    return result;
+}
+
+/**
+ * run job over [0, size) split in contiguous chunks, one per thread. The calling thread takes the first chunk.
+ *
+ * Threads are taken from pool if given, otherwise they are created (and joined) here
+ */
+template <typename RESULT, typename JOB>
+static std::vector<RESULT> runInChunks(std::size_t size, int threads, ThreadPool* pool, JOB job) {
+    std::vector<std::pair<std::size_t, std::size_t>> chunks = getValidationChunks(size, threads);
+    std::vector<RESULT> results(chunks.size());
+    if (chunks.size() == 1) {
+        results[0] = job(0, size);
+        return results;
+    }
+    std::vector<std::function<void()>> jobs{};
+    for (std::size_t i=0; i<chunks.size(); ++i) {
+        std::size_t begin = chunks[i].first;
+        std::size_t end = chunks[i].second;
+        jobs.emplace_back([&results, &job, i, begin, end]() {
+            results[i] = job(begin, end);
+        });
+    }
+    if (pool != nullptr) {
+        pool->runAll(jobs);
+        return results;
+    }
+    std::vector<std::thread> workers{};
+    for (std::size_t i=1; i<chunks.size(); ++i) {
+        workers.emplace_back(jobs[i]);
+    }
+    jobs[0]();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
+
+/**
+ * @return true if every pair (sequence[i], sequence[i+1]) with i in [begin, end) is ordered
+ */
+static bool arePairsSorted(const int* sequence, std::size_t begin, std::size_t end) {
+    std::size_t i = begin;
+#if defined(__SSE2__)
+    // compare 16 pairs per iteration and check the accumulated mask only once
+    for (; (i + 16) < end; i += 16) {
+        __m128i unordered = _mm_setzero_si128();
+        for (std::size_t j=0; j<16; j += 4) {
+            __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sequence + i + j));
+            __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sequence + i + j + 1));
+            unordered = _mm_or_si128(unordered, _mm_cmpgt_epi32(current, next));
+        }
+        if (_mm_movemask_epi8(unordered) != 0) {
+            return false;
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        if (sequence[i] > sequence[i + 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isSorted(const int* sequence, std::size_t size, int threads, ThreadPool* pool) {
+    if (size < 2) {
+        return true;
+    }
+    // there are size-1 pairs
+    std::vector<char> results = runInChunks<char>(size - 1, threads, pool, [sequence](std::size_t begin, std::size_t end) -> char {
+        return arePairsSorted(sequence, begin, end);
+    });
+    return std::all_of(results.begin(), results.end(), [](char sorted) { return sorted != 0; });
+}
+
+bool isSorted(const int* sequence, std::size_t size, int threads) {
+    return isSorted(sequence, size, threads, nullptr);
+}
+
+bool isSorted(const std::vector<int>& sequence, int threads) {
+    return isSorted(sequence.data(), sequence.size(), threads);
+}
+
+bool isSorted(const std::vector<int>& sequence, ThreadPool& pool) {
+    return isSorted(sequence.data(), sequence.size(), pool.getWorkerCount() + 1, &pool);
+}
+
+/**
+ * finalizer of splitmix64: a bijection spreading every bit of x over the whole result
+ */
+static inline uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t multisetHash(const int* sequence, std::size_t size, int threads, ThreadPool* pool) {
+    std::vector<uint64_t> results = runInChunks<uint64_t>(size, threads, pool, [sequence](std::size_t begin, std::size_t end) -> uint64_t {
+        uint64_t hash = 0;
+        for (std::size_t i=begin; i<end; ++i) {
+            hash += mix(static_cast<uint32_t>(sequence[i]));
+        }
+        return hash;
+    });
+    uint64_t result = 0;
+    for (uint64_t partial : results) {
+        result += partial;
+    }
+    return result;
+}
+
+uint64_t multisetHash(const int* sequence, std::size_t size, int threads) {
+    return multisetHash(sequence, size, threads, nullptr);
+}
+
+uint64_t multisetHash(const std::vector<int>& sequence, int threads) {
+    return multisetHash(sequence.data(), sequence.size(), threads);
+}
+
+uint64_t multisetHash(const std::vector<int>& sequence, ThreadPool& pool) {
+    return multisetHash(sequence.data(), sequence.size(), pool.getWorkerCount() + 1, &pool);
+}
+
+SequenceValidator::SequenceValidator(int threads) : pool{std::max(1, threads) - 1}, inputHash{0}, inputSize{0} {
+
+}
+
+SequenceValidator::SequenceValidator(int threads, const std::vector<std::vector<int>>& workerCpus) : SequenceValidator{threads} {
+    this->pool.bindWorkers(workerCpus);
+}
+
+int SequenceValidator::getThreadCount() const {
+    return this->pool.getWorkerCount() + 1;
+}
+
+void SequenceValidator::recordInput(const std::vector<int>& input) {
+    this->inputHash = multisetHash(input, this->pool);
+    this->inputSize = input.size();
+}
+
+bool SequenceValidator::validate(const std::vector<int>& output) const {
+    if (output.size() != this->inputSize) {
+        return false;
+    }
+    if (!isSorted(output, this->pool)) {
+        return false;
+    }
+    return multisetHash(output, this->pool) == this->inputHash;
+}
@@ -0,0 +1,313 @@
+#include "SortAlgorithms.hpp"
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+std::vector<int>& BubbleSort::sort(std::vector<int>& sequence) {
+    if (sequence.empty()) {
+        return sequence;
+    }
+    for (int i=0; i<(sequence.size()-1); ++i) {
+        for (int j=(i+1); j<sequence.size(); ++j) {
+            if (sequence[i] > sequence[j]) {
+                int tmp = sequence[i];
+                sequence[i] = sequence[j];
+                sequence[j] = tmp;
+            }
+        }
+    }
+    return sequence;
+}
+
+void CountSort::reset(std::size_t sequenceSize) {
+    this->scratch.reserve(this->getScratchBytes(sequenceSize));
+}
+
+const ScratchArena* CountSort::getScratchArena() const {
+    return &this->scratch;
+}
+
+std::size_t CountSort::getScratchBytes(std::size_t sequenceSize) const {
+    return ScratchArena::footprint<int>(sequenceSize) + ScratchArena::footprint<int>(this->max + 1);
+}
+
+std::vector<int>& CountSort::sort(std::vector<int>& sequence) {
+    // see https://www.geeksforgeeks.org/counting-sort/
+
+    // nothing is allocated if reset has been told the size of the sequence
+    this->scratch.reserve(this->getScratchBytes(sequence.size()));
+
+    // The output array
+    // that will have sorted arr
+    int* output = this->scratch.take<int>(sequence.size());
+
+    // Create a count array to store count of inidividul
+    // characters and initialize count array as 0
+    int* count = this->scratch.take<int>(max + 1);
+    int i;
+    memset(count, 0, (max + 1) * sizeof(int));
+
+    // Store count of each character
+    for(i = 0; i<sequence.size(); ++i) {
+        ++count[sequence[i]];
+    }
+
+    // Change count[i] so that count[i] now contains actual
+    // position of this character in output array
+    for (i = 1; i <= max; ++i) {
+        count[i] += count[i-1];
+    }
+
+    // Build the output character array
+    for (i = 0; i < sequence.size(); ++i) {
+        output[count[sequence[i]]-1] = sequence[i];
+        --count[sequence[i]];
+    }
+
+    /*
+    For Stable algorithm
+    for (i = sizeof(arr)-1; i>=0; --i)
+    {
+        output[count[arr[i]]-1] = arr[i];
+        --count[arr[i]];
+    }
+
+    For Logic : See implementation
+    */
+
+    // Copy the output array to arr, so that arr now
+    // contains sorted characters
+    for (i = 0; i < sequence.size(); ++i) {
+        sequence[i] = output[i];
+    }
+
+    return sequence;
+}
+
+void RadixSort::reset(std::size_t sequenceSize) {
+    this->scratch.reserve(this->getScratchBytes(sequenceSize));
+}
+
+const ScratchArena* RadixSort::getScratchArena() const {
+    return &this->scratch;
+}
+
+std::size_t RadixSort::getScratchBytes(std::size_t sequenceSize) const {
+    return ScratchArena::footprint<int>(sequenceSize) + ScratchArena::footprint<int>(1U << this->digitBits);
+}
+
+std::vector<int>& RadixSort::sort(std::vector<int>& sequence) {
+    if (sequence.empty()) {
+        return sequence;
+    }
+    // every pass reuses the same buffers. Nothing is allocated if reset has been told the size of the sequence
+    this->scratch.reserve(this->getScratchBytes(sequence.size()));
+    int* output = this->scratch.take<int>(sequence.size());
+    int* count = this->scratch.take<int>(1U << this->digitBits);
+    // digits are taken from the distance from the minimum, so we need as many passes as the bits of the range
+    auto minmax = std::minmax_element(std::begin(sequence), std::end(sequence));
+    unsigned int min = static_cast<unsigned int>(*minmax.first);
+    unsigned int range = static_cast<unsigned int>(*minmax.second) - min;
+
+    // Do counting sort for every digit. Note that instead
+    // of passing digit number, the number of bits to shift is passed
+    for (int shift = 0; shift < 32 && (range >> shift) > 0; shift += this->digitBits) {
+        this->countSort(sequence, min, shift, output, count);
+    }
+    return sequence;
+}
+
+void RadixSort::countSort(std::vector<int>& sequence, unsigned int min, int shift, int* output, int* count) {
+    int i;
+    unsigned int mask = (1U << this->digitBits) - 1;
+    memset(count, 0, (mask + 1) * sizeof(int));
+
+    // Store count of occurrences in count[]
+    for (i = 0; i < sequence.size(); i++) {
+        count[ ((static_cast<unsigned int>(sequence[i]) - min) >> shift) & mask ]++;
+    }
+
+    // Change count[i] so that count[i] now contains actual
+    //  position of this digit in output[]
+    for (i = 1; i <= mask; i++) {
+        count[i] += count[i - 1];
+    }
+
+    // Build the output array
+    for (i = sequence.size() - 1; i >= 0; i--) {
+        unsigned int digit = ((static_cast<unsigned int>(sequence[i]) - min) >> shift) & mask;
+        output[count[digit] - 1] = sequence[i];
+        count[digit]--;
+    }
+
+    // Copy the output array to arr[], so that arr[] now
+    // contains sorted numbers according to current digit
+    for (i = 0; i < sequence.size(); i++) {
+        sequence[i] = output[i];
+    }
+}
+
+void MergeSort::reset(std::size_t sequenceSize) {
+    this->scratch.reserve(ScratchArena::footprint<int>(sequenceSize));
+}
+
+const ScratchArena* MergeSort::getScratchArena() const {
+    return &this->scratch;
+}
+
+std::vector<int>& MergeSort::sort(std::vector<int>& sequence) {
+    // a merge never needs more room than the whole sequence. Nothing is allocated if reset has been told its size
+    this->scratch.reserve(ScratchArena::footprint<int>(sequence.size()));
+    int* buffer = this->scratch.take<int>(sequence.size());
+    // _merge works on the closed interval [left, right]
+    this->_merge(sequence, 0, static_cast<int>(sequence.size()) - 1, buffer);
+    return sequence;
+}
+
+void MergeSort::merge(std::vector<int>& sequence, int left, int middle, int right, int* buffer) {
+    int i, j, k;
+    int n1 = middle - left + 1;
+    int n2 =  right - middle;
+
+    /* temp arrays, side by side in the scratch buffer */
+    int* L = buffer;
+    int* R = buffer + n1;
+
+    /* Copy data to temp arrays L[] and R[] */
+    for (i = 0; i < n1; i++) {
+        L[i] = sequence[left + i];
+    }
+    for (j = 0; j < n2; j++) {
+        R[j] = sequence[middle + 1+ j];
+    }
+
+    /* Merge the temp arrays back into arr[l..r]*/
+    i = 0; // Initial index of first subarray
+    j = 0; // Initial index of second subarray
+    k = left; // Initial index of merged subarray
+    while (i < n1 && j < n2) {
+        if (L[i] <= R[j]) {
+            sequence[k] = L[i];
+            i++;
+        } else {
+            sequence[k] = R[j];
+            j++;
+        }
+        k++;
+    }
+
+    /* Copy the remaining elements of L[], if there
+    are any */
+    while (i < n1) {
+        sequence[k] = L[i];
+        i++;
+        k++;
+    }
+
+    /* Copy the remaining elements of R[], if there
+    are any */
+    while (j < n2) {
+        sequence[k] = R[j];
+        j++;
+        k++;
+    }
+}
+
+void MergeSort::insertionSort(std::vector<int>& sequence, int left, int right) {
+    for (int i = left + 1; i <= right; ++i) {
+        int x = sequence[i];
+        int j = i - 1;
+        while (j >= left && sequence[j] > x) {
+            sequence[j + 1] = sequence[j];
+            --j;
+        }
+        sequence[j + 1] = x;
+    }
+}
+
+void MergeSort::_merge(std::vector<int>& sequence, int left, int right, int* buffer) {
+    if ((right - left + 1) <= this->smallSortThreshold) {
+        this->insertionSort(sequence, left, right);
+        return;
+    }
+
+    int middle = left + (right - left)/2;
+
+    this->_merge(sequence, left, middle, buffer);
+    this->_merge(sequence, middle + 1, right, buffer);
+
+    this->merge(sequence, left, middle, right, buffer);
+}
+
+std::vector<int>& CombSort::sort(std::vector<int>& sequence) {
+    if (sequence.size() < 2) {
+        return sequence;
+    }
+    // Initialize gap
+    int gap = sequence.size();
+
+    // Initialize swapped as true to make sure that
+    // loop runs
+    bool swapped = true;
+
+    // Keep running while gap is more than 1 and last
+    // iteration caused a swap
+    while (gap != 1 || swapped == true) {
+        // Find next gap
+        gap = this->getNextGap(gap);
+
+        // Initialize swapped as false so that we can
+        // check if swap happened or not
+        swapped = false;
+
+        // Compare all elements with current gap
+        for (int i=0; i<sequence.size()-gap; i++) {
+            if (sequence[i] > sequence[i+gap]) {
+                auto tmp = sequence[i];
+                sequence[i] = sequence[i+gap];
+                sequence[i+gap] = tmp;
+                swapped = true;
+            }
+        }
+    }
+    return sequence;
+}
+
+int CombSort::getNextGap(int gap) {
+    // Shrink gap by Shrink factor (best shrink factor: 10/13)
+    gap = (gap * shrinkFactor);
+    if (gap < 1)
+        return 1;
+    return gap;
+}
+
+const std::vector<std::string>& getSortAlgorithmNames() {
+    static const std::vector<std::string> names{"BUBBLESORT", "MERGESORT", "COUNTSORT", "RADIXSORT", "COMBSORT"};
+    return names;
+}
+
+ISortAlgorithm* createSortAlgorithm(const std::string& algorithm, int upperBound, const EngineParameters& parameters) {
+    if (algorithm == std::string{"BUBBLESORT"}) {
+        return new BubbleSort{};
+    } else if (algorithm == std::string{"MERGESORT"}) {
+        if (parameters.smallSortThreshold < 1) {
+            throw std::domain_error{"small sort threshold needs to be at least 1"};
+        }
+        return new MergeSort{parameters.smallSortThreshold, parameters.pages};
+    } else if (algorithm == std::string{"COUNTSORT"}) {
+        return new CountSort{upperBound, parameters.pages};
+    } else if (algorithm == std::string{"RADIXSORT"}) {
+        if (parameters.radixDigitBits < 1 || parameters.radixDigitBits > 16) {
+            throw std::domain_error{"radix digit bits need to be in [1, 16]"};
+        }
+        return new RadixSort{parameters.radixDigitBits, parameters.pages};
+    } else if (algorithm == std::string{"COMBSORT"}) {
+        if (parameters.shrinkFactor <= 0 || parameters.shrinkFactor >= 1) {
+            throw std::domain_error{"shrink factor needs to be in (0, 1)"};
+        }
+        return new CombSort{parameters.shrinkFactor};
+    } else {
+        throw std::domain_error{"invalid algorithm!"};
+    }
+}
@@ -0,0 +1,227 @@
+#include "SortBench.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Json.hpp"
+#include "SequenceGenerators.hpp"
+#include "SortAlgorithms.hpp"
+#include "TestContext.hpp"
+
+struct sb_config {
+    /**
+     * the options set so far, as a --serve request
+     */
+    JsonValue options;
+};
+
+struct sb_environment {
+    TestEnvironment environment;
+
+    sb_environment(std::size_t sequenceCacheBytes) : environment{sequenceCacheBytes} {
+    }
+};
+
+struct sb_results {
+    int exitCode;
+    std::string error;
+    /**
+     * already in the layout of the C API, so sb_results_records hands them out as they are
+     */
+    std::vector<sb_run_record> runs;
+};
+
+/**
+ * Keeps the runs of an execution for its results
+ */
+class RunCollector : public ResultWriter {
+public:
+    RunCollector(std::vector<sb_run_record>& runs) : runs(runs) {
+    }
+    virtual void write(const RunRecord& record) {
+        sb_run_record run;
+        run.run = record.run;
+        run.time = record.time;
+        run.voluntaryContextSwitches = record.voluntaryContextSwitches;
+        run.involuntaryContextSwitches = record.involuntaryContextSwitches;
+        run.cpuMigrations = record.cpuMigrations;
+        run.runQueueDelay = record.runQueueDelay;
+        run.preempted = record.preempted ? 1 : 0;
+        run.validationTime = record.validationTime;
+        run.status = record.status == RunStatus::TIMEOUT ? SB_RUN_TIMEOUT : SB_RUN_OK;
+        this->runs.push_back(run);
+    }
+    virtual void close() {
+    }
+private:
+    std::vector<sb_run_record>& runs;
+};
+
+/**
+ * @return the option of the command line of a test context with the given name, null if there is none
+ */
+static const CLI::Option* findTestContextOption(const CLI::App& app, const std::string& name) {
+    for (const CLI::Option* option : app.get_options()) {
+        if (!option->get_lnames().empty() && option->get_lnames()[0] == name) {
+            return option;
+        }
+    }
+    return nullptr;
+}
+
+sb_config* sb_config_create(void) {
+    return new (std::nothrow) sb_config{JsonValue::object()};
+}
+
+int sb_config_set(sb_config* config, const char* option, const char* value) {
+    if (config == nullptr || option == nullptr || value == nullptr) {
+        return SB_ERROR;
+    }
+    try {
+        TestContext context{};
+        CLI::App app{"Sorting algorithm tester"};
+        addTestContextOptions(app, context);
+        const CLI::Option* found = findTestContextOption(app, option);
+        if (found == nullptr || std::string{option} == "help") {
+            return SB_ERROR;
+        }
+        if (found->get_type_size() == 0) {
+            std::string flag{value};
+            if (flag != "true" && flag != "false") {
+                return SB_ERROR;
+            }
+            config->options.set(option, flag == "true");
+        } else if (found->get_type_size() < 0) {
+            if (!config->options.has(option)) {
+                config->options.set(option, JsonValue::array());
+            }
+            JsonValue values = config->options.get(option);
+            config->options.set(option, values.push(value));
+        } else {
+            config->options.set(option, value);
+        }
+        return SB_OK;
+    } catch (const std::exception&) {
+        return SB_ERROR;
+    }
+}
+
+int sb_config_set_json(sb_config* config, const char* json) {
+    if (config == nullptr || json == nullptr) {
+        return SB_ERROR;
+    }
+    try {
+        JsonValue options = JsonValue::parse(json);
+        if (!options.isObject()) {
+            return SB_ERROR;
+        }
+        for (auto& member : options.asObject()) {
+            config->options.set(member.first, member.second);
+        }
+        return SB_OK;
+    } catch (const std::exception&) {
+        return SB_ERROR;
+    }
+}
+
+void sb_config_destroy(sb_config* config) {
+    delete config;
+}
+
+sb_environment* sb_environment_create(size_t sequenceCacheBytes) {
+    return new (std::nothrow) sb_environment{sequenceCacheBytes};
+}
+
+void sb_environment_destroy(sb_environment* environment) {
+    delete environment;
+}
+
+int sb_run(const sb_config* config, sb_results** results_out) {
+    std::unique_ptr<sb_environment> environment{sb_environment_create(0)};
+    if (!environment) {
+        return SB_ERROR;
+    }
+    return sb_run_in(environment.get(), config, results_out);
+}
+
+int sb_run_in(sb_environment* environment, const sb_config* config, sb_results** results_out) {
+    std::unique_ptr<sb_results> results{new (std::nothrow) sb_results{SB_ERROR, std::string{}, std::vector<sb_run_record>{}}};
+    if (!results) {
+        return SB_ERROR;
+    }
+    try {
+        if (environment == nullptr || config == nullptr) {
+            throw std::domain_error{"sb_run needs an environment and a configuration"};
+        }
+        // a brand new context for each execution: nothing leaks from the previous one
+        TestContext context{};
+        JsonValue parameters = parseTestContext(config->options, {}, context);
+        RunCollector collector{results->runs};
+        results->exitCode = executeTestContext(context, parameters, environment->environment, &collector);
+    } catch (const std::exception& e) {
+        results->exitCode = SB_ERROR;
+        results->error = e.what();
+    }
+    int exitCode = results->exitCode;
+    if (results_out != nullptr) {
+        *results_out = results.release();
+    }
+    return exitCode;
+}
+
+int sb_results_exit_code(const sb_results* results) {
+    return results->exitCode;
+}
+
+const char* sb_results_error(const sb_results* results) {
+    return results->error.empty() ? nullptr : results->error.c_str();
+}
+
+size_t sb_results_count(const sb_results* results) {
+    return results->runs.size();
+}
+
+int sb_results_get(const sb_results* results, size_t index, sb_run_record* record) {
+    if (index >= results->runs.size() || record == nullptr) {
+        return SB_ERROR;
+    }
+    *record = results->runs[index];
+    return SB_OK;
+}
+
+const sb_run_record* sb_results_records(const sb_results* results) {
+    return results->runs.data();
+}
+
+void sb_results_destroy(sb_results* results) {
+    delete results;
+}
+
+const char* sb_algorithm_name(size_t index) {
+    const std::vector<std::string>& names = getSortAlgorithmNames();
+    return index < names.size() ? names[index].c_str() : nullptr;
+}
+
+const char* sb_sequence_type_name(size_t index) {
+    const std::vector<std::string>& names = getSequenceTypeNames();
+    return index < names.size() ? names[index].c_str() : nullptr;
+}
+
+int sb_generate(const char* sequenceType, size_t size, int lowerBound, int upperBound, unsigned int seed, int* sequence) {
+    if (sequenceType == nullptr || (sequence == nullptr && size > 0)) {
+        return SB_ERROR;
+    }
+    try {
+        // as TestEnvironment::startSequences does
+        RandomGenerator random{seed};
+        std::vector<int> generated = generateSequence(sequenceType, static_cast<int>(size), lowerBound, upperBound, random);
+        std::copy(generated.begin(), generated.end(), sequence);
+        return SB_OK;
+    } catch (const std::exception&) {
+        return SB_ERROR;
+    }
+}
@@ -0,0 +1,112 @@
+#include "SortPlugins.hpp"
+
+#include <algorithm>
+#include <dlfcn.h>
+#include <stdexcept>
+
+PluginSortAlgorithm::PluginSortAlgorithm(const SortPluginEngine& descriptor, int upperBound, const std::string& options) :
+        descriptor(descriptor), engine{nullptr} {
+    this->engine = descriptor.create(upperBound, options.c_str());
+    if (this->engine == nullptr) {
+        throw std::domain_error{std::string{"plugin engine "} + descriptor.name + " can't be created"};
+    }
+}
+
+PluginSortAlgorithm::~PluginSortAlgorithm() {
+    this->descriptor.destroy(this->engine);
+}
+
+void PluginSortAlgorithm::reset(std::size_t sequenceSize) {
+    this->descriptor.reset(this->engine);
+}
+
+std::vector<int>& PluginSortAlgorithm::sort(std::vector<int>& sequence) {
+    int error = this->descriptor.sort(this->engine, sequence.data(), sequence.size());
+    if (error != 0) {
+        throw std::domain_error{std::string{"plugin engine "} + this->descriptor.name + " failed with error " + std::to_string(error)};
+    }
+    return sequence;
+}
+
+SortPluginRegistry::SortPluginRegistry() : plugins{} {
+}
+
+SortPluginRegistry::~SortPluginRegistry() {
+    for (auto& plugin : this->plugins) {
+        dlclose(plugin.handle);
+    }
+}
+
+void SortPluginRegistry::load(const std::string& fileName) {
+    for (auto& plugin : this->plugins) {
+        if (plugin.fileName == fileName) {
+            return;
+        }
+    }
+    // RTLD_LOCAL: the symbols of a plugin don't clash with the ones of another plugin
+    void* handle = dlopen(fileName.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+        throw std::domain_error{"can't load plugin " + fileName + ": " + dlerror()};
+    }
+    try {
+        SortPluginEntryPoint entryPoint = reinterpret_cast<SortPluginEntryPoint>(dlsym(handle, SORT_PLUGIN_ENTRY_POINT));
+        if (entryPoint == nullptr) {
+            throw std::domain_error{"plugin " + fileName + " doesn't export " + SORT_PLUGIN_ENTRY_POINT};
+        }
+        std::size_t count = 0;
+        const SortPluginEngine* engines = entryPoint(&count);
+        Plugin plugin{fileName, handle, {}};
+        const std::vector<std::string>& builtIn = getSortAlgorithmNames();
+        for (std::size_t i=0; i<count; ++i) {
+            const SortPluginEngine& engine = engines[i];
+            if (engine.abiVersion != SORT_PLUGIN_ABI_VERSION) {
+                throw std::domain_error{"plugin " + fileName + " has been compiled with ABI version " + std::to_string(engine.abiVersion) + " while the tester has " + std::to_string(SORT_PLUGIN_ABI_VERSION)};
+            }
+            if (engine.name == nullptr || engine.create == nullptr || engine.reset == nullptr || engine.sort == nullptr || engine.destroy == nullptr) {
+                throw std::domain_error{"plugin " + fileName + " has an incomplete engine"};
+            }
+            std::string name{engine.name};
+            bool taken = std::find(builtIn.begin(), builtIn.end(), name) != builtIn.end() || this->find(name) != nullptr;
+            for (auto other : plugin.engines) {
+                taken = taken || name == other->name;
+            }
+            if (taken) {
+                throw std::domain_error{"plugin " + fileName + " provides " + name + ", which already exists"};
+            }
+            plugin.engines.push_back(&engine);
+        }
+        this->plugins.push_back(plugin);
+    } catch (...) {
+        dlclose(handle);
+        throw;
+    }
+}
+
+const SortPluginEngine* SortPluginRegistry::find(const std::string& algorithm) const {
+    for (auto& plugin : this->plugins) {
+        for (auto engine : plugin.engines) {
+            if (algorithm == engine->name) {
+                return engine;
+            }
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> SortPluginRegistry::getAlgorithmNames() const {
+    std::vector<std::string> result{};
+    for (auto& plugin : this->plugins) {
+        for (auto engine : plugin.engines) {
+            result.push_back(engine->name);
+        }
+    }
+    return result;
+}
+
+ISortAlgorithm* SortPluginRegistry::create(const std::string& algorithm, int upperBound, const EngineParameters& parameters, const std::string& options) const {
+    const SortPluginEngine* engine = this->find(algorithm);
+    if (engine == nullptr) {
+        return createSortAlgorithm(algorithm, upperBound, parameters);
+    }
+    return new PluginSortAlgorithm{*engine, upperBound, options};
+}
@@ -0,0 +1,201 @@
+#include "ResultWriter.hpp"
+
+#include <stdexcept>
+
+#ifdef WITH_SQLITE
+
+#include <sqlite3.h>
+
+/**
+ * runs inserted in the same transaction
+ */
+static const std::size_t TRANSACTION_SIZE = 4096;
+
+/**
+ * milliseconds a writer waits for another one to release the database
+ */
+static const int BUSY_TIMEOUT = 60000;
+
+static const char* SCHEMA =
+    "CREATE TABLE IF NOT EXISTS configurations ("
+    "    id INTEGER PRIMARY KEY,"
+    "    algorithm TEXT,"
+    "    sequenceType TEXT,"
+    "    sequenceSize INTEGER,"
+    "    lowerBound INTEGER,"
+    "    upperBound INTEGER,"
+    "    seed INTEGER,"
+    "    runs INTEGER,"
+    "    gitRevision TEXT,"
+    "    createdAt TEXT,"
+    "    metadata TEXT"
+    ");"
+    "CREATE INDEX IF NOT EXISTS configurationsByContext ON configurations(algorithm, sequenceType, sequenceSize);"
+    "CREATE TABLE IF NOT EXISTS runs ("
+    "    configuration INTEGER NOT NULL REFERENCES configurations(id),"
+    "    run INTEGER NOT NULL,"
+    "    time INTEGER,"
+    "    voluntaryContextSwitches INTEGER,"
+    "    involuntaryContextSwitches INTEGER,"
+    "    cpuMigrations INTEGER,"
+    "    runQueueDelay INTEGER,"
+    "    preempted INTEGER,"
+    "    validationTime INTEGER,"
+    "    status TEXT,"
+    "    PRIMARY KEY (configuration, run)"
+    ") WITHOUT ROWID;";
+
+/**
+ * bind the member of parameters with the given name, or null if it is missing
+ */
+static void bindParameter(sqlite3_stmt* statement, int index, const JsonValue& parameters, const std::string& name) {
+    if (!parameters.has(name) || parameters.get(name).isNull()) {
+        sqlite3_bind_null(statement, index);
+    } else if (parameters.get(name).getType() == JsonValue::Type::NUMBER) {
+        sqlite3_bind_int64(statement, index, parameters.get(name).asInt());
+    } else if (parameters.get(name).getType() == JsonValue::Type::STRING) {
+        sqlite3_bind_text(statement, index, parameters.get(name).asString().c_str(), -1, SQLITE_TRANSIENT);
+    } else {
+        sqlite3_bind_text(statement, index, parameters.get(name).dump().c_str(), -1, SQLITE_TRANSIENT);
+    }
+}
+
+SqliteResultWriter::SqliteResultWriter(const std::string& fileName, const JsonValue& metadata) :
+        BlockResultWriter{TRANSACTION_SIZE}, database{nullptr}, insertRun{nullptr}, configurationId{0} {
+    if (sqlite3_open(fileName.c_str(), &this->database) != SQLITE_OK) {
+        std::string message = this->database != nullptr ? sqlite3_errmsg(this->database) : "out of memory";
+        sqlite3_close(this->database);
+        this->database = nullptr;
+        throw std::domain_error{"can't open database " + fileName + ": " + message};
+    }
+    try {
+        sqlite3_busy_timeout(this->database, BUSY_TIMEOUT);
+        // WAL: readers don't block the writer and a commit is a sequential append
+        this->execute("PRAGMA journal_mode=WAL;");
+        this->execute("PRAGMA synchronous=NORMAL;");
+        this->execute(SCHEMA);
+
+        JsonValue parameters = metadata.has("parameters") ? metadata.get("parameters") : JsonValue::object();
+        JsonValue build = metadata.has("build") ? metadata.get("build") : JsonValue::object();
+        sqlite3_stmt* insertConfiguration;
+        if (sqlite3_prepare_v2(this->database,
+                "INSERT INTO configurations (algorithm, sequenceType, sequenceSize, lowerBound, upperBound, seed, runs, gitRevision, createdAt, metadata) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?, ?, strftime('%Y-%m-%dT%H:%M:%SZ', 'now'), ?);",
+                -1, &insertConfiguration, nullptr) != SQLITE_OK) {
+            throw std::domain_error{std::string{"can't prepare the configuration: "} + sqlite3_errmsg(this->database)};
+        }
+        bindParameter(insertConfiguration, 1, parameters, "algorithm");
+        bindParameter(insertConfiguration, 2, parameters, "sequenceType");
+        bindParameter(insertConfiguration, 3, parameters, "sequenceSize");
+        bindParameter(insertConfiguration, 4, parameters, "lowerBound");
+        bindParameter(insertConfiguration, 5, parameters, "upperBound");
+        bindParameter(insertConfiguration, 6, parameters, "seed");
+        bindParameter(insertConfiguration, 7, parameters, "runs");
+        bindParameter(insertConfiguration, 8, build, "gitRevision");
+        sqlite3_bind_text(insertConfiguration, 9, metadata.dump().c_str(), -1, SQLITE_TRANSIENT);
+        int result = sqlite3_step(insertConfiguration);
+        sqlite3_finalize(insertConfiguration);
+        if (result != SQLITE_DONE) {
+            throw std::domain_error{std::string{"can't insert the configuration: "} + sqlite3_errmsg(this->database)};
+        }
+        this->configurationId = static_cast<long>(sqlite3_last_insert_rowid(this->database));
+
+        if (sqlite3_prepare_v2(this->database,
+                "INSERT INTO runs (configuration, run, time, voluntaryContextSwitches, involuntaryContextSwitches, cpuMigrations, runQueueDelay, preempted, validationTime, status) "
+                "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);",
+                -1, &this->insertRun, nullptr) != SQLITE_OK) {
+            throw std::domain_error{std::string{"can't prepare the runs: "} + sqlite3_errmsg(this->database)};
+        }
+    } catch (...) {
+        sqlite3_close(this->database);
+        this->database = nullptr;
+        throw;
+    }
+}
+
+SqliteResultWriter::~SqliteResultWriter() {
+    try {
+        this->close();
+    } catch (...) {
+        // nobody to report it to
+    }
+}
+
+void SqliteResultWriter::execute(const std::string& sql) {
+    char* error = nullptr;
+    if (sqlite3_exec(this->database, sql.c_str(), nullptr, nullptr, &error) != SQLITE_OK) {
+        std::string message = error != nullptr ? error : "unknown error";
+        sqlite3_free(error);
+        throw std::domain_error{"sqlite: " + message};
+    }
+}
+
+long SqliteResultWriter::getConfigurationId() const {
+    return this->configurationId;
+}
+
+void SqliteResultWriter::flushBlock(const std::vector<RunRecord>& block) {
+    // IMMEDIATE: take the write lock now, so that a concurrent writer can't make the commit fail
+    this->execute("BEGIN IMMEDIATE;");
+    try {
+        for (auto& record : block) {
+            sqlite3_bind_int64(this->insertRun, 1, this->configurationId);
+            for (int column=0; column<RUN_RECORD_INTEGER_COLUMNS; ++column) {
+                sqlite3_bind_int64(this->insertRun, 2 + column, getRunRecordIntegerColumn(record, column));
+            }
+            sqlite3_bind_text(this->insertRun, 2 + RUN_RECORD_INTEGER_COLUMNS, getRunStatusName(record.status), -1, SQLITE_STATIC);
+            int result = sqlite3_step(this->insertRun);
+            sqlite3_reset(this->insertRun);
+            if (result != SQLITE_DONE) {
+                throw std::domain_error{std::string{"can't insert a run: "} + sqlite3_errmsg(this->database)};
+            }
+        }
+        this->execute("COMMIT;");
+    } catch (...) {
+        sqlite3_exec(this->database, "ROLLBACK;", nullptr, nullptr, nullptr);
+        throw;
+    }
+}
+
+void SqliteResultWriter::close() {
+    if (this->database == nullptr) {
+        return;
+    }
+    try {
+        this->flush();
+    } catch (...) {
+        // the destructor must not try again
+        sqlite3_finalize(this->insertRun);
+        sqlite3_close(this->database);
+        this->database = nullptr;
+        throw;
+    }
+    sqlite3_finalize(this->insertRun);
+    sqlite3_close(this->database);
+    this->database = nullptr;
+}
+
+#else
+
+SqliteResultWriter::SqliteResultWriter(const std::string& fileName, const JsonValue& metadata) :
+        BlockResultWriter{1}, database{nullptr}, insertRun{nullptr}, configurationId{0} {
+    throw std::domain_error{"the tester has been built without SQLite"};
+}
+
+SqliteResultWriter::~SqliteResultWriter() {
+}
+
+long SqliteResultWriter::getConfigurationId() const {
+    return this->configurationId;
+}
+
+void SqliteResultWriter::flushBlock(const std::vector<RunRecord>& block) {
+}
+
+void SqliteResultWriter::close() {
+}
+
+void SqliteResultWriter::execute(const std::string& sql) {
+}
+
+#endif
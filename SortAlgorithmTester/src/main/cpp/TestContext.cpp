@@ -0,0 +1,838 @@
+#include "TestContext.hpp"
+
+#include "SortAlgorithms.hpp"
+#include "SequenceGenerators.hpp"
+#include "LatencyHistogram.hpp"
+#include "SchedulerMetrics.hpp"
+#include "SamplingProfiler.hpp"
+#include "RegressionGate.hpp"
+#include "RunWatchdog.hpp"
+#include "EngineParameters.hpp"
+#include "EngineTuner.hpp"
+#include "AsyncResultWriter.hpp"
+#include "RunMetadata.hpp"
+#include "Checkpoint.hpp"
+#include "NumaPlacement.hpp"
+#include "HugePages.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <functional>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+void addTestContextOptions(CLI::App& app, TestContext& context) {
+    app.add_option("--sequenceSize", context.sequenceSize, "Size of the array to sort")
+        ->required();
+    app.add_option("--sequenceType", context.sequenceType, "type of the sequence to sort: RANDOM, SAME, SORTED, REVERSESORTED")
+    ->required();
+    app.add_option("--algorithm", context.algorithm, "algorithm to test. BUBBLESORT, MERGESORT, COUNTSORT, RADIXSORT, COMBSORT or an engine of a --plugin")
+    ->required();
+    app.add_option("--lowerBound", context.lowerBound, "Minimum number we might generate")
+    ->required();
+    app.add_option("--upperBound", context.upperBound, "Maximum number we might generate")
+    ->required();
+    app.add_option("--runs", context.runs, "Number of run we need to perform (execution of the same trial)")
+    ->required();
+    app.add_option("--seed", context.seed, "Seed for random generator")
+    ->required();
+    app.add_option("--outputTemplate", context.outputTemplate)
+    ->required();
+
+    app.add_option("--outputFormat", context.outputFormat, "format of the file with the outcome of each run: csv, jsonl (each line has the run, the command line, the build and the machine), binary (columns numpy can memory map) or arrow (Arrow IPC file)", true);
+    app.add_option("--compression", context.compression, "codec compressing the main file, in chunks of runs which can be decompressed independently: none, zstd or lz4. Not available for binary results", true);
+    app.add_option("--resultShm", context.resultShm, "name of a POSIX shared memory segment where the results are written (as typed columns) instead of the main file. The reader needs to remove the segment");
+    app.add_option("--resultDb", context.resultDb, "SQLite database where the results are inserted instead of the main file. Several testers can share it");
+    app.add_flag("--asyncResults", context.asyncResults, "write the results from a background thread, pinned on another core if possible. Results are written even if the tester is killed or crashes");
+    app.add_option("--shrinkFactor", context.shrinkFactor, "factor used to shrink the gap of combsort, in (0, 1). Used only in COMBSORT algorithm. If missing, 1/1.3");
+    app.add_option("--smallSortThreshold", context.smallSortThreshold, "subsequences up to this size are sorted with insertion sort. Used only in MERGESORT algorithm. If missing, derived from the cache line size");
+    app.add_option("--radixDigitBits", context.radixDigitBits, "bits sorted in each pass, in [1, 16]. Used only in RADIXSORT algorithm. If missing, derived from the L1 cache size");
+    app.add_option("--topologyCache", context.topologyCache, "file where the machine topology (caches, cores, NUMA nodes) is stored. If it doesn't exist, the topology is detected and saved there. If missing, the topology is always detected");
+    app.add_option("--plugin", context.plugins, "shared library providing engines through the C ABI of SortPlugin.h. Can be repeated");
+    app.add_option("--pluginOptions", context.pluginOptions, "string handed to the plugin engine when it is created");
+    app.add_flag("--tune", context.tune, "instead of benchmarking the algorithm, search the fastest tunables of it on a sequence as described by the other options and store them in --tuningProfile. --runs is the number of sorts timed per candidate");
+    app.add_option("--tuningProfile", context.tuningProfile, "json file with the engine tunables found by --tune. Tunables explicitly given in the command line take precedence over it");
+    app.add_option("--validationThreads", context.validationThreads, "number of threads used to check the output of the algorithm", true);
+    app.add_option("--numa", context.numa, "where the pages of the sorted buffer live: none (where they are first touched), interleave (over every node), local (on the node of the sorting thread, pinned there) or firstTouchParallel (each chunk the validation threads split the buffer in on the node of its thread, pinned there). Pages and bandwidth per node are written in a kind:type=numa csv", true);
+    app.add_option("--pages", context.pages, "pages backing the sorted buffer and the scratch buffers of the engines: default, thp (transparent huge pages), hugetlb2M or hugetlb1G (reserved huge pages). Unavailable huge pages fall back to thp and then to default ones. The huge pages obtained are written in a kind:type=pages csv", true);
+    app.add_flag("--profile", context.profile, "sample the call stacks of the sorts and write them as folded stacks (for flame graphs) next to the csv");
+    app.add_option("--profileFrequency", context.profileFrequency, "samples per second of CPU time taken by --profile", true);
+    app.add_option("--isolation", context.isolation, "process each run executes in: none (this one), fork (a child executing every run) or fork-per-run (a child per run, forked once its input has been generated, so that no run inherits the heap of the previous ones)", true);
+    app.add_option("--runTimeout", context.runTimeout, "seconds after which a sort is abandoned: the run is recorded with status timeout and the remaining runs are skipped. 0 disables it", true);
+    app.add_option("--baseline", context.baseline, "main csv (or summary csv) of a previous execution of this configuration. If the algorithm got slower, a report is written and the program exits with 2");
+    app.add_option("--regressionThreshold", context.regressionThreshold, "growth of the median time over --baseline we tolerate, either as a percentage (5%) or a fraction (0.05)", true);
+    app.add_option("--regressionSignificance", context.regressionSignificance, "p-value of the Mann-Whitney U test below which a growth of the median over --baseline is deemed significant", true);
+    app.add_flag("--noResultFiles", context.noResultFiles, "hand the results only to the caller of the library (sb_run, sortbench.run) or to the client of --serve streaming the runs, without writing the main and summary files nor the completion marker. Not available from the command line");
+    app.add_flag("--skipIfComplete", context.skipIfComplete, "do nothing if the files of a previous execution of the context are complete, as recorded in its kind:type=complete marker, and exit as that execution did");
+    app.add_flag("--discardPreempted", context.discardPreempted, "if a run has been preempted by the scheduler, repeat it on the same sequence");
+    app.add_option("--maxRetries", context.maxRetries, "maximum number of times a preempted run is repeated. Used only with --discardPreempted. If every attempt is preempted, the last one is kept (and flagged)", true);
+}
+
+/**
+ * @return every option of the command line with the value it has been given, its default value or null
+ */
+JsonValue describeCommandLine(const CLI::App& app) {
+    JsonValue result = JsonValue::object();
+    for (const CLI::Option* option : app.get_options()) {
+        if (option->get_lnames().empty() || option->get_lnames()[0] == "help") {
+            continue;
+        }
+        std::string name = option->get_lnames()[0];
+        if (option->get_type_size() == 0) {
+            result.set(name, option->count() > 0);
+            continue;
+        }
+        if (option->get_type_size() < 0) {
+            // options which can be repeated: every value they have been given
+            JsonValue values = JsonValue::array();
+            for (auto& value : option->results()) {
+                values.push(value);
+            }
+            result.set(name, values);
+            continue;
+        }
+        std::string value{};
+        if (option->count() > 0) {
+            value = option->results().back();
+        } else if (!option->get_defaultval().empty()) {
+            value = option->get_defaultval();
+        } else {
+            result.set(name, JsonValue{});
+            continue;
+        }
+        // numbers are stored as such, so they can be compared without parsing them
+        char* end;
+        double number = strtod(value.c_str(), &end);
+        if (!value.empty() && *end == '\0') {
+            result.set(name, number);
+        } else {
+            result.set(name, value);
+        }
+    }
+    return result;
+}
+
+/**
+ * @return the command line described by the members of options, as if it were given to the tester
+ */
+static std::vector<std::string> toCommandLine(const JsonValue& options, const std::set<std::string>& ignored) {
+    std::vector<std::string> result{"SortAlgorithmTester"};
+    for (auto& member : options.asObject()) {
+        if (ignored.count(member.first) > 0) {
+            continue;
+        }
+        switch (member.second.getType()) {
+        case JsonValue::Type::NUL:
+            break;
+        case JsonValue::Type::BOOLEAN:
+            if (member.second.asBool()) {
+                result.push_back("--" + member.first);
+            }
+            break;
+        case JsonValue::Type::NUMBER:
+            result.push_back("--" + member.first);
+            result.push_back(member.second.dump());
+            break;
+        case JsonValue::Type::STRING:
+            result.push_back("--" + member.first);
+            result.push_back(member.second.asString());
+            break;
+        case JsonValue::Type::ARRAY:
+            // an option repeated for each value
+            for (auto& value : member.second.asArray()) {
+                if (value.getType() != JsonValue::Type::STRING && value.getType() != JsonValue::Type::NUMBER) {
+                    throw std::domain_error{"the values of option " + member.first + " need to be strings or numbers"};
+                }
+                result.push_back("--" + member.first);
+                result.push_back(value.getType() == JsonValue::Type::STRING ? value.asString() : value.dump());
+            }
+            break;
+        default:
+            throw std::domain_error{"option " + member.first + " needs to be a string, a number, a boolean or an array of them"};
+        }
+    }
+    return result;
+}
+
+JsonValue parseTestContext(const JsonValue& options, const std::set<std::string>& ignored, TestContext& context) {
+    if (!options.isObject()) {
+        throw std::domain_error{"a test context needs to be a json object"};
+    }
+    std::vector<std::string> arguments = toCommandLine(options, ignored);
+    std::vector<const char*> argv{};
+    for (auto& argument : arguments) {
+        argv.push_back(argument.c_str());
+    }
+    CLI::App app{"Sorting algorithm tester"};
+    addTestContextOptions(app, context);
+    try {
+        app.parse(static_cast<int>(argv.size()), argv.data());
+    } catch (const CLI::ParseError& e) {
+        throw std::domain_error{e.what()};
+    }
+    return describeCommandLine(app);
+}
+
+TestEnvironment::TestEnvironment(std::size_t sequenceCacheBytes) :
+        sequenceCacheBytes{sequenceCacheBytes}, cachedSequenceBytes{0}, cachedSequences{},
+        replayed{nullptr}, nextRun{0}, sequenceType{}, sequenceSize{0}, lowerBound{0}, upperBound{0}, runs{0},
+        recorded{}, random{}, generated{}, topologies{}, validator{}, plugins{}, sortBuffer{} {
+}
+
+const MachineTopology& TestEnvironment::getTopology(const std::string& cacheFileName) {
+    auto it = this->topologies.find(cacheFileName);
+    if (it == this->topologies.end()) {
+        it = this->topologies.insert(std::make_pair(cacheFileName, getMachineTopology(cacheFileName))).first;
+    }
+    return it->second;
+}
+
+SequenceValidator& TestEnvironment::getValidator(int threads) {
+    if (!this->validator || this->validator->getThreadCount() != std::max(1, threads)) {
+        this->validator.reset(new SequenceValidator{threads});
+    }
+    return *this->validator;
+}
+
+SortPluginRegistry& TestEnvironment::getPlugins() {
+    return this->plugins;
+}
+
+void TestEnvironment::startSequences(const TestContext& context) {
+    std::string key = context.sequenceType + "|" + std::to_string(context.sequenceSize) + "|" +
+        std::to_string(context.lowerBound) + "|" + std::to_string(context.upperBound) + "|" + std::to_string(context.seed);
+    std::size_t runs = static_cast<std::size_t>(std::max(0, context.runs));
+
+    this->replayed = nullptr;
+    this->recorded.reset();
+    this->nextRun = 0;
+    for (auto it = this->cachedSequences.begin(); it != this->cachedSequences.end(); ++it) {
+        if (it->key == key && it->sequences.size() >= runs) {
+            this->cachedSequences.splice(this->cachedSequences.begin(), this->cachedSequences, it);
+            this->replayed = &this->cachedSequences.front();
+            return;
+        }
+    }
+
+    this->sequenceType = context.sequenceType;
+    this->sequenceSize = context.sequenceSize;
+    this->lowerBound = context.lowerBound;
+    this->upperBound = context.upperBound;
+    this->runs = runs;
+    std::size_t bytes = runs * static_cast<std::size_t>(std::max(0, context.sequenceSize)) * sizeof(int);
+    if (bytes > 0 && bytes <= this->sequenceCacheBytes) {
+        this->recorded.reset(new CachedSequences{key, std::vector<std::vector<int>>{}, bytes});
+        this->recorded->sequences.reserve(runs);
+    }
+    this->random.reset(new RandomGenerator{static_cast<unsigned int>(context.seed)});
+}
+
+const std::vector<int>& TestEnvironment::nextSequence() {
+    if (this->replayed != nullptr) {
+        return this->replayed->sequences[this->nextRun++];
+    }
+    ++this->nextRun;
+    if (!this->recorded) {
+        this->generated = generateSequence(this->sequenceType, this->sequenceSize, this->lowerBound, this->upperBound, *this->random);
+        return this->generated;
+    }
+    this->recorded->sequences.push_back(generateSequence(this->sequenceType, this->sequenceSize, this->lowerBound, this->upperBound, *this->random));
+    if (this->recorded->sequences.size() < this->runs) {
+        return this->recorded->sequences.back();
+    }
+
+    // every run has been generated: the sequences can be cached
+    while (!this->cachedSequences.empty() && this->cachedSequenceBytes + this->recorded->bytes > this->sequenceCacheBytes) {
+        this->cachedSequenceBytes -= this->cachedSequences.back().bytes;
+        this->cachedSequences.pop_back();
+    }
+    this->cachedSequenceBytes += this->recorded->bytes;
+    this->cachedSequences.push_front(std::move(*this->recorded));
+    this->recorded.reset();
+    this->replayed = &this->cachedSequences.front();
+    return this->replayed->sequences[this->nextRun - 1];
+}
+
+std::vector<int>& TestEnvironment::getSortBuffer() {
+    return this->sortBuffer;
+}
+
+std::size_t TestEnvironment::getCachedSequenceBytes() const {
+    return this->cachedSequenceBytes;
+}
+
+/**
+ * What a run reports to the process storing the results
+ */
+struct RunOutcome {
+    RunRecord record;
+    /**
+     * sort time, in nanoseconds
+     */
+    long long nanoseconds;
+    /**
+     * false if the output of a completed sort is not valid
+     */
+    bool valid;
+};
+
+/**
+ * sort input (retrying preempted attempts if needed) and check the output
+ *
+ * @param sequence the buffer sorted
+ * @param profiler armed around each attempt, if not null
+ * @param watchdog running the sort, if not null
+ */
+static RunOutcome executeRun(int run, const TestContext& context, const std::vector<int>& input, std::vector<int>& sequence, ISortAlgorithm& alg, SequenceValidator& validator, SchedulerProbe& probe, SamplingProfiler* profiler, RunWatchdog* watchdog) {
+    sequence = input;
+    auto validationStart = std::chrono::steady_clock::now();
+    validator.recordInput(sequence);
+    auto validationEnd = std::chrono::steady_clock::now();
+    std::chrono::duration<double> validationSeconds = validationEnd - validationStart;
+
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    SchedulerSample interference;
+    bool completed = true;
+    auto timedSort = [&alg, &sequence, &start, &end]() {
+        start = std::chrono::steady_clock::now();
+        alg.sort(sequence);
+        end = std::chrono::steady_clock::now();
+    };
+    for (int attempt=0; ; ++attempt) {
+        alg.reset(sequence.size());
+        SchedulerSample before = probe.sample();
+        if (profiler != nullptr) {
+            profiler->arm();
+        }
+        if (watchdog != nullptr) {
+            completed = watchdog->run(timedSort);
+        } else {
+            timedSort();
+        }
+        if (!completed) {
+            end = std::chrono::steady_clock::now();
+        }
+        if (profiler != nullptr) {
+            profiler->disarm();
+        }
+        interference = probe.sample() - before;
+
+        if (!completed || !context.discardPreempted || !interference.isPreempted() || attempt >= context.maxRetries) {
+            break;
+        }
+        // retries need to sort the very same sequence
+        sequence = input;
+    }
+    std::chrono::duration<double> elapsed_seconds = end-start;
+
+    bool valid = true;
+    if (completed) {
+        validationStart = std::chrono::steady_clock::now();
+        valid = validator.validate(sequence);
+        validationEnd = std::chrono::steady_clock::now();
+        validationSeconds += validationEnd - validationStart;
+    }
+
+    RunOutcome result;
+    result.record = RunRecord{
+        run, static_cast<long>(1e6 * elapsed_seconds.count()),
+        interference.voluntaryContextSwitches, interference.involuntaryContextSwitches,
+        interference.cpuMigrations, static_cast<long>(interference.runQueueDelay),
+        interference.isPreempted(),
+        static_cast<long>(1e6 * validationSeconds.count()),
+        completed ? RunStatus::OK : RunStatus::TIMEOUT
+    };
+    result.nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    result.valid = valid;
+    return result;
+}
+
+static void writeOutcome(int fd, const RunOutcome& outcome) {
+    const char* data = reinterpret_cast<const char*>(&outcome);
+    std::size_t written = 0;
+    while (written < sizeof(outcome)) {
+        ssize_t result = ::write(fd, data + written, sizeof(outcome) - written);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            throw std::domain_error{"can't report the outcome of a run"};
+        }
+        written += static_cast<std::size_t>(result);
+    }
+}
+
+/**
+ * A child process executing runs (see --isolation). It inherits the memory of the parent copy-on-write, hence the
+ * inputs and the engine, and writes a RunOutcome in a pipe for each run. Threads are not forked: the validator of the
+ * child has no workers, hence it validates by itself
+ */
+class ChildRunner {
+public:
+    /**
+     * @param body executed by the child, with the write end of the pipe. The child exits when it returns (1 if it
+     *  throws), without running any destructor or flushing the stdio buffers of the parent
+     */
+    ChildRunner(const std::function<void(int)>& body) : child{-1}, outcomes{-1} {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            throw std::domain_error{"can't create the pipe of a run"};
+        }
+        // the child would write again whatever is still buffered
+        fflush(nullptr);
+        this->child = fork();
+        if (this->child < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            throw std::domain_error{"can't fork the process of a run"};
+        }
+        if (this->child == 0) {
+            close(fds[0]);
+            int exitCode = 0;
+            try {
+                body(fds[1]);
+            } catch (const std::exception& e) {
+                fprintf(stderr, "%s\n", e.what());
+                exitCode = 1;
+            }
+            _exit(exitCode);
+        }
+        close(fds[1]);
+        this->outcomes = fds[0];
+    }
+    virtual ~ChildRunner() {
+        if (this->outcomes >= 0) {
+            close(this->outcomes);
+        }
+        if (this->child > 0) {
+            // the parent gave up on the runs: the child is of no use anymore
+            kill(this->child, SIGKILL);
+            waitpid(this->child, nullptr, 0);
+        }
+    }
+    ChildRunner(const ChildRunner& other) = delete;
+    ChildRunner& operator=(const ChildRunner& other) = delete;
+
+    /**
+     * @return false if the child reported every run it executed
+     */
+    bool read(RunOutcome& outcome) {
+        char* data = reinterpret_cast<char*>(&outcome);
+        std::size_t received = 0;
+        while (received < sizeof(outcome)) {
+            ssize_t result = ::read(this->outcomes, data + received, sizeof(outcome) - received);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                return false;
+            }
+            received += static_cast<std::size_t>(result);
+        }
+        return true;
+    }
+    /**
+     * wait for the child to exit
+     *
+     * @param run the run the child was executing, for the error message
+     * @throws std::domain_error if the child crashed or failed
+     */
+    void finish(int run) {
+        close(this->outcomes);
+        this->outcomes = -1;
+        int status;
+        while (waitpid(this->child, &status, 0) < 0) {
+            if (errno != EINTR) {
+                this->child = -1;
+                throw std::domain_error{"can't wait for the process of a run"};
+            }
+        }
+        this->child = -1;
+        if (WIFSIGNALED(status)) {
+            throw std::domain_error{"the process of run " + std::to_string(run) + " has been killed by signal " + std::to_string(WTERMSIG(status))};
+        }
+        if (WEXITSTATUS(status) != 0) {
+            throw std::domain_error{"the process of run " + std::to_string(run) + " failed"};
+        }
+    }
+private:
+    pid_t child;
+    int outcomes;
+};
+
+int executeTestContext(const TestContext& context, const JsonValue& parameters, TestEnvironment& environment, ResultWriter* observer) {
+    if (context.noResultFiles) {
+        if (observer == nullptr) {
+            throw std::domain_error{"--noResultFiles needs a caller collecting the results: the runs would be lost"};
+        }
+        if (!context.resultShm.empty() || !context.resultDb.empty()) {
+            throw std::domain_error{"--noResultFiles can't be used with --resultShm or --resultDb"};
+        }
+        if (context.skipIfComplete) {
+            throw std::domain_error{"--skipIfComplete needs the result files: it can't be used with --noResultFiles"};
+        }
+    }
+    if (context.skipIfComplete && !context.tune) {
+        int exitCode;
+        if (isOutputComplete(context.outputTemplate, exitCode)) {
+            fprintf(stderr, "%s is complete: skipping the context\n", getCompletionMarkerName(context.outputTemplate).c_str());
+            return exitCode;
+        }
+    }
+    // fail before doing any work if the baseline is not usable
+    Baseline baseline{};
+    double regressionThreshold = 0;
+    if (!context.baseline.empty()) {
+        baseline = loadBaseline(context.baseline);
+        regressionThreshold = parseThreshold(context.regressionThreshold);
+    }
+    // time of each run, in microseconds. Needed only to compare against the baseline
+    std::vector<double> times{};
+    if (!context.baseline.empty()) {
+        times.reserve(context.runs);
+    }
+
+    SortPluginRegistry& plugins = environment.getPlugins();
+    for (auto& plugin : context.plugins) {
+        plugins.load(plugin);
+    }
+
+    const MachineTopology& topology = environment.getTopology(context.topologyCache);
+    EngineParameters engineParameters = deriveEngineParameters(topology);
+    if (!context.tuningProfile.empty() && !context.tune) {
+        applyTuningProfile(context.tuningProfile, engineParameters);
+    }
+    if (context.shrinkFactor != 0) {
+        engineParameters.shrinkFactor = context.shrinkFactor;
+    }
+    if (context.smallSortThreshold != 0) {
+        engineParameters.smallSortThreshold = context.smallSortThreshold;
+    }
+    if (context.radixDigitBits != 0) {
+        engineParameters.radixDigitBits = context.radixDigitBits;
+    }
+    engineParameters.pages = parsePageKind(context.pages);
+
+    if (context.tune) {
+        if (context.tuningProfile.empty()) {
+            throw std::domain_error{"--tune needs --tuningProfile"};
+        }
+        std::vector<std::string> tunables = EngineTuner::getTunables(context.algorithm);
+        if (tunables.empty()) {
+            fprintf(stderr, "%s has nothing to tune\n", context.algorithm.c_str());
+            return 0;
+        }
+        RandomGenerator random{static_cast<unsigned int>(context.seed)};
+        std::vector<int> sequence = generateSequence(context.sequenceType, context.sequenceSize, context.lowerBound, context.upperBound, random);
+        EngineTuner tuner{context.algorithm, context.upperBound, sequence, context.runs};
+        engineParameters = tuner.tune(engineParameters);
+        std::string input = context.sequenceType + "/" + std::to_string(context.sequenceSize);
+        saveTuningProfile(context.tuningProfile, engineParameters, tunables, input);
+        return 0;
+    }
+
+    std::unique_ptr<ISortAlgorithm> alg{plugins.create(context.algorithm, context.upperBound, engineParameters, context.pluginOptions)};
+    const SortPluginEngine* pluginEngine = plugins.find(context.algorithm);
+    if (pluginEngine != nullptr && context.runTimeout > 0 && (pluginEngine->capabilities & SORT_PLUGIN_ABANDONABLE) == 0) {
+        throw std::domain_error{"--runTimeout can't abandon " + context.algorithm + ": its plugin doesn't declare it abandonable"};
+    }
+
+    JsonValue metadata = JsonValue::object()
+        .set("parameters", parameters)
+        .set("engineParameters", JsonValue::object()
+            .set("shrinkFactor", engineParameters.shrinkFactor)
+            .set("smallSortThreshold", engineParameters.smallSortThreshold)
+            .set("radixDigitBits", engineParameters.radixDigitBits)
+        )
+        .set("build", getBuildMetadata())
+        .set("host", getHostMetadata());
+    if (!context.resultShm.empty() && !context.resultDb.empty()) {
+        throw std::domain_error{"--resultShm and --resultDb can't be used together"};
+    }
+    if ((!context.resultShm.empty() || !context.resultDb.empty()) && context.compression != std::string{"none"}) {
+        throw std::domain_error{"--compression applies only to the main file"};
+    }
+    // until the context completes, its files are not complete, whatever a previous execution left
+    removeCompletionMarker(context.outputTemplate);
+    // files of the context whose integrity the completion marker records
+    std::vector<std::string> outputSuffixes{};
+    std::unique_ptr<ResultWriter> results{};
+    if (!context.resultShm.empty()) {
+        results.reset(new ShmResultWriter{context.resultShm, static_cast<std::size_t>(context.runs)});
+    } else if (!context.resultDb.empty()) {
+        results.reset(new SqliteResultWriter{context.resultDb, metadata});
+    } else if (!context.noResultFiles) {
+        results.reset(createResultWriter(context.outputFormat, context.outputTemplate, context.runs, metadata, context.compression));
+        outputSuffixes.push_back(getResultFileSuffix(context.outputFormat, context.compression));
+    }
+    if (results && context.asyncResults) {
+        int writerCpu = chooseWriterCpu(topology, getAllowedCpus(), sched_getcpu());
+        results.reset(new AsyncResultWriter{results.release(), 1 << 14, writerCpu});
+    }
+
+    // sort times in nanoseconds. 3 significant digits are more than enough, and it tracks up to one hour
+    LatencyHistogram histogram{3600ULL * 1000000000ULL, 3};
+
+    if (context.isolation != "none" && context.isolation != "fork" && context.isolation != "fork-per-run") {
+        throw std::domain_error{"invalid isolation " + context.isolation + ": it needs to be none, fork or fork-per-run"};
+    }
+    if (context.isolation != "none" && context.profile) {
+        throw std::domain_error{"--profile needs --isolation none: the samples would stay in the child processes"};
+    }
+    // fail before doing any work if the policy doesn't exist
+    NumaPolicy numaPolicy = parseNumaPolicy(context.numa);
+    std::unique_ptr<NumaPlacement> numa{};
+    std::unique_ptr<SequenceValidator> numaValidator{};
+    std::unique_ptr<ThreadAffinityGuard> numaAffinity{};
+    std::vector<std::pair<std::size_t, std::size_t>> numaChunks{};
+    if (numaPolicy != NumaPolicy::NONE) {
+        numa.reset(new NumaPlacement{numaPolicy, topology, getAllowedCpus(), sched_getcpu()});
+        numaChunks = getValidationChunks(static_cast<std::size_t>(std::max(0, context.sequenceSize)), context.validationThreads);
+        numaAffinity.reset(new ThreadAffinityGuard{numa->getCallerCpus()});
+        // the workers of the validator of the environment are not pinned, and must stay so for the next contexts. A
+        // forked child has none of our worker threads, and a bound pool waits for its own workers: children build
+        // their validator
+        if (context.isolation == "none") {
+            numaValidator.reset(new SequenceValidator{context.validationThreads, numa->getWorkerCpus(numaChunks.size())});
+        }
+    }
+    SequenceValidator& validator = numaValidator ? *numaValidator : environment.getValidator(context.validationThreads);
+    // the validator of a child process, pinned as numaValidator would be. nullptr if the child can use validator
+    auto createChildValidator = [&]() -> SequenceValidator* {
+        return numa ? new SequenceValidator{context.validationThreads, numa->getWorkerCpus(numaChunks.size())} : nullptr;
+    };
+    // stacks of 64 frames are more than enough for our engines
+    std::unique_ptr<SamplingProfiler> profiler{};
+    if (context.profile) {
+        profiler.reset(new SamplingProfiler{context.profileFrequency, 1 << 15, 64});
+    }
+    // the probe and the watchdog track the thread which creates them: children create their own ones
+    std::unique_ptr<SchedulerProbe> probe{};
+    std::unique_ptr<RunWatchdog> watchdog{};
+    if (context.isolation == "none") {
+        probe.reset(new SchedulerProbe{});
+        if (context.runTimeout > 0) {
+            watchdog.reset(new RunWatchdog{context.runTimeout});
+        }
+    }
+
+    /**
+     * store the outcome of a run
+     *
+     * @return false if the remaining runs need to be skipped
+     */
+    long rows = 0;
+    // time spent sorting, in nanoseconds
+    long long sortNanoseconds = 0;
+    auto collect = [&](const RunOutcome& outcome) -> bool {
+        sortNanoseconds += outcome.nanoseconds;
+        if (outcome.record.status == RunStatus::TIMEOUT) {
+            // the sequence is left half sorted: there's nothing to validate
+            if (results) {
+                results->write(outcome.record);
+            }
+            ++rows;
+            if (observer != nullptr) {
+                observer->write(outcome.record);
+            }
+            fprintf(stderr, "run %ld timed out after %.3fs: skipping the remaining %ld runs\n", outcome.record.run, 1e-9 * outcome.nanoseconds, context.runs - outcome.record.run - 1);
+            return false;
+        }
+        histogram.record(outcome.nanoseconds);
+        if (!context.baseline.empty()) {
+            times.push_back(1e-3 * outcome.nanoseconds);
+        }
+        if (!outcome.valid) {
+            throw std::domain_error{"sorting failed!"};
+        }
+        if (results) {
+            results->write(outcome.record);
+        }
+        ++rows;
+        if (observer != nullptr) {
+            observer->write(outcome.record);
+        }
+        return true;
+    };
+
+    environment.startSequences(context);
+    std::vector<int>& sequence = environment.getSortBuffer();
+    PageKind sequencePages = PageKind::DEFAULT;
+    if (engineParameters.pages != PageKind::DEFAULT) {
+        std::size_t size = static_cast<std::size_t>(std::max(0, context.sequenceSize));
+        if (sequence.capacity() < size) {
+            // a new buffer, advised before anything touches it, so that its pages are huge from the first fault
+            std::vector<int>{}.swap(sequence);
+            sequence.reserve(size);
+        }
+        // the buffer comes from the C++ allocator, which can't map hugetlbfs pages: transparent ones are the best it gets
+        sequencePages = adviseHugePages(sequence.data(), sequence.capacity() * sizeof(int));
+        sequence.resize(size);
+        if (sequencePages != engineParameters.pages) {
+            fprintf(stderr, "%s pages not available for the sorted buffer: it uses %s ones\n", context.pages.c_str(), getPageKindName(sequencePages).c_str());
+        }
+    }
+    std::map<int, NumaNodeCounters> numaCountersBefore{};
+    if (numa) {
+        // runs copy their input in the buffer without reallocating it: its pages stay where they are placed now
+        sequence.resize(static_cast<std::size_t>(std::max(0, context.sequenceSize)));
+        numa->place(sequence, numaChunks);
+        numaCountersBefore = readNumaCounters();
+    }
+    if (context.isolation == "none") {
+        for (int run=0; run<context.runs; ++run) {
+            const std::vector<int>& input = environment.nextSequence();
+            if (!collect(executeRun(run, context, input, sequence, *alg, validator, *probe, profiler.get(), watchdog.get()))) {
+                break;
+            }
+        }
+    } else if (context.isolation == "fork") {
+        // a single child for every run: they share its heap, but not the one of the parent
+        ChildRunner child{[&](int outcomes) {
+            SchedulerProbe childProbe{};
+            std::unique_ptr<RunWatchdog> childWatchdog{};
+            if (context.runTimeout > 0) {
+                childWatchdog.reset(new RunWatchdog{context.runTimeout});
+            }
+            std::unique_ptr<SequenceValidator> childValidator{createChildValidator()};
+            for (int run=0; run<context.runs; ++run) {
+                const std::vector<int>& input = environment.nextSequence();
+                RunOutcome outcome = executeRun(run, context, input, sequence, *alg, childValidator ? *childValidator : validator, childProbe, nullptr, childWatchdog.get());
+                writeOutcome(outcomes, outcome);
+                if (outcome.record.status == RunStatus::TIMEOUT || !outcome.valid) {
+                    break;
+                }
+            }
+        }};
+        RunOutcome outcome;
+        int run = 0;
+        for (; child.read(outcome); ++run) {
+            if (!collect(outcome)) {
+                break;
+            }
+        }
+        child.finish(run);
+    } else {
+        // each run starts from the very same process: the one which generated its input
+        for (int run=0; run<context.runs; ++run) {
+            const std::vector<int>& input = environment.nextSequence();
+            ChildRunner child{[&](int outcomes) {
+                SchedulerProbe childProbe{};
+                std::unique_ptr<RunWatchdog> childWatchdog{};
+                if (context.runTimeout > 0) {
+                    childWatchdog.reset(new RunWatchdog{context.runTimeout});
+                }
+                std::unique_ptr<SequenceValidator> childValidator{createChildValidator()};
+                writeOutcome(outcomes, executeRun(run, context, input, sequence, *alg, childValidator ? *childValidator : validator, childProbe, nullptr, childWatchdog.get()));
+            }};
+            RunOutcome outcome;
+            bool reported = child.read(outcome);
+            child.finish(run);
+            if (!reported) {
+                throw std::domain_error{"the process of run " + std::to_string(run) + " exited without reporting it"};
+            }
+            if (!collect(outcome)) {
+                break;
+            }
+        }
+    }
+
+    if (results) {
+        results->close();
+    }
+
+    if (!context.noResultFiles) {
+        std::string summaryFileName{context.outputTemplate};
+        summaryFileName.append("kind:type=summary|.csv");
+        outputSuffixes.push_back("kind:type=summary|.csv");
+        FILE* summary = fopen(summaryFileName.c_str(), "w");
+        if (summary == NULL) {
+            throw std::domain_error{"can't open file"};
+        }
+        writeLatencySummary(summary, histogram);
+        fclose(summary);
+    }
+
+    if (profiler) {
+        std::string profileFileName{context.outputTemplate};
+        profileFileName.append("kind:type=profile|.folded");
+        outputSuffixes.push_back("kind:type=profile|.folded");
+        FILE* profile = fopen(profileFileName.c_str(), "w");
+        if (profile == NULL) {
+            throw std::domain_error{"can't open file"};
+        }
+        profiler->writeFoldedStacks(profile);
+        fclose(profile);
+        if (profiler->getLostSampleCount() > 0) {
+            fprintf(stderr, "profiler buffer full: %lu samples lost\n", static_cast<unsigned long>(profiler->getLostSampleCount()));
+        }
+    }
+
+    if (numa) {
+        std::string numaFileName{context.outputTemplate};
+        numaFileName.append("kind:type=numa|.csv");
+        outputSuffixes.push_back("kind:type=numa|.csv");
+        FILE* numaFile = fopen(numaFileName.c_str(), "w");
+        if (numaFile == NULL) {
+            throw std::domain_error{"can't open file"};
+        }
+        writeNumaReport(numaFile, countPagesPerNode(sequence.data(), sequence.size() * sizeof(int)), numaCountersBefore, readNumaCounters(), 1e-9 * sortNanoseconds, rows);
+        fclose(numaFile);
+    }
+
+    if (engineParameters.pages != PageKind::DEFAULT) {
+        std::string pagesFileName{context.outputTemplate};
+        pagesFileName.append("kind:type=pages|.csv");
+        outputSuffixes.push_back("kind:type=pages|.csv");
+        FILE* pagesFile = fopen(pagesFileName.c_str(), "w");
+        if (pagesFile == NULL) {
+            throw std::domain_error{"can't open file"};
+        }
+        std::size_t bytes = sequence.size() * sizeof(int);
+        std::vector<PageReport> reports{
+            PageReport{"sequence", engineParameters.pages, sequencePages, bytes, countHugePageBytes(sequence.data(), bytes)}
+        };
+        // with isolation, the engine of this process never sorted: its arena is empty
+        const ScratchArena* scratch = alg->getScratchArena();
+        if (scratch != nullptr && scratch->getMemory() != nullptr) {
+            const PageAllocation& memory = *scratch->getMemory();
+            reports.push_back(PageReport{"scratch", memory.getRequested(), memory.getObtained(), memory.getBytes(), countHugePageBytes(memory.getData(), memory.getBytes())});
+        }
+        writePagesReport(pagesFile, reports);
+        fclose(pagesFile);
+    }
+
+    int exitCode = 0;
+    if (!context.baseline.empty()) {
+        RegressionReport report = checkRegression(baseline, times, regressionThreshold, context.regressionSignificance);
+        std::string regressionFileName{context.outputTemplate};
+        regressionFileName.append("kind:type=regression|.csv");
+        outputSuffixes.push_back("kind:type=regression|.csv");
+        FILE* regression = fopen(regressionFileName.c_str(), "w");
+        if (regression == NULL) {
+            throw std::domain_error{"can't open file"};
+        }
+        writeRegressionReport(regression, report);
+        fclose(regression);
+
+        if (report.regression) {
+            fprintf(stderr, "REGRESSION: %s got slower on %s sequences of size %d: median %.3fus -> %.3fus (%+.2f%%, threshold %s, p-value %.6g)\n",
+                context.algorithm.c_str(), context.sequenceType.c_str(), context.sequenceSize,
+                report.baselineMedian, report.currentMedian, 100 * report.relativeChange,
+                context.regressionThreshold.c_str(), report.pValue
+            );
+            exitCode = REGRESSION_EXIT_CODE;
+        }
+    }
+
+    // without the main file there's nothing a later --skipIfComplete could reuse
+    if (!context.noResultFiles) {
+        writeCompletionMarker(context.outputTemplate, outputSuffixes, rows, exitCode);
+    }
+    return exitCode;
+}
@@ -0,0 +1,203 @@
+#include "TestServer.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * connections waiting for the one being served
+ */
+static const int SOCKET_BACKLOG = 16;
+
+/**
+ * Sends the runs of a request back, one line each
+ */
+class RunResponseWriter : public ResultWriter {
+public:
+    RunResponseWriter(FILE* responses, const JsonValue& id, bool streamRuns) :
+            responses{responses}, id{id}, streamRuns{streamRuns}, runs{0} {
+    }
+    virtual void write(const RunRecord& record) {
+        ++this->runs;
+        if (!this->streamRuns) {
+            return;
+        }
+        const std::vector<std::string>& names = getRunRecordColumnNames();
+        JsonValue response = JsonValue::object().set("id", this->id).set("event", "run");
+        for (int column=0; column<RUN_RECORD_INTEGER_COLUMNS; ++column) {
+            response.set(names[column], static_cast<long>(getRunRecordIntegerColumn(record, column)));
+        }
+        response.set("preempted", record.preempted);
+        response.set(names[RUN_RECORD_INTEGER_COLUMNS], getRunStatusName(record.status));
+        std::string line = response.dump();
+        fprintf(this->responses, "%s\n", line.c_str());
+        // the client sees the runs while the context is still running
+        fflush(this->responses);
+    }
+    virtual void close() {
+    }
+    long getRunCount() const {
+        return this->runs;
+    }
+private:
+    FILE* responses;
+    JsonValue id;
+    bool streamRuns;
+    long runs;
+};
+
+static void respond(FILE* responses, const JsonValue& response) {
+    std::string line = response.dump();
+    fprintf(responses, "%s\n", line.c_str());
+    fflush(responses);
+}
+
+TestServer::TestServer(TestEnvironment& environment, CampaignJournal* journal) : environment(environment), journal{journal} {
+}
+
+bool TestServer::handle(const std::string& request, FILE* responses) {
+    JsonValue id{};
+    try {
+        JsonValue parsed = JsonValue::parse(request);
+        if (!parsed.isObject()) {
+            throw std::domain_error{"a request needs to be a json object"};
+        }
+        if (parsed.has("id")) {
+            id = parsed.get("id");
+        }
+        if (parsed.has("shutdown") && parsed.get("shutdown").asBool()) {
+            respond(responses, JsonValue::object().set("id", id).set("event", "shutdown"));
+            return false;
+        }
+        bool streamRuns = !parsed.has("streamRuns") || parsed.get("streamRuns").asBool();
+
+        // a brand new context for each request: nothing leaks from the previous one
+        TestContext context{};
+        JsonValue parameters = parseTestContext(parsed, {"id", "streamRuns", "shutdown"}, context);
+        if (context.noResultFiles && !streamRuns) {
+            throw std::domain_error{"--noResultFiles needs streamRuns: the runs would be lost"};
+        }
+        int journaledExitCode;
+        if (this->journal != nullptr && this->journal->isFinished(context.outputTemplate, journaledExitCode)) {
+            respond(responses, JsonValue::object()
+                .set("id", id)
+                .set("event", "done")
+                .set("exitCode", journaledExitCode)
+                .set("runs", 0)
+                .set("skipped", true)
+            );
+            return true;
+        }
+
+        RunResponseWriter runs{responses, id, streamRuns};
+        int exitCode = executeTestContext(context, parameters, this->environment, &runs);
+        if (this->journal != nullptr) {
+            this->journal->record(context.outputTemplate, exitCode);
+        }
+        respond(responses, JsonValue::object()
+            .set("id", id)
+            .set("event", "done")
+            .set("exitCode", exitCode)
+            .set("runs", runs.getRunCount())
+        );
+    } catch (const std::exception& e) {
+        respond(responses, JsonValue::object().set("id", id).set("event", "error").set("message", e.what()));
+    }
+    return true;
+}
+
+bool TestServer::serve(FILE* requests, FILE* responses) {
+    char* line = nullptr;
+    std::size_t capacity = 0;
+    ssize_t length;
+    bool running = true;
+    while (running && (length = getline(&line, &capacity, requests)) >= 0) {
+        std::string request{line, static_cast<std::size_t>(length)};
+        if (request.find_first_not_of(" \t\r\n") == std::string::npos) {
+            continue;
+        }
+        running = this->handle(request, responses);
+    }
+    free(line);
+    return running;
+}
+
+void TestServer::serveStdio() {
+    // a client gone away is not a reason to die
+    signal(SIGPIPE, SIG_IGN);
+    // the answers keep the real stdout, while anything printed by the contexts goes to stderr
+    FILE* responses = fdopen(dup(STDOUT_FILENO), "w");
+    if (responses == nullptr) {
+        throw std::domain_error{"can't open the responses"};
+    }
+    fflush(stdout);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    this->serve(stdin, responses);
+    fclose(responses);
+}
+
+void TestServer::serveSocket(const std::string& path) {
+    signal(SIGPIPE, SIG_IGN);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::domain_error{"socket path too long: " + path};
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // a socket left behind by a server which died can be replaced, anything else can't
+    struct stat status;
+    if (lstat(path.c_str(), &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            throw std::domain_error{path + " exists and is not a socket"};
+        }
+        unlink(path.c_str());
+    }
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        throw std::domain_error{std::string{"can't create the socket: "} + strerror(errno)};
+    }
+    if (bind(server, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 || listen(server, SOCKET_BACKLOG) != 0) {
+        std::string error = strerror(errno);
+        ::close(server);
+        throw std::domain_error{"can't listen on " + path + ": " + error};
+    }
+
+    bool running = true;
+    while (running) {
+        int connection = accept(server, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        // requests and responses are buffered independently, hence they need their own descriptor
+        int duplicate = dup(connection);
+        FILE* requests = fdopen(connection, "r");
+        FILE* responses = duplicate < 0 ? nullptr : fdopen(duplicate, "w");
+        if (requests == nullptr || responses == nullptr) {
+            if (requests != nullptr) {
+                fclose(requests);
+            } else {
+                ::close(connection);
+            }
+            if (duplicate >= 0) {
+                ::close(duplicate);
+            }
+            continue;
+        }
+        running = this->serve(requests, responses);
+        fclose(responses);
+        fclose(requests);
+    }
+    ::close(server);
+    unlink(path.c_str());
+}
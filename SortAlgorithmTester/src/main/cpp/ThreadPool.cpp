@@ -0,0 +1,110 @@
+#include "ThreadPool.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <string>
+
+ThreadPool::ThreadPool(int workers) :
+        workers{}, mutex{}, batchReady{}, batchDone{}, jobs{nullptr}, nextJob{0}, pendingJobs{0}, stopping{false},
+        bound{false}, taken{} {
+    for (int i=0; i<workers; ++i) {
+        this->workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->stopping = true;
+    }
+    this->batchReady.notify_all();
+    for (auto& worker : this->workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::getWorkerCount() const {
+    return static_cast<int>(this->workers.size());
+}
+
+void ThreadPool::bindWorkers(const std::vector<std::vector<int>>& cpus) {
+    for (std::size_t i=0; i<this->workers.size() && i<cpus.size(); ++i) {
+        if (cpus[i].empty()) {
+            continue;
+        }
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (int cpu : cpus[i]) {
+            CPU_SET(cpu, &mask);
+        }
+        if (pthread_setaffinity_np(this->workers[i].native_handle(), sizeof(mask), &mask) != 0) {
+            throw std::domain_error{"can't pin worker " + std::to_string(i) + " of the thread pool"};
+        }
+    }
+    std::lock_guard<std::mutex> lock{this->mutex};
+    this->bound = true;
+}
+
+long ThreadPool::findNextJob(int worker) const {
+    if (this->jobs == nullptr) {
+        return -1;
+    }
+    if (this->bound && this->jobs->size() <= this->workers.size() + 1) {
+        std::size_t job = static_cast<std::size_t>(worker + 1);
+        return (job < this->jobs->size() && !this->taken[job]) ? static_cast<long>(job) : -1;
+    }
+    return this->nextJob < this->jobs->size() ? static_cast<long>(this->nextJob) : -1;
+}
+
+bool ThreadPool::runNextJob(std::unique_lock<std::mutex>& lock, int worker) {
+    long next = this->findNextJob(worker);
+    if (next < 0) {
+        return false;
+    }
+    std::size_t index = static_cast<std::size_t>(next);
+    this->taken[index] = true;
+    if (index >= this->nextJob) {
+        this->nextJob = index + 1;
+    }
+    const std::function<void()>& job = (*this->jobs)[index];
+    lock.unlock();
+    job();
+    lock.lock();
+    if (--this->pendingJobs == 0) {
+        this->batchDone.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::runAll(const std::vector<std::function<void()>>& jobs) {
+    if (jobs.empty()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock{this->mutex};
+    this->jobs = &jobs;
+    this->nextJob = 0;
+    this->pendingJobs = jobs.size();
+    this->taken.assign(jobs.size(), false);
+    if (jobs.size() > 1) {
+        this->batchReady.notify_all();
+    }
+    // jobs[0] is ours, and so is every job the workers are too slow to pick up
+    while (this->runNextJob(lock, -1)) {
+    }
+    this->batchDone.wait(lock, [this]() { return this->pendingJobs == 0; });
+    this->jobs = nullptr;
+}
+
+void ThreadPool::workerLoop(int worker) {
+    std::unique_lock<std::mutex> lock{this->mutex};
+    while (true) {
+        this->batchReady.wait(lock, [this, worker]() {
+            return this->stopping || this->findNextJob(worker) >= 0;
+        });
+        if (this->stopping) {
+            return;
+        }
+        this->runNextJob(lock, worker);
+    }
+}
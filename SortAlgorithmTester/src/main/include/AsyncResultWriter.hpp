@@ -0,0 +1,88 @@
+#ifndef ASYNCRESULTWRITER_HPP_
+#define ASYNCRESULTWRITER_HPP_
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <signal.h>
+#include <thread>
+
+#include "MachineTopology.hpp"
+#include "ResultWriter.hpp"
+#include "SpscRingBuffer.hpp"
+
+/**
+ * Moves the I/O of another writer to a background thread.
+ *
+ * write() only copies the record in a preallocated ring buffer (it waits only if the buffer is full); a writer thread,
+ * possibly pinned on a CPU the benchmark doesn't use, periodically drains it into the wrapped writer.
+ *
+ * If the process is killed (SIGINT, SIGTERM, SIGHUP) or crashes (SIGSEGV, SIGBUS, SIGFPE, SIGABRT, hence uncaught
+ * exceptions too), the handler lets the writer thread drain the buffer and close the wrapped writer before the signal
+ * takes its default action: the runs performed so far are not lost.
+ *
+ * Only one of them can exist at a time
+ */
+class AsyncResultWriter : public ResultWriter {
+public:
+    /**
+     * number of signals after which the buffered records are written
+     */
+    static const int TERMINATION_SIGNAL_COUNT = 7;
+
+    /**
+     * @param sink the writer to move off the benchmark thread. The new object owns it
+     * @param capacity records the ring buffer can hold. Needs to be a power of 2
+     * @param cpu CPU where the writer thread is pinned. -1 not to pin it
+     */
+    AsyncResultWriter(ResultWriter* sink, std::size_t capacity, int cpu);
+    virtual ~AsyncResultWriter();
+    AsyncResultWriter(const AsyncResultWriter& other) = delete;
+    AsyncResultWriter& operator=(const AsyncResultWriter& other) = delete;
+
+    /**
+     * @throws what the wrapped writer has thrown, if the writer thread stopped because of it while the buffer is full
+     */
+    virtual void write(const RunRecord& record);
+    /**
+     * drain the buffer, close the wrapped writer and stop the writer thread
+     *
+     * @throws what the wrapped writer has thrown, if anything
+     */
+    virtual void close();
+public:
+    /**
+     * called by the signal handler: wait (up to a few seconds) until the records have been written
+     */
+    void onTermination();
+private:
+    void drainLoop();
+    void drain();
+    void restoreSignalHandlers();
+private:
+    std::unique_ptr<ResultWriter> sink;
+    SpscRingBuffer<RunRecord> buffer;
+    int cpu;
+    std::atomic<bool> stopping;
+    std::atomic<bool> finished;
+    std::exception_ptr error;
+    bool closed;
+    std::thread writer;
+    struct sigaction previousActions[TERMINATION_SIGNAL_COUNT];
+};
+
+/**
+ * choose the CPU where to pin the writer thread: an allowed CPU on a different physical core than benchmarkCpu
+ * (so they don't share caches, either), or any other allowed CPU if there's no such core.
+ *
+ * @param allowedCpus the CPUs the process can run on
+ * @return -1 if every allowed CPU is benchmarkCpu
+ */
+int chooseWriterCpu(const MachineTopology& topology, const std::vector<int>& allowedCpus, int benchmarkCpu);
+
+/**
+ * @return the CPUs the calling thread can be scheduled on
+ */
+std::vector<int> getAllowedCpus();
+
+#endif /* ASYNCRESULTWRITER_HPP_ */
@@ -0,0 +1,88 @@
+#ifndef CHECKPOINT_HPP_
+#define CHECKPOINT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * the CRC-32 of zlib (and of python's zlib.crc32)
+ *
+ * @param crc the CRC of the bytes before data, to checksum a file a piece at a time
+ */
+uint32_t crc32(const void* data, std::size_t size, uint32_t crc = 0);
+
+/**
+ * @param size set to the bytes of the file
+ * @return the CRC-32 of the whole file
+ * @throws std::domain_error if the file can't be read
+ */
+uint32_t fileCrc32(const std::string& fileName, uint64_t& size);
+
+/**
+ * @return the name of the completion marker of a test context: outputTemplate followed by "kind:type=complete|.json"
+ */
+std::string getCompletionMarkerName(const std::string& outputTemplate);
+
+/**
+ * Write the completion marker of a test context, once every output file has been closed: a json document with the
+ * rows of the main file, the exit code of the context and, for each file, its suffix (what follows outputTemplate in
+ * its name), its bytes and its CRC-32.
+ *
+ * The marker is written in a temporary file renamed over the final one, hence it either exists whole or not at all
+ *
+ * @param suffixes of the output files, appended to outputTemplate
+ * @throws std::domain_error if a file can't be read or the marker can't be written
+ */
+void writeCompletionMarker(const std::string& outputTemplate, const std::vector<std::string>& suffixes, long rows, int exitCode);
+
+/**
+ * remove the completion marker of a test context, if any: its files are going to be written again
+ */
+void removeCompletionMarker(const std::string& outputTemplate);
+
+/**
+ * @param exitCode set to the exit code recorded in the marker, if the output is complete
+ * @return true if the marker of the test context exists and every file it lists has the bytes and the CRC-32 it records
+ */
+bool isOutputComplete(const std::string& outputTemplate, int& exitCode);
+
+/**
+ * An append-only log of the test contexts a campaign (see --manifest and --serve) has finished, so that a campaign
+ * interrupted halfway resumes where it stopped.
+ *
+ * Each line is a json object with the "outputTemplate" of a context and its "exitCode". Lines are synced on disk as
+ * soon as they are written; a line torn by a crash is ignored when the journal is loaded
+ */
+class CampaignJournal {
+public:
+    /**
+     * load the contexts already in the journal, creating it if it doesn't exist
+     *
+     * @throws std::domain_error if the journal can't be opened
+     */
+    CampaignJournal(const std::string& fileName);
+    virtual ~CampaignJournal();
+    CampaignJournal(const CampaignJournal& other) = delete;
+    CampaignJournal& operator=(const CampaignJournal& other) = delete;
+
+    /**
+     * @param exitCode set to the exit code of the context, if finished
+     * @return true if a context with the given template has been journaled and its output is still complete (see
+     *  isOutputComplete)
+     */
+    bool isFinished(const std::string& outputTemplate, int& exitCode) const;
+    /**
+     * journal a context whose output is complete. A context which failed is not journaled: it needs to run again
+     */
+    void record(const std::string& outputTemplate, int exitCode);
+    std::size_t getFinishedCount() const;
+private:
+    FILE* file;
+    std::map<std::string, int> finished;
+};
+
+#endif /* CHECKPOINT_HPP_ */
@@ -0,0 +1,80 @@
+#ifndef COMPRESSEDFILE_HPP_
+#define COMPRESSEDFILE_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+#include "Json.hpp"
+
+/**
+ * names of the codecs accepted by --compression: none, zstd and lz4
+ */
+const std::vector<std::string>& getCompressionNames();
+
+/**
+ * @return true if the tester has been built with the given codec (see THEPROJECT_ENABLE_ZSTD in CMakeLists.txt)
+ */
+bool isCompressionAvailable(const std::string& codec);
+
+/**
+ * @return the extension appended to the compressed files (".zst" or ".lz4")
+ */
+std::string getCompressionExtension(const std::string& codec);
+
+/**
+ * A file made of independently compressed chunks, so that a reader can decompress only the part it needs.
+ *
+ * Each chunk is a standard zstd (or lz4) frame, hence "zstd -d" (or "lz4 -d") decompresses the whole file. After
+ * the last chunk there is an index, stored in a skippable frame ignored by the decompressors: a json document, its
+ * length (uint32, little endian) and the magic "SORTCHK1". The document has the codec, the members of the description
+ * given to the constructor and, for each chunk, its offset, its compressed size ("size"), its decompressed size
+ * ("length") and the number of runs it holds.
+ *
+ * Bytes are written in a stdio stream and end up in the current chunk until endChunk is called
+ */
+class CompressedFile {
+public:
+    /**
+     * @param codec zstd or lz4
+     * @param description object whose members are added to the index
+     * @throws std::domain_error if the file can't be opened or the tester has been built without the codec
+     */
+    CompressedFile(const std::string& fileName, const std::string& codec, const JsonValue& description);
+    virtual ~CompressedFile();
+
+    /**
+     * @return the stream whose bytes are compressed. Whoever writes into it may fclose it: close does it otherwise
+     */
+    FILE* getStream() const;
+    /**
+     * compress everything written in the stream since the previous chunk as a new chunk
+     *
+     * @param runs number of runs the chunk holds, as recorded in the index
+     */
+    void endChunk(std::size_t runs);
+    /**
+     * compress what is left as the last chunk and write the index. Further calls do nothing
+     */
+    void close();
+private:
+    static ssize_t onStreamWrite(void* cookie, const char* data, std::size_t size);
+    static int onStreamClose(void* cookie);
+    std::string compress(const std::string& data) const;
+    void writeAll(const std::string& data);
+private:
+    FILE* file;
+    FILE* stream;
+    std::string codec;
+    JsonValue description;
+    /**
+     * bytes written in the stream and not yet compressed
+     */
+    std::string pending;
+    uint64_t position;
+    JsonValue chunks;
+};
+
+#endif /* COMPRESSEDFILE_HPP_ */
@@ -0,0 +1,34 @@
+#ifndef ENGINEPARAMETERS_HPP_
+#define ENGINEPARAMETERS_HPP_
+
+#include "HugePages.hpp"
+#include "MachineTopology.hpp"
+
+/**
+ * Tunables of the engines. Each engine reads only the ones it needs
+ */
+struct EngineParameters {
+    /**
+     * factor used to shrink the gap of COMBSORT
+     */
+    double shrinkFactor;
+    /**
+     * MERGESORT sorts subsequences up to this size with insertion sort
+     */
+    int smallSortThreshold;
+    /**
+     * RADIXSORT sorts this number of bits per pass
+     */
+    int radixDigitBits;
+    /**
+     * pages backing the scratch buffers the engines allocate (see --pages)
+     */
+    PageKind pages;
+};
+
+/**
+ * defaults of the engine tunables, suited for the given machine
+ */
+EngineParameters deriveEngineParameters(const MachineTopology& topology);
+
+#endif /* ENGINEPARAMETERS_HPP_ */
@@ -0,0 +1,68 @@
+#ifndef ENGINETUNER_HPP_
+#define ENGINETUNER_HPP_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "EngineParameters.hpp"
+
+/**
+ * Searches the tunables of an engine for the fastest configuration on a representative input.
+ *
+ * Integer tunables (smallSortThreshold, radixDigitBits) are searched on a grid with successive halving: every
+ * candidate is timed a few times, the slower half is dropped and the survivors are timed twice as much, until one
+ * remains. shrinkFactor is searched with golden-section search, assuming the sort time is unimodal in it
+ */
+class EngineTuner {
+public:
+    /**
+     * @param algorithm name of the engine to tune (e.g., MERGESORT)
+     * @param upperBound maximum number the input contains
+     * @param input the sequence each candidate sorts (a copy of it, actually)
+     * @param runs sorts timed per candidate in the first round. Its median is the time of the candidate
+     */
+    EngineTuner(const std::string& algorithm, int upperBound, const std::vector<int>& input, int runs);
+
+    /**
+     * @param start value of the tunables the algorithm doesn't use
+     * @return start with the tunables used by the algorithm replaced with the fastest found
+     * @throws std::domain_error if a candidate doesn't sort the input
+     */
+    EngineParameters tune(const EngineParameters& start);
+
+    /**
+     * @return the names of the tunables (as in EngineParameters) the engine uses. Empty if it has none
+     */
+    static std::vector<std::string> getTunables(const std::string& algorithm);
+private:
+    /**
+     * @return median sort time, in nanoseconds, of the engine with the given parameters
+     */
+    double measure(const EngineParameters& parameters, int runs);
+    int successiveHalving(EngineParameters parameters, std::vector<int> candidates, const std::function<void(EngineParameters&, int)>& apply);
+    double goldenSection(EngineParameters parameters, double lower, double upper, double tolerance, const std::function<void(EngineParameters&, double)>& apply);
+private:
+    std::string algorithm;
+    int upperBound;
+    const std::vector<int>& input;
+    int runs;
+};
+
+/**
+ * Replace the tunables present in a JSON profile written by saveTuningProfile
+ *
+ * @throws std::domain_error if the file can't be read or it isn't a valid profile
+ */
+void applyTuningProfile(const std::string& fileName, EngineParameters& parameters);
+
+/**
+ * Store the given tunables in a JSON profile. Other tunables already in the file are kept, so that profiles of
+ * different engines can be written in the same file
+ *
+ * @param tunables names of the tunables to write (see EngineTuner::getTunables)
+ * @param input description of the input the tunables have been found on
+ */
+void saveTuningProfile(const std::string& fileName, const EngineParameters& parameters, const std::vector<std::string>& tunables, const std::string& input);
+
+#endif /* ENGINETUNER_HPP_ */
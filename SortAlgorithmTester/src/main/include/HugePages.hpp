@@ -0,0 +1,112 @@
+#ifndef HUGEPAGES_HPP_
+#define HUGEPAGES_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * the pages backing the buffers the engines touch (see --pages)
+ */
+enum class PageKind {
+    /**
+     * whatever the allocator and the kernel give
+     */
+    DEFAULT,
+    /**
+     * transparent huge pages, asked with madvise(MADV_HUGEPAGE)
+     */
+    THP,
+    /**
+     * 2 MiB pages of the hugetlbfs pool (MAP_HUGETLB)
+     */
+    HUGETLB_2M,
+    /**
+     * 1 GiB pages of the hugetlbfs pool (MAP_HUGETLB)
+     */
+    HUGETLB_1G
+};
+
+/**
+ * @param name default, thp, hugetlb2M or hugetlb1G
+ * @throws std::domain_error if the name is not a kind of page
+ */
+PageKind parsePageKind(const std::string& name);
+
+/**
+ * @return the name of kind, as parsePageKind accepts it
+ */
+std::string getPageKindName(PageKind kind);
+
+/**
+ * @return the size of the huge pages of kind. For THP, the one of the machine (2 MiB if it can't be read). The base page
+ *  size for DEFAULT
+ */
+std::size_t getHugePageSize(PageKind kind);
+
+/**
+ * ask the kernel to back the whole pages of [data, data + bytes) with transparent huge pages. Only pages faulted after
+ * the call are huge from the start: the others are collapsed later, if ever
+ *
+ * @return THP if the kernel accepted the advice, DEFAULT otherwise
+ */
+PageKind adviseHugePages(void* data, std::size_t bytes);
+
+/**
+ * Anonymous memory mapped with the pages of a kind. If they aren't available (no hugetlbfs pages reserved, no THP
+ * support) it falls back to transparent huge pages and then to base pages: getObtained tells what it got.
+ *
+ * Memory is aligned to its huge pages, zeroed and not touched yet
+ */
+class PageAllocation {
+public:
+    /**
+     * @throws std::domain_error if not even base pages can be mapped
+     */
+    PageAllocation(PageKind requested, std::size_t bytes);
+    virtual ~PageAllocation();
+    PageAllocation(const PageAllocation& other) = delete;
+    PageAllocation& operator=(const PageAllocation& other) = delete;
+
+    void* getData() const;
+    /**
+     * @return the bytes asked, not the ones mapped
+     */
+    std::size_t getBytes() const;
+    PageKind getRequested() const;
+    PageKind getObtained() const;
+private:
+    bool map(PageKind kind);
+private:
+    PageKind requested;
+    PageKind obtained;
+    std::size_t bytes;
+    void* mapping;
+    std::size_t mappedBytes;
+};
+
+/**
+ * @return the bytes of [data, data + bytes) backed by huge pages (transparent or hugetlbfs), as /proc/self/smaps reports
+ *  them. The kernel counts them per mapping: a mapping only partly covered by the range counts at most the part covered
+ */
+std::size_t countHugePageBytes(const void* data, std::size_t bytes);
+
+/**
+ * What a buffer asked and got (see --pages)
+ */
+struct PageReport {
+    std::string buffer;
+    PageKind requested;
+    PageKind obtained;
+    std::size_t bytes;
+    std::size_t hugePageBytes;
+};
+
+/**
+ * write a line per buffer: the csv columns are buffer, requested, obtained, bytes, hugePages (of the size obtained)
+ * and hugePageBytes
+ */
+void writePagesReport(FILE* file, const std::vector<PageReport>& reports);
+
+#endif /* HUGEPAGES_HPP_ */
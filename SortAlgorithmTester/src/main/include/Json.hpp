@@ -0,0 +1,89 @@
+#ifndef JSON_HPP_
+#define JSON_HPP_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A minimal JSON document model, enough for the files and the messages the tester reads and writes.
+ *
+ * Numbers are stored as double; object members keep the order they have been added with
+ */
+class JsonValue {
+public:
+    enum class Type {
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+public:
+    JsonValue();
+    JsonValue(bool value);
+    JsonValue(int value);
+    JsonValue(long value);
+    JsonValue(unsigned long value);
+    JsonValue(double value);
+    JsonValue(const char* value);
+    JsonValue(const std::string& value);
+
+    static JsonValue array();
+    static JsonValue object();
+    /**
+     * @throws std::domain_error if text is not a valid JSON document
+     */
+    static JsonValue parse(const std::string& text);
+
+    Type getType() const;
+    bool isNull() const;
+    bool isObject() const;
+
+    /**
+     * @throws std::domain_error if the value has a different type
+     */
+    bool asBool() const;
+    double asNumber() const;
+    long asInt() const;
+    const std::string& asString() const;
+    const std::vector<JsonValue>& asArray() const;
+    const std::vector<std::pair<std::string, JsonValue>>& asObject() const;
+
+    bool has(const std::string& key) const;
+    /**
+     * @throws std::domain_error if the value is not an object or it has no such member
+     */
+    const JsonValue& get(const std::string& key) const;
+    /**
+     * add a member to the object (or replace it, if it already exists)
+     */
+    JsonValue& set(const std::string& key, const JsonValue& value);
+    /**
+     * add an element to the array
+     */
+    JsonValue& push(const JsonValue& value);
+
+    /**
+     * @return the value as compact JSON, on a single line
+     */
+    std::string dump() const;
+private:
+    void dump(std::string& out) const;
+    void checkType(Type expected) const;
+private:
+    Type type;
+    bool boolean;
+    double number;
+    std::string string;
+    std::vector<JsonValue> elements;
+    std::vector<std::pair<std::string, JsonValue>> members;
+};
+
+/**
+ * append s to out as a quoted JSON string
+ */
+void appendJsonString(std::string& out, const std::string& s);
+
+#endif /* JSON_HPP_ */
@@ -0,0 +1,67 @@
+#ifndef LATENCYHISTOGRAM_HPP_
+#define LATENCYHISTOGRAM_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * A log-bucketed histogram in the style of HdrHistogram (http://hdrhistogram.org/).
+ *
+ * Values are integers (e.g., nanoseconds). Each power of 2 is split in linear sub-buckets, so that the value of a
+ * bucket is within the requested number of significant digits from the values recorded in it.
+ * Recording a value costs a couple of bit operations and a single increment, hence it can be used inside the run loop.
+ *
+ * Mean and standard deviation are computed exactly (not from the buckets)
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @param highestTrackableValue the maximum value we can put in a bucket. Bigger values are recorded in the last bucket
+     *  (but they still contribute to getMax(), getMean() and getStdDev())
+     * @param significantDigits number of significant decimal digits to keep, between 1 and 5
+     */
+    LatencyHistogram(uint64_t highestTrackableValue, int significantDigits);
+    virtual ~LatencyHistogram() {}
+
+    void record(uint64_t value);
+    void reset();
+
+    uint64_t getTotalCount() const;
+    uint64_t getMin() const;
+    uint64_t getMax() const;
+    double getMean() const;
+    double getStdDev() const;
+    /**
+     * @param percentile a number in [0, 100]
+     * @return the largest value equivalent (within the precision) to the one at the given percentile
+     */
+    uint64_t getValueAtPercentile(double percentile) const;
+private:
+    int getBucketIndex(uint64_t value) const;
+    std::size_t getCountsIndex(uint64_t value) const;
+    uint64_t getHighestEquivalentValue(std::size_t countsIndex) const;
+private:
+    uint64_t highestTrackableValue;
+    int subBucketHalfCountMagnitude;
+    uint64_t subBucketHalfCount;
+    uint64_t subBucketMask;
+    std::vector<uint64_t> counts;
+
+    uint64_t totalCount;
+    uint64_t min;
+    uint64_t max;
+    /**
+     * running mean and sum of squared differences (Welford's algorithm)
+     */
+    double mean;
+    double m2;
+};
+
+/**
+ * Write the summary of a histogram of times (in nanoseconds) as a csv with header "runs,mean,stddev,p50,p90,p99,p999,max".
+ * Times are written in microseconds, like the "time" column of the main csv
+ */
+void writeLatencySummary(FILE* f, const LatencyHistogram& histogram);
+
+#endif /* LATENCYHISTOGRAM_HPP_ */
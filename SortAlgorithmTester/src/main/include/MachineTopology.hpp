@@ -0,0 +1,73 @@
+#ifndef MACHINETOPOLOGY_HPP_
+#define MACHINETOPOLOGY_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * where a logical CPU is located
+ */
+struct CpuLocation {
+    int cpu;
+    /**
+     * id of the physical core. Unique only within the same package
+     */
+    int core;
+    int package;
+    int node;
+};
+
+/**
+ * Caches, cores and NUMA nodes of the machine
+ */
+struct MachineTopology {
+    /**
+     * sizes of the caches, in bytes
+     */
+    long l1DataCacheSize;
+    long l2CacheSize;
+    long lastLevelCacheSize;
+    /**
+     * bytes
+     */
+    int cacheLineSize;
+    int numaNodes;
+    /**
+     * every online logical CPU
+     */
+    std::vector<CpuLocation> cpus;
+
+    int getLogicalCores() const;
+    int getPhysicalCores() const;
+};
+
+/**
+ * detect the topology from sysfs. What can't be read is given a conservative default
+ *
+ * @param sysfsCpuRoot the folder containing the cpuN folders (usually /sys/devices/system/cpu)
+ * @param sysfsNodeRoot the folder containing the nodeN folders (usually /sys/devices/system/node)
+ */
+MachineTopology probeMachineTopology(const std::string& sysfsCpuRoot = "/sys/devices/system/cpu", const std::string& sysfsNodeRoot = "/sys/devices/system/node");
+
+/**
+ * write the topology as "key=value" lines, so it can be reused by loadMachineTopology
+ */
+void saveMachineTopology(const std::string& fileName, const MachineTopology& topology);
+
+/**
+ * @throws std::domain_error if the file can't be read
+ */
+MachineTopology loadMachineTopology(const std::string& fileName);
+
+/**
+ * load the topology from cacheFileName if it exists; probe it and save it there otherwise.
+ * If cacheFileName is empty, the topology is always probed
+ */
+MachineTopology getMachineTopology(const std::string& cacheFileName);
+
+/**
+ * parse a cpu list like "0-3,8,10-11"
+ */
+std::vector<int> parseCpuList(const std::string& cpuList);
+
+#endif /* MACHINETOPOLOGY_HPP_ */
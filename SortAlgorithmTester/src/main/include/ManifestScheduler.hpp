@@ -0,0 +1,118 @@
+#ifndef MANIFESTSCHEDULER_HPP_
+#define MANIFESTSCHEDULER_HPP_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Json.hpp"
+#include "Checkpoint.hpp"
+#include "MachineTopology.hpp"
+#include "TestContext.hpp"
+
+/**
+ * What a test context of a manifest needs for itself
+ */
+enum class Placement {
+    /**
+     * a physical core (with its hyperthreads): what a single threaded engine needs
+     */
+    CORE,
+    /**
+     * every core of a package, so that a parallel engine shares neither its cores nor its last level cache
+     */
+    SOCKET
+};
+
+/**
+ * @param name either "core" or "socket"
+ * @throws std::domain_error if the name is unknown
+ */
+Placement parsePlacement(const std::string& name);
+
+/**
+ * A physical core the contexts can be scheduled on
+ */
+struct CoreSlot {
+    int package;
+    /**
+     * the logical CPUs of the core, ascending
+     */
+    std::vector<int> cpus;
+};
+
+/**
+ * group the allowed CPUs by physical core, ordered by package and core. A CPU the topology doesn't know is a core on
+ * its own, in package 0
+ */
+std::vector<CoreSlot> getCoreSlots(const MachineTopology& topology, const std::vector<int>& allowedCpus);
+
+/**
+ * Hands out disjoint sets of cores: no core is given to two contexts at the same time
+ */
+class CoreScheduler {
+public:
+    CoreScheduler(const std::vector<CoreSlot>& cores);
+    virtual ~CoreScheduler() {}
+
+    /**
+     * reserve a free core (CORE) or every core of a package none of whose cores is reserved (SOCKET)
+     *
+     * @return the indices of the cores reserved, empty if the placement can't be satisfied right now
+     */
+    std::vector<std::size_t> acquire(Placement placement);
+    void release(const std::vector<std::size_t>& cores);
+    /**
+     * @return the logical CPUs of the given cores
+     */
+    std::vector<int> getCpus(const std::vector<std::size_t>& cores) const;
+    std::size_t getCoreCount() const;
+    std::size_t getFreeCoreCount() const;
+private:
+    std::vector<CoreSlot> cores;
+    std::vector<bool> reserved;
+};
+
+/**
+ * A line of a manifest
+ */
+struct ManifestEntry {
+    /**
+     * line of the manifest the context comes from, starting from 1
+     */
+    int line;
+    TestContext context;
+    /**
+     * the options the context has been built from (see describeCommandLine)
+     */
+    JsonValue parameters;
+    Placement placement;
+};
+
+/**
+ * read a manifest: a test context per line, as a json object with the members of a --serve request (see TestServer)
+ * plus "placement", either "core" or "socket". Without it, a context gets a socket if its engine comes from a plugin
+ * declaring SORT_PLUGIN_PARALLEL, a core otherwise. Blank lines are skipped
+ *
+ * @throws std::domain_error if the file can't be read or a line is not a valid context. The message has the line
+ */
+std::vector<ManifestEntry> readManifest(const std::string& fileName);
+
+/**
+ * execute every context of a manifest, each one in a process of its own pinned on the cores the scheduler gave it.
+ * Contexts are started in the order of the manifest, as soon as their placement can be satisfied: a context waiting
+ * for a socket is not overtaken by the ones after it. The validation threads of a context are capped to its CPUs.
+ *
+ * When a context ends, a json line is written in report: its "line", its "outputTemplate", the "cpus" it had, its
+ * "exitCode" (as the tester would have returned, 128 + the signal if it has been killed) and the "seconds" it took.
+ *
+ * With a journal, the contexts it has as finished are not executed again: their line has "skipped" true and the exit
+ * code they had. The contexts which succeed (or regress) are journaled as soon as they end
+ *
+ * @param journal may be null
+ * @return 0 if every context succeeded, REGRESSION_EXIT_CODE if some of them regressed and none failed, 1 otherwise
+ * @throws std::domain_error if there are no cores or a context can't be started
+ */
+int runManifest(const std::vector<ManifestEntry>& entries, const std::vector<CoreSlot>& cores, FILE* report, CampaignJournal* journal = nullptr);
+
+#endif /* MANIFESTSCHEDULER_HPP_ */
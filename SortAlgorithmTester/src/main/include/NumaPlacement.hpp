@@ -0,0 +1,152 @@
+#ifndef NUMAPLACEMENT_HPP_
+#define NUMAPLACEMENT_HPP_
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sched.h>
+
+#include "MachineTopology.hpp"
+
+/**
+ * where the pages of the buffer the runs sort live (see --numa)
+ */
+enum class NumaPolicy {
+    /**
+     * wherever the kernel put them, usually the node of the thread which first touched them
+     */
+    NONE,
+    /**
+     * spread page by page over every node
+     */
+    INTERLEAVE,
+    /**
+     * on the node of the sorting thread, which is pinned there
+     */
+    LOCAL,
+    /**
+     * each chunk the validation threads split the buffer in (see getValidationChunks) on the node of the thread
+     * processing it, as if that thread touched it first. Threads are pinned on their node
+     */
+    FIRST_TOUCH_PARALLEL
+};
+
+/**
+ * @param name none, interleave, local or firstTouchParallel
+ * @throws std::domain_error if the name is not a policy
+ */
+NumaPolicy parseNumaPolicy(const std::string& name);
+
+/**
+ * Places a buffer over the NUMA nodes of the CPUs the tester can use, with the mbind system call (no libnuma needed),
+ * and tells where the threads touching it need to run.
+ *
+ * Pages already allocated are moved as well, so the buffer can be placed after it has been filled
+ */
+class NumaPlacement {
+public:
+    /**
+     * @param allowedCpus the CPUs the tester can run on (see getAllowedCpus)
+     * @param currentCpu the CPU of the sorting thread: its node is the local one
+     */
+    NumaPlacement(NumaPolicy policy, const MachineTopology& topology, const std::vector<int>& allowedCpus, int currentCpu);
+    virtual ~NumaPlacement() {}
+
+    NumaPolicy getPolicy() const;
+    /**
+     * @return the nodes the buffer is placed on: the local one first
+     */
+    const std::vector<int>& getNodes() const;
+    /**
+     * @param chunks how the buffer is split among the threads processing it
+     * @return the node of each chunk. -1 for a chunk not placed on a single node (interleave)
+     */
+    std::vector<int> getChunkNodes(std::size_t chunks) const;
+    /**
+     * @return the CPUs of the calling thread, which processes the first chunk. Empty if it needs not to be pinned
+     */
+    std::vector<int> getCallerCpus() const;
+    /**
+     * @return the CPUs of each worker of a ThreadPool, worker i processing chunk i+1. Empty if they need not to be pinned
+     */
+    std::vector<std::vector<int>> getWorkerCpus(std::size_t chunks) const;
+    /**
+     * move the pages of buffer where the policy says
+     *
+     * @param chunks the partition of buffer among the threads processing it, in elements (see getValidationChunks)
+     * @throws std::domain_error if the kernel refuses to place the pages
+     */
+    void place(std::vector<int>& buffer, const std::vector<std::pair<std::size_t, std::size_t>>& chunks) const;
+private:
+    std::vector<int> getNodeCpus(int node) const;
+    /**
+     * mbind [data, data + bytes), widened to whole pages
+     */
+    void bind(const void* data, std::size_t bytes, int mode, const std::vector<int>& nodes) const;
+private:
+    NumaPolicy policy;
+    std::vector<int> nodes;
+    /**
+     * the allowed CPUs of each node
+     */
+    std::map<int, std::vector<int>> cpus;
+};
+
+/**
+ * Pins the calling thread on some CPUs and restores its previous affinity when destroyed
+ */
+class ThreadAffinityGuard {
+public:
+    /**
+     * @param cpus if empty, the thread is left as it is
+     * @throws std::domain_error if the thread can't be pinned
+     */
+    ThreadAffinityGuard(const std::vector<int>& cpus);
+    virtual ~ThreadAffinityGuard();
+    ThreadAffinityGuard(const ThreadAffinityGuard& other) = delete;
+    ThreadAffinityGuard& operator=(const ThreadAffinityGuard& other) = delete;
+private:
+    bool pinned;
+    cpu_set_t previous;
+};
+
+/**
+ * @return the number of pages of [data, data + bytes) on each node, as the kernel reports them (move_pages). Pages never
+ *  touched are not counted
+ */
+std::map<int, long> countPagesPerNode(const void* data, std::size_t bytes);
+
+/**
+ * Allocation counters of a node, from /sys/devices/system/node/nodeN/numastat
+ */
+struct NumaNodeCounters {
+    /**
+     * pages allocated on the node by a thread running on it
+     */
+    long localNode;
+    /**
+     * pages allocated on the node by a thread running on another node
+     */
+    long otherNode;
+};
+
+/**
+ * @return the counters of every node. Empty if they can't be read
+ */
+std::map<int, NumaNodeCounters> readNumaCounters(const std::string& sysfsNodeRoot = "/sys/devices/system/node");
+
+/**
+ * write, for each node, where the sorted buffer lived and how fast its part of it has been sorted: the csv columns are
+ * node, pages, bytes, bytesPerSecond (bytes of the node sorted per second of sort), localAllocations and
+ * remoteAllocations (the numastat counters of the node during the runs)
+ *
+ * @param sortSeconds total time spent sorting
+ * @param runs the sorts timed
+ */
+void writeNumaReport(FILE* file, const std::map<int, long>& pages, const std::map<int, NumaNodeCounters>& before, const std::map<int, NumaNodeCounters>& after, double sortSeconds, long runs);
+
+#endif /* NUMAPLACEMENT_HPP_ */
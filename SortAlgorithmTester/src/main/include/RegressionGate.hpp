@@ -0,0 +1,78 @@
+#ifndef REGRESSIONGATE_HPP_
+#define REGRESSIONGATE_HPP_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Times of a previous execution of the same configuration
+ */
+struct Baseline {
+    /**
+     * time of every run, in microseconds. Empty if the baseline is a summary
+     */
+    std::vector<double> samples;
+    /**
+     * median time, in microseconds
+     */
+    double median;
+};
+
+/**
+ * load a baseline from a file previously generated by the tester.
+ *
+ * The file can either be a main csv (we use its "time" column) or a summary csv (we use its "p50" column).
+ * Only the former allows to run a statistical test
+ *
+ * @throws std::domain_error if the file can't be read or has none of the columns
+ */
+Baseline loadBaseline(const std::string& fileName);
+
+/**
+ * parse a threshold like "5%" or "0.05"
+ *
+ * @return the threshold as a fraction (e.g., 0.05)
+ * @throws std::domain_error if the string is not a non negative number
+ */
+double parseThreshold(const std::string& threshold);
+
+double computeMedian(std::vector<double> samples);
+
+/**
+ * one-sided Mann-Whitney U test (normal approximation, with tie and continuity correction)
+ *
+ * @return the p-value of the null hypothesis "current is not stochastically greater than baseline"
+ */
+double mannWhitneyUGreaterPValue(const std::vector<double>& current, const std::vector<double>& baseline);
+
+struct RegressionReport {
+    double baselineMedian;
+    double currentMedian;
+    /**
+     * (currentMedian - baselineMedian) / baselineMedian
+     */
+    double relativeChange;
+    /**
+     * p-value of the Mann-Whitney U test, -1 if the baseline has no samples
+     */
+    double pValue;
+    /**
+     * true if the median grew more than the threshold and (if we could test it) the growth is significant
+     */
+    bool regression;
+};
+
+/**
+ * @param current time of every run of this execution, in microseconds
+ * @param threshold maximum relative growth of the median we accept (e.g., 0.05)
+ * @param significance the Mann-Whitney U test p-value below which we consider the growth significant
+ */
+RegressionReport checkRegression(const Baseline& baseline, const std::vector<double>& current, double threshold, double significance);
+
+/**
+ * write the report as a csv with header "baselineMedian,currentMedian,relativeChange,pValue,regression"
+ */
+void writeRegressionReport(FILE* f, const RegressionReport& report);
+
+#endif /* REGRESSIONGATE_HPP_ */
@@ -0,0 +1,338 @@
+#ifndef RESULTWRITER_HPP_
+#define RESULTWRITER_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Json.hpp"
+
+enum class RunStatus : unsigned char {
+    /**
+     * the sort completed and its output has been validated
+     */
+    OK = 0,
+    /**
+     * the sort has been abandoned by the watchdog
+     */
+    TIMEOUT = 1
+};
+
+const char* getRunStatusName(RunStatus status);
+
+/**
+ * Outcome of a single run: a row of the main result file
+ */
+struct RunRecord {
+    long run;
+    /**
+     * sort time, in microseconds
+     */
+    long time;
+    long voluntaryContextSwitches;
+    long involuntaryContextSwitches;
+    long cpuMigrations;
+    /**
+     * nanoseconds spent waiting on a run queue
+     */
+    long runQueueDelay;
+    bool preempted;
+    /**
+     * time spent checking the output, in microseconds
+     */
+    long validationTime;
+    RunStatus status;
+};
+
+/**
+ * number of integer columns of a RunRecord. Every column but "status" is an integer one
+ */
+const int RUN_RECORD_INTEGER_COLUMNS = 8;
+
+/**
+ * names of the columns of RunRecord, as in the header of the main csv. "status" is the last one
+ */
+const std::vector<std::string>& getRunRecordColumnNames();
+
+/**
+ * @param column index of an integer column, in [0, RUN_RECORD_INTEGER_COLUMNS)
+ */
+int64_t getRunRecordIntegerColumn(const RunRecord& record, int column);
+
+/**
+ * Layout of the typed columns used by the binary and shared memory formats: every integer column (int64) and then
+ * status (uint8 codes), each one starting on a cache line
+ *
+ * @param capacity rows each column can hold
+ * @param start offset of the first column
+ * @param end set to the offset of the first byte after the last column
+ * @return the offset of each column, in the order of getRunRecordColumnNames
+ */
+std::vector<uint64_t> getColumnarLayout(std::size_t capacity, uint64_t start, uint64_t& end);
+
+/**
+ * @return a json array describing each column of the layout: its name, its numpy dtype, its offset and, for status,
+ *  the "categories" its codes refer to
+ */
+JsonValue describeColumnarLayout(const std::vector<uint64_t>& offsets);
+
+/**
+ * Where the outcomes of the runs are stored
+ */
+class ResultWriter {
+public:
+    virtual ~ResultWriter() {}
+    virtual void write(const RunRecord& record) = 0;
+    /**
+     * write what is still buffered and close the file. Further calls do nothing
+     */
+    virtual void close() = 0;
+};
+
+/**
+ * One line per run, formatted as soon as the record is written
+ */
+class CsvResultWriter : public ResultWriter {
+public:
+    CsvResultWriter(const std::string& fileName);
+    /**
+     * @param file stream the writer owns (and closes)
+     */
+    CsvResultWriter(FILE* file);
+    virtual ~CsvResultWriter();
+    virtual void write(const RunRecord& record);
+    virtual void close();
+private:
+    FILE* file;
+};
+
+/**
+ * One json object per line and per run: the columns of the main csv plus the members of a metadata object, so that
+ * every line describes its run by itself
+ */
+class JsonlResultWriter : public ResultWriter {
+public:
+    /**
+     * @param metadata object whose members are added to every record
+     */
+    JsonlResultWriter(const std::string& fileName, const JsonValue& metadata);
+    /**
+     * @param file stream the writer owns (and closes)
+     */
+    JsonlResultWriter(FILE* file, const JsonValue& metadata);
+    virtual ~JsonlResultWriter();
+    virtual void write(const RunRecord& record);
+    virtual void close();
+private:
+    FILE* file;
+    /**
+     * the members of the metadata, already serialized (without braces)
+     */
+    std::string metadata;
+};
+
+/**
+ * Writers which transpose the records into columns: records are kept in memory and handed to flushBlock every
+ * blockSize of them
+ */
+class BlockResultWriter : public ResultWriter {
+public:
+    BlockResultWriter(std::size_t blockSize);
+    virtual ~BlockResultWriter() {}
+    virtual void write(const RunRecord& record);
+protected:
+    /**
+     * hand the buffered records to flushBlock, if any
+     */
+    void flush();
+    virtual void flushBlock(const std::vector<RunRecord>& block) = 0;
+private:
+    std::size_t blockSize;
+    std::vector<RunRecord> block;
+};
+
+/**
+ * Typed columns laid out contiguously, so that numpy can memory map each of them.
+ *
+ * The file starts with a 4096 bytes header: the magic "SORTCOL1", the length of a json document (uint64, little
+ * endian) and the document itself, padded with spaces. The document has the number of rows and, for each column,
+ * its name, its numpy dtype and the offset of its first byte in the file. "status" is stored as uint8 codes of the
+ * "categories" listed in its column.
+ *
+ * Space for the columns is reserved upfront, hence the writer can't store more than capacity rows
+ */
+class BinaryResultWriter : public BlockResultWriter {
+public:
+    BinaryResultWriter(const std::string& fileName, std::size_t capacity);
+    virtual ~BinaryResultWriter();
+    virtual void close();
+protected:
+    virtual void flushBlock(const std::vector<RunRecord>& block);
+private:
+    void writeAt(const void* data, std::size_t size, uint64_t offset);
+    void writeHeader();
+private:
+    int fd;
+    std::size_t capacity;
+    std::size_t rows;
+    std::vector<uint64_t> columnOffsets;
+};
+
+/**
+ * Arrow IPC file format (the ".arrow"/Feather V2 one, without compression): a record batch per block.
+ *
+ * "status" is a utf8 column, every other column is an int64 one
+ */
+class ArrowResultWriter : public BlockResultWriter {
+public:
+    ArrowResultWriter(const std::string& fileName);
+    /**
+     * @param file stream the writer owns (and closes)
+     */
+    ArrowResultWriter(FILE* file);
+    virtual ~ArrowResultWriter();
+    virtual void close();
+protected:
+    virtual void flushBlock(const std::vector<RunRecord>& block);
+private:
+    /**
+     * write an encapsulated message (continuation marker, length and flatbuffer), padded to 8 bytes
+     *
+     * @return the bytes written
+     */
+    std::size_t writeMessage(const std::string& flatbuffer);
+    /**
+     * write the buffered records, the end of stream marker and the footer
+     */
+    void writeFooter();
+    void writePadded(const void* data, std::size_t size);
+private:
+    FILE* file;
+    uint64_t position;
+    /**
+     * offset, metadata length and body length of every record batch written, needed by the footer
+     */
+    std::vector<uint64_t> batchOffsets;
+    std::vector<uint64_t> batchMetadataLengths;
+    std::vector<uint64_t> batchBodyLengths;
+};
+
+/**
+ * The binary columns, in a POSIX shared memory segment rather than in a file, so that the harness can read them
+ * without any file.
+ *
+ * The segment starts with a 4096 bytes header: the magic "SORTSHM1", the number of rows written so far (uint64,
+ * updated after each record), a flag (uint64) set to 1 when the writer is closed, the length of a json document
+ * (uint64) and the document itself. The document has the capacity and the columns, as in BinaryResultWriter.
+ *
+ * The segment is not removed: the reader owns it and needs to shm_unlink it
+ */
+class ShmResultWriter : public ResultWriter {
+public:
+    /**
+     * @param name of the segment, as in shm_open. A leading "/" is added if missing
+     * @param capacity rows the segment can hold
+     */
+    ShmResultWriter(const std::string& name, std::size_t capacity);
+    virtual ~ShmResultWriter();
+    virtual void write(const RunRecord& record);
+    virtual void close();
+private:
+    char* memory;
+    std::size_t size;
+    std::size_t capacity;
+    std::size_t rows;
+    std::vector<uint64_t> columnOffsets;
+};
+
+class CompressedFile;
+
+/**
+ * A row oriented writer whose bytes are compressed in chunks of runsPerChunk runs (see CompressedFile).
+ *
+ * The first chunk holds what the format writes before the first run (the csv header, the arrow schema). Chunk k
+ * (k >= 1) holds the runs in [(k-1) * runsPerChunk, k * runsPerChunk); the last one holds what the format writes when
+ * closed as well (the arrow footer). The index records runsPerChunk and the format
+ */
+class CompressedResultWriter : public ResultWriter {
+public:
+    /**
+     * @param file the compressed file. The writer owns it
+     * @param writer writer of the format, writing in the stream of file. The writer owns it
+     */
+    CompressedResultWriter(CompressedFile* file, ResultWriter* writer, std::size_t runsPerChunk);
+    virtual ~CompressedResultWriter();
+    virtual void write(const RunRecord& record);
+    virtual void close();
+private:
+    CompressedFile* file;
+    ResultWriter* writer;
+    std::size_t runsPerChunk;
+    std::size_t runsInChunk;
+};
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+/**
+ * Runs inserted into a SQLite database, so that many executions (even concurrent ones) can share one indexed file.
+ *
+ * The schema is normalized: the execution is a row of "configurations" (algorithm, sequence, seed and, as json, the
+ * whole metadata) and each run is a row of "runs" referring to it. The database is in WAL mode, and runs are inserted
+ * with a prepared statement, one transaction per block. Concurrent writers wait for each other for up to a minute.
+ *
+ * Available only if the tester has been built with SQLite (see THEPROJECT_ENABLE_SQLITE in CMakeLists.txt)
+ */
+class SqliteResultWriter : public BlockResultWriter {
+public:
+    /**
+     * @param fileName the database. Created (with its schema) if it doesn't exist
+     * @param metadata object describing the execution (see --outputFormat=jsonl). The configuration columns are
+     *  taken from its "parameters" member
+     * @throws std::domain_error if the database can't be opened or the tester has been built without SQLite
+     */
+    SqliteResultWriter(const std::string& fileName, const JsonValue& metadata);
+    virtual ~SqliteResultWriter();
+    virtual void close();
+
+    /**
+     * @return the id of the row of "configurations" the runs refer to
+     */
+    long getConfigurationId() const;
+protected:
+    virtual void flushBlock(const std::vector<RunRecord>& block);
+private:
+    void execute(const std::string& sql);
+private:
+    sqlite3* database;
+    sqlite3_stmt* insertRun;
+    long configurationId;
+};
+
+/**
+ * names of the formats createResultWriter accepts
+ */
+const std::vector<std::string>& getResultFormatNames();
+
+/**
+ * @param format either csv, jsonl, binary or arrow
+ * @param compression one of getCompressionNames()
+ * @return what createResultWriter appends to the output template to name the main file
+ * @throws std::domain_error if the format is unknown
+ */
+std::string getResultFileSuffix(const std::string& format, const std::string& compression = "none");
+
+/**
+ * @param format either csv, jsonl, binary or arrow
+ * @param outputTemplate prefix of the file name
+ * @param expectedRuns runs the writer will receive at most
+ * @param metadata object describing the execution (parameters, build, host). Only jsonl stores it
+ * @param compression one of getCompressionNames(). Binary results can't be compressed: they are memory mapped
+ * @return a writer of the "kind:type=main" file, with the extension of the format (followed by the one of the
+ *  compression, if any). The caller owns it
+ * @throws std::domain_error if the format is unknown, the compression is unavailable or the file can't be opened
+ */
+ResultWriter* createResultWriter(const std::string& format, const std::string& outputTemplate, std::size_t expectedRuns, const JsonValue& metadata = JsonValue::object(), const std::string& compression = "none");
+
+#endif /* RESULTWRITER_HPP_ */
@@ -0,0 +1,22 @@
+#ifndef RUNMETADATA_HPP_
+#define RUNMETADATA_HPP_
+
+#include <string>
+
+#include "Json.hpp"
+
+/**
+ * how the tester has been built: git revision, build type (Debug, Release or None), compiler and compiler flags
+ */
+JsonValue getBuildMetadata();
+
+/**
+ * where and when the tester runs: host name, kernel, CPU model, frequency of the current CPU (in MHz) and UTC
+ * timestamp (ISO 8601). What can't be read is null
+ *
+ * @param procRoot the folder where procfs is mounted (usually /proc)
+ * @param sysfsCpuRoot the folder containing the cpuN folders (usually /sys/devices/system/cpu)
+ */
+JsonValue getHostMetadata(const std::string& procRoot = "/proc", const std::string& sysfsCpuRoot = "/sys/devices/system/cpu");
+
+#endif /* RUNMETADATA_HPP_ */
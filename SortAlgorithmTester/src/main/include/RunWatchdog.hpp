@@ -0,0 +1,48 @@
+#ifndef RUNWATCHDOG_HPP_
+#define RUNWATCHDOG_HPP_
+
+#include <csetjmp>
+#include <csignal>
+#include <functional>
+#include <signal.h>
+#include <sys/types.h>
+
+/**
+ * Abandons a job which runs for too long.
+ *
+ * The watchdog arms setitimer(ITIMER_REAL) before the job: if the timer expires, the SIGALRM handler jumps out of the
+ * job (siglongjmp) back into run(). The job is not unwound: destructors of its frames are not called, hence it should
+ * not allocate memory or acquire locks (sorting engines don't do it in sort()).
+ *
+ * Only one watchdog can exist at a time and only the thread which created it can call run()
+ */
+class RunWatchdog {
+public:
+    /**
+     * @param timeout seconds of wall clock time after which the job is abandoned
+     */
+    RunWatchdog(double timeout);
+    virtual ~RunWatchdog();
+    RunWatchdog(const RunWatchdog& other) = delete;
+    RunWatchdog& operator=(const RunWatchdog& other) = delete;
+
+    /**
+     * @return true if the job completed, false if it has been abandoned
+     */
+    bool run(const std::function<void()>& job);
+public:
+    /**
+     * called by the signal handler
+     */
+    void onTimeout();
+private:
+    void setTimer(long microseconds);
+private:
+    long timeoutMicroseconds;
+    pid_t tid;
+    volatile sig_atomic_t running;
+    sigjmp_buf environment;
+    struct sigaction previousAction;
+};
+
+#endif /* RUNWATCHDOG_HPP_ */
@@ -0,0 +1,78 @@
+#ifndef SAMPLINGPROFILER_HPP_
+#define SAMPLINGPROFILER_HPP_
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <signal.h>
+#include <sys/types.h>
+
+/**
+ * A statistical CPU profiler based on SIGPROF.
+ *
+ * While armed, setitimer(ITIMER_PROF) interrupts the thread which created the profiler every 1/frequency seconds of
+ * CPU time and the signal handler stores its call stack in a preallocated buffer. Stacks are walked via frame pointers
+ * (hence the code needs to be compiled with -fno-omit-frame-pointer), falling back to backtrace() where we can't.
+ *
+ * The profiler is meant to be armed only around the code to profile: the time left to the next sample when disarming
+ * is kept, so that code shorter than the sampling period is still sampled over several arm/disarm cycles.
+ *
+ * Samples are written as "folded stacks" (see https://github.com/brendangregg/FlameGraph), which can be turned into a
+ * flame graph by flamegraph.pl.
+ *
+ * Only one profiler can exist at a time
+ */
+class SamplingProfiler {
+public:
+    /**
+     * @param frequency number of samples per second of CPU time
+     * @param maxSamples samples taken after the buffer is full are counted but lost
+     * @param maxDepth maximum number of frames stored per sample
+     */
+    SamplingProfiler(int frequency, std::size_t maxSamples, int maxDepth);
+    virtual ~SamplingProfiler();
+    SamplingProfiler(const SamplingProfiler& other) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler& other) = delete;
+
+    void arm();
+    void disarm();
+
+    std::size_t getSampleCount() const;
+    std::size_t getLostSampleCount() const;
+    /**
+     * write a line "frame1;frame2;...;frameN count" per distinct stack, outermost frame first
+     */
+    void writeFoldedStacks(FILE* f) const;
+public:
+    /**
+     * called by the signal handler
+     */
+    void takeSample(void* context);
+private:
+    int frequency;
+    std::size_t maxSamples;
+    int maxDepth;
+    /**
+     * thread which is profiled
+     */
+    pid_t tid;
+    /**
+     * bounds of the stack of the profiled thread: frame pointers outside it are garbage
+     */
+    uintptr_t stackLow;
+    uintptr_t stackHigh;
+    /**
+     * maxSamples * maxDepth return addresses
+     */
+    std::vector<uintptr_t> frames;
+    std::vector<int> depths;
+    volatile std::size_t sampleCount;
+    volatile std::size_t lostSampleCount;
+    /**
+     * microseconds of CPU time to the next sample, when disarmed
+     */
+    long remainingMicroseconds;
+    struct sigaction previousAction;
+};
+
+#endif /* SAMPLINGPROFILER_HPP_ */
@@ -0,0 +1,70 @@
+#ifndef SCHEDULERMETRICS_HPP_
+#define SCHEDULERMETRICS_HPP_
+
+#include <cstdint>
+
+/**
+ * Counters telling how much the scheduler interfered with the calling thread.
+ *
+ * A sample on its own is meaningless: take one before and one after the code to measure and subtract them
+ */
+struct SchedulerSample {
+    /**
+     * number of times the thread gave up the CPU (e.g., blocking on I/O)
+     */
+    long voluntaryContextSwitches;
+    /**
+     * number of times the thread has been preempted
+     */
+    long involuntaryContextSwitches;
+    /**
+     * number of times the thread moved to another CPU. -1 if not available on this system
+     */
+    long cpuMigrations;
+    /**
+     * nanoseconds spent runnable but waiting on a run queue. -1 if not available on this system
+     */
+    int64_t runQueueDelay;
+
+    /**
+     * true if the scheduler took the CPU away from the thread or moved it to another CPU
+     */
+    bool isPreempted() const;
+};
+
+SchedulerSample operator-(const SchedulerSample& after, const SchedulerSample& before);
+
+/**
+ * Reads the scheduler counters of the thread which created it.
+ *
+ * Context switches come from getrusage; CPU migrations from a perf software counter or, where perf is forbidden,
+ * from /proc/thread-self/sched; run queue delay from /proc/thread-self/schedstat.
+ * Files are opened once, so that sampling does not allocate
+ */
+class SchedulerProbe {
+public:
+    SchedulerProbe();
+    virtual ~SchedulerProbe();
+    SchedulerProbe(const SchedulerProbe& other) = delete;
+    SchedulerProbe& operator=(const SchedulerProbe& other) = delete;
+
+    SchedulerSample sample() const;
+private:
+    long readMigrations() const;
+    int64_t readRunQueueDelay() const;
+private:
+    /**
+     * perf event counting CPU migrations, -1 if not available
+     */
+    int migrationsEventFd;
+    /**
+     * /proc/thread-self/sched, used when perf event is not available. -1 if not available
+     */
+    int schedFd;
+    /**
+     * /proc/thread-self/schedstat, -1 if not available
+     */
+    int schedstatFd;
+};
+
+#endif /* SCHEDULERMETRICS_HPP_ */
@@ -0,0 +1,75 @@
+#ifndef SCRATCHARENA_HPP_
+#define SCRATCHARENA_HPP_
+
+#include <cstddef>
+#include <memory>
+
+#include "HugePages.hpp"
+
+/**
+ * The temporary memory of an engine: a single block, sized by ISortAlgorithm::reset() before the timed sort, which
+ * sort carves its buffers from. The block is kept from a sort to the next one and grows only when a bigger sequence
+ * needs it, so sorting doesn't allocate.
+ *
+ * Buffers are aligned to cache lines and backed by the pages of the engine (see --pages)
+ */
+class ScratchArena {
+public:
+    /**
+     * alignment of every buffer taken
+     */
+    static const std::size_t ALIGNMENT = 64;
+
+    ScratchArena(PageKind pages = PageKind::DEFAULT);
+    virtual ~ScratchArena() {}
+    ScratchArena(const ScratchArena& other) = delete;
+    ScratchArena& operator=(const ScratchArena& other) = delete;
+
+    /**
+     * @return the bytes count elements of T take in the arena, alignment included
+     */
+    template <typename T>
+    static std::size_t footprint(std::size_t count) {
+        return (count * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    /**
+     * make sure the arena holds at least bytes (see footprint) and release every buffer taken. The block is replaced
+     * only if it is too small
+     *
+     * @throws std::domain_error if the memory can't be mapped
+     */
+    void reserve(std::size_t bytes);
+    /**
+     * @return a buffer of count elements, valid until the next reserve. Its content is whatever the previous sort
+     *  left there
+     * @throws std::domain_error if the reserved bytes are exhausted
+     */
+    template <typename T>
+    T* take(std::size_t count) {
+        std::size_t bytes = footprint<T>(count);
+        if (bytes > this->getCapacity() - this->used) {
+            this->exhausted(bytes);
+        }
+        T* result = reinterpret_cast<T*>(static_cast<char*>(this->memory->getData()) + this->used);
+        this->used += bytes;
+        return result;
+    }
+
+    /**
+     * @return the bytes reserved
+     */
+    std::size_t getCapacity() const;
+    /**
+     * @return the block, nullptr if nothing has been reserved yet
+     */
+    const PageAllocation* getMemory() const;
+private:
+    void exhausted(std::size_t bytes) const;
+private:
+    PageKind pages;
+    std::unique_ptr<PageAllocation> memory;
+    std::size_t used;
+};
+
+#endif /* SCRATCHARENA_HPP_ */
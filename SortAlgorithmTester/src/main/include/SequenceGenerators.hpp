@@ -0,0 +1,83 @@
+#ifndef SEQUENCEGENERATORS_HPP_
+#define SEQUENCEGENERATORS_HPP_
+
+#include <cstdlib>
+#include <vector>
+#include <string>
+
+/**
+ * Source of the random numbers of the sequences.
+ *
+ * A seeded generator has its own state, yet it draws the very numbers rand() would draw after srand(seed): sequences
+ * don't change, while generators of different test contexts don't interfere even if they run concurrently
+ */
+class RandomGenerator {
+public:
+    /**
+     * a generator drawing from rand() itself, hence sharing its state with the whole process
+     */
+    RandomGenerator();
+    explicit RandomGenerator(unsigned int seed);
+    virtual ~RandomGenerator() {}
+    RandomGenerator(const RandomGenerator& other) = delete;
+    RandomGenerator& operator=(const RandomGenerator& other) = delete;
+
+    /**
+     * @return a number in [0, RAND_MAX]
+     */
+    int next();
+private:
+    bool shared;
+    /**
+     * the state of rand() has 128 bytes
+     */
+    char state[128];
+    struct random_data data;
+};
+
+/**
+ * generate a random number in the given range
+ *
+ * @param lb lower bound of the range
+ * @param ub upper bound of the range
+ * @param lbIn true if lb may be generated
+ * @param ubIn true if ub may be generated
+ */
+int generateRandomNumber(int lb, int ub, bool lbIn, bool ubIn, RandomGenerator& generator);
+/**
+ * as above, drawing from rand()
+ */
+int generateRandomNumber(int lb, int ub, bool lbIn, bool ubIn);
+
+std::vector<int> generateRandomSequence(int size, int lowerBound, int upperBound, RandomGenerator& generator);
+std::vector<int> generateRandomSequence(int size, int lowerBound, int upperBound);
+
+std::vector<int> generateSameSequence(int size, int lowerBound, int upperBound, RandomGenerator& generator);
+std::vector<int> generateSameSequence(int size, int lowerBound, int upperBound);
+
+std::vector<int> generateSortedSequence(int size, int lowerBound, int upperBound);
+
+std::vector<int> generateReverseSortedSequence(int size, int lowerBound, int upperBound);
+
+/**
+ * the names of every sequence type generateSequence is able to build, in the order they are documented in the CLI
+ */
+const std::vector<std::string>& getSequenceTypeNames();
+
+/**
+ * Generate the sequence named as in the "--sequenceType" CLI option
+ *
+ * @param sequenceType type of the sequence (e.g., RANDOM)
+ * @param size number of elements in the sequence
+ * @param lowerBound minimum number we might generate
+ * @param upperBound maximum number we might generate
+ * @param generator source of the random numbers
+ * @throws std::domain_error if the sequence type is unknown
+ */
+std::vector<int> generateSequence(const std::string& sequenceType, int size, int lowerBound, int upperBound, RandomGenerator& generator);
+/**
+ * as above, drawing from rand()
+ */
+std::vector<int> generateSequence(const std::string& sequenceType, int size, int lowerBound, int upperBound);
+
+#endif /* SEQUENCEGENERATORS_HPP_ */
@@ -0,0 +1,83 @@
+#ifndef SEQUENCEVALIDATOR_HPP_
+#define SEQUENCEVALIDATOR_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+/**
+ * how a sequence is split among the threads checking it: contiguous chunks [first, second), the first one checked by
+ * the calling thread and chunk i by the (i-1)-th worker of the pool. Small sequences are a single chunk
+ *
+ * @param threads maximum number of threads to use
+ */
+std::vector<std::pair<std::size_t, std::size_t>> getValidationChunks(std::size_t size, int threads);
+
+/**
+ * check if a sequence is sorted in non decreasing order.
+ *
+ * Adjacent pairs are compared 16 at a time with SSE2 (when available) and the sequence is split among several threads
+ *
+ * @param threads maximum number of threads to use. Small sequences are always checked by the calling thread
+ */
+bool isSorted(const int* sequence, std::size_t size, int threads);
+bool isSorted(const std::vector<int>& sequence, int threads = 1);
+/**
+ * @param pool the threads used besides the calling one
+ */
+bool isSorted(const std::vector<int>& sequence, ThreadPool& pool);
+
+/**
+ * an order independent hash of the multiset of numbers in the sequence.
+ *
+ * Each number is mixed with a 64 bit finalizer and the results are summed (modulo 2^64), hence two sequences
+ * which are one the permutation of the other have the same hash, while a lost or altered element changes it
+ *
+ * @param threads maximum number of threads to use. Small sequences are always hashed by the calling thread
+ */
+uint64_t multisetHash(const int* sequence, std::size_t size, int threads);
+uint64_t multisetHash(const std::vector<int>& sequence, int threads = 1);
+/**
+ * @param pool the threads used besides the calling one
+ */
+uint64_t multisetHash(const std::vector<int>& sequence, ThreadPool& pool);
+
+/**
+ * Checks the output of an engine: it needs to be sorted and to be a permutation of the input.
+ *
+ * Call recordInput before the sort and validate after it
+ */
+class SequenceValidator {
+public:
+    /**
+     * @param threads maximum number of threads used to validate a sequence. They are kept for the lifetime of the
+     *  validator
+     */
+    SequenceValidator(int threads);
+    /**
+     * @param workerCpus CPUs each worker is pinned on (see ThreadPool::bindWorkers): worker i checks chunk i+1 of
+     *  getValidationChunks
+     */
+    SequenceValidator(int threads, const std::vector<std::vector<int>>& workerCpus);
+    virtual ~SequenceValidator() {}
+
+    int getThreadCount() const;
+
+    /**
+     * remember the multiset of the sequence which is going to be sorted
+     */
+    void recordInput(const std::vector<int>& input);
+    /**
+     * @return true if output is sorted and contains the same numbers (with the same multiplicity) of the last recorded input
+     */
+    bool validate(const std::vector<int>& output) const;
+private:
+    mutable ThreadPool pool;
+    uint64_t inputHash;
+    std::size_t inputSize;
+};
+
+#endif /* SEQUENCEVALIDATOR_HPP_ */
@@ -0,0 +1,142 @@
+#ifndef SORTALGORITHMS_HPP_
+#define SORTALGORITHMS_HPP_
+
+#include <cstddef>
+#include <vector>
+#include <string>
+
+#include "EngineParameters.hpp"
+#include "ScratchArena.hpp"
+
+/**
+ * A sorting engine the tester can benchmark.
+ *
+ * An engine is created once per test context and then used for every run: reset() is called before each sort, out of
+ * the timed part, so that sort finds every temporary buffer it needs already allocated. Outputs are checked by
+ * SequenceValidator
+ */
+class ISortAlgorithm {
+public:
+    virtual ~ISortAlgorithm() {
+
+    }
+    virtual std::vector<int>& sort(std::vector<int>& sequence) = 0;
+    /**
+     * prepare the engine to sort a sequence of sequenceSize elements
+     */
+    virtual void reset(std::size_t sequenceSize) = 0;
+    /**
+     * @return the temporary memory of the engine, nullptr if it needs none
+     */
+    virtual const ScratchArena* getScratchArena() const {
+        return nullptr;
+    }
+};
+
+
+class BubbleSort : public ISortAlgorithm {
+public:
+    BubbleSort() {}
+    virtual ~BubbleSort() {}
+    virtual void reset(std::size_t sequenceSize) {
+
+    }
+    std::vector<int>& sort(std::vector<int>& sequence);
+};
+
+class CountSort: public ISortAlgorithm {
+private:
+    int max;
+    ScratchArena scratch;
+public:
+    CountSort(int max, PageKind pages = PageKind::DEFAULT): max{max}, scratch{pages} {}
+    virtual ~CountSort() {}
+    virtual void reset(std::size_t sequenceSize);
+    virtual const ScratchArena* getScratchArena() const;
+    std::vector<int>& sort(std::vector<int>& sequence);
+private:
+    /**
+     * the output and the counters of each number
+     */
+    std::size_t getScratchBytes(std::size_t sequenceSize) const;
+};
+
+/**
+ * Least significant digit radix sort. Digits are groups of digitBits bits of the distance of each number from the
+ * minimum one, hence negative numbers are supported and small ranges need few passes
+ */
+class RadixSort: public ISortAlgorithm {
+private:
+    int digitBits;
+    ScratchArena scratch;
+public:
+    RadixSort(int digitBits, PageKind pages = PageKind::DEFAULT) : digitBits{digitBits}, scratch{pages} {}
+    virtual ~RadixSort() {}
+    virtual void reset(std::size_t sequenceSize);
+    virtual const ScratchArena* getScratchArena() const;
+    std::vector<int>& sort(std::vector<int>& sequence);
+private:
+    /**
+     * the output of a pass and the counters of each digit value
+     */
+    std::size_t getScratchBytes(std::size_t sequenceSize) const;
+    void countSort(std::vector<int>& sequence, unsigned int min, int shift, int* output, int* count);
+};
+
+/**
+ * Top down merge sort. Subsequences up to smallSortThreshold elements are sorted with insertion sort
+ */
+class MergeSort : public ISortAlgorithm {
+private:
+    int smallSortThreshold;
+    ScratchArena scratch;
+public:
+    MergeSort(int smallSortThreshold, PageKind pages = PageKind::DEFAULT) : smallSortThreshold{smallSortThreshold}, scratch{pages} {}
+    virtual ~MergeSort() {}
+    virtual void reset(std::size_t sequenceSize);
+    virtual const ScratchArena* getScratchArena() const;
+    std::vector<int>& sort(std::vector<int>& sequence);
+private:
+    /**
+     * merge [left, middle] and [middle + 1, right], copying them in buffer first
+     *
+     * @param buffer room for right - left + 1 elements
+     */
+    void merge(std::vector<int>& sequence, int left, int middle, int right, int* buffer);
+    void _merge(std::vector<int>& sequence, int left, int right, int* buffer);
+    void insertionSort(std::vector<int>& sequence, int left, int right);
+};
+
+class CombSort: public ISortAlgorithm {
+private:
+    double shrinkFactor;
+public:
+    CombSort(double shrinkFactor) : shrinkFactor{shrinkFactor} {}
+    virtual ~CombSort() {
+
+    }
+    virtual void reset(std::size_t sequenceSize) {
+
+    }
+    std::vector<int>& sort(std::vector<int>& sequence);
+private:
+    int getNextGap(int gap);
+};
+
+/**
+ * the names of every engine createSortAlgorithm is able to build, in the order they are documented in the CLI
+ */
+const std::vector<std::string>& getSortAlgorithmNames();
+
+/**
+ * Build the engine named as in the "--algorithm" CLI option
+ *
+ * @param algorithm name of the engine (e.g., BUBBLESORT)
+ * @param upperBound maximum number the sequences to sort may contain. Used only by COUNTSORT
+ * @param parameters tunables of the engines
+ * @return a new engine. The caller owns it
+ * @throws std::domain_error if the algorithm is unknown or the parameters are not valid
+ */
+ISortAlgorithm* createSortAlgorithm(const std::string& algorithm, int upperBound, const EngineParameters& parameters);
+
+#endif /* SORTALGORITHMS_HPP_ */
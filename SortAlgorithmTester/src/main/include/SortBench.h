@@ -0,0 +1,171 @@
+#ifndef SORTBENCH_H_
+#define SORTBENCH_H_
+
+/*
+ * The C API of libsortbench: what the tester executable does, for a program embedding it.
+ *
+ * Everything goes through handles the caller creates and destroys. A configuration is a test context, built from the
+ * options of the command line (without the leading "--"); an environment is what stays the same between the contexts
+ * executed with it (see TestEnvironment), and the results are the runs of an execution plus its exit code.
+ *
+ * The library has no global state of its own: sequences come from a generator owned by the environment, never from
+ * rand(). Distinct threads may run distinct configurations at the same time, as long as each one has an environment
+ * of its own. Only what is tied to the signals of the process stays process-wide: --runTimeout, --profile and
+ * --asyncResults can be used by one execution at a time, the others fail with an error while it runs.
+ *
+ * Functions returning int return SB_OK on success
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * success
+ */
+#define SB_OK 0
+/**
+ * sb_run: the algorithm got slower than the baseline (see --baseline)
+ */
+#define SB_REGRESSION 2
+/**
+ * the configuration is invalid or the execution failed: the results have the reason
+ */
+#define SB_ERROR -1
+
+/**
+ * status of a run: the sort completed and its output has been validated
+ */
+#define SB_RUN_OK 0
+/**
+ * status of a run: the sort has been abandoned by the watchdog (see --runTimeout)
+ */
+#define SB_RUN_TIMEOUT 1
+
+typedef struct sb_config sb_config;
+typedef struct sb_environment sb_environment;
+typedef struct sb_results sb_results;
+
+/**
+ * A run, as in the main result file
+ */
+typedef struct sb_run_record {
+    long run;
+    /**
+     * sort time, in microseconds
+     */
+    long time;
+    long voluntaryContextSwitches;
+    long involuntaryContextSwitches;
+    long cpuMigrations;
+    /**
+     * nanoseconds spent waiting on a run queue
+     */
+    long runQueueDelay;
+    int preempted;
+    /**
+     * time spent checking the output, in microseconds
+     */
+    long validationTime;
+    /**
+     * SB_RUN_OK or SB_RUN_TIMEOUT
+     */
+    int status;
+} sb_run_record;
+
+/**
+ * @return an empty configuration, NULL if there is no memory left
+ */
+sb_config* sb_config_create(void);
+
+/**
+ * set an option of the configuration, as if it were given on the command line. A flag is enabled by "true" and
+ * disabled by "false"; an option which can be repeated (as "plugin") gets a value more at each call
+ *
+ * @param option the name of the option, without "--"
+ * @return SB_OK, SB_ERROR if the option doesn't exist or the flag value is neither "true" nor "false"
+ */
+int sb_config_set(sb_config* config, const char* option, const char* value);
+
+/**
+ * set every option of a json object, with the members of a --serve request (see TestServer)
+ *
+ * @return SB_OK, SB_ERROR if json is not an object
+ */
+int sb_config_set_json(sb_config* config, const char* json);
+
+void sb_config_destroy(sb_config* config);
+
+/**
+ * @param sequenceCacheBytes bytes of sequences kept from an execution to the next one. 0 disables the cache
+ * @return a new environment, NULL if there is no memory left
+ */
+sb_environment* sb_environment_create(size_t sequenceCacheBytes);
+
+void sb_environment_destroy(sb_environment* environment);
+
+/**
+ * execute a configuration in an environment of its own, writing its result files as the executable does
+ *
+ * @param results_out if not NULL, set to the results of the execution, even if it failed. The caller destroys them
+ * @return SB_OK, SB_REGRESSION or SB_ERROR
+ */
+int sb_run(const sb_config* config, sb_results** results_out);
+
+/**
+ * as sb_run, in the given environment. An environment is used by one thread at a time
+ */
+int sb_run_in(sb_environment* environment, const sb_config* config, sb_results** results_out);
+
+/**
+ * @return what sb_run returned
+ */
+int sb_results_exit_code(const sb_results* results);
+
+/**
+ * @return why the execution failed, NULL if it didn't. Valid as long as the results
+ */
+const char* sb_results_error(const sb_results* results);
+
+/**
+ * @return the runs the execution recorded
+ */
+size_t sb_results_count(const sb_results* results);
+
+/**
+ * @return SB_OK, SB_ERROR if index is not less than sb_results_count
+ */
+int sb_results_get(const sb_results* results, size_t index, sb_run_record* record);
+
+/**
+ * @return the runs the execution recorded, one after the other: sb_results_count of them. Valid as long as the results
+ */
+const sb_run_record* sb_results_records(const sb_results* results);
+
+void sb_results_destroy(sb_results* results);
+
+/**
+ * @return the name of the index-th built-in engine (as in --algorithm), NULL if there are not so many of them
+ */
+const char* sb_algorithm_name(size_t index);
+
+/**
+ * @return the name of the index-th sequence type (as in --sequenceType), NULL if there are not so many of them
+ */
+const char* sb_sequence_type_name(size_t index);
+
+/**
+ * generate the sequence the first run of a configuration with these options sorts
+ *
+ * @param sequence where the size numbers are written
+ * @return SB_OK, SB_ERROR if the sequence type is unknown or the bounds are invalid
+ */
+int sb_generate(const char* sequenceType, size_t size, int lowerBound, int upperBound, unsigned int seed, int* sequence);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SORTBENCH_H_ */
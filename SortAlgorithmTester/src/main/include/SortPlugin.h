@@ -0,0 +1,84 @@
+#ifndef SORTPLUGIN_H_
+#define SORTPLUGIN_H_
+
+/*
+ * The C ABI of the sort plugins: shared libraries whose engines the tester loads with --plugin, so that an engine
+ * compiled elsewhere (in C, C++ or whatever can export C symbols) can be benchmarked without touching the tester.
+ *
+ * A plugin exports SORT_PLUGIN_ENTRY_POINT, returning the engines it provides. The tester checks the abiVersion of
+ * each of them, then benchmarks an engine exactly as a built-in one: create once per test context, reset before each
+ * run, sort, destroy at the end. Only the calling thread of the tester uses an engine.
+ *
+ * Only members can be added at the end of SortPluginEngine, and only when SORT_PLUGIN_ABI_VERSION grows.
+ * See src/plugin/cpp for an example
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * version of the ABI described here
+ */
+#define SORT_PLUGIN_ABI_VERSION 1
+
+/**
+ * name of the function a plugin exports (see SortPluginEntryPoint)
+ */
+#define SORT_PLUGIN_ENTRY_POINT "sortPluginEngines"
+
+/**
+ * capabilities: the engine sorts with several threads. The manifest places its contexts on a whole socket
+ */
+#define SORT_PLUGIN_PARALLEL 0x1
+/**
+ * capabilities: sort neither allocates memory nor acquires locks, hence --runTimeout can abandon it halfway
+ */
+#define SORT_PLUGIN_ABANDONABLE 0x2
+
+typedef struct SortPluginEngine {
+    /**
+     * SORT_PLUGIN_ABI_VERSION, as the plugin has been compiled with
+     */
+    uint32_t abiVersion;
+    /**
+     * the value of --algorithm selecting the engine. It can't be the one of a built-in engine
+     */
+    const char* name;
+    /**
+     * bitwise or of the SORT_PLUGIN_* capabilities
+     */
+    uint32_t capabilities;
+    /**
+     * @param upperBound maximum number the sequences have
+     * @param options the value of --pluginOptions, "" if missing
+     * @return the state of a new engine, NULL if it can't be created
+     */
+    void* (*create)(int upperBound, const char* options);
+    /**
+     * called before each sort
+     */
+    void (*reset)(void* engine);
+    /**
+     * sort sequence in non decreasing order, in place
+     *
+     * @return 0, or an error code if the sort failed
+     */
+    int (*sort)(void* engine, int* sequence, size_t size);
+    void (*destroy)(void* engine);
+} SortPluginEngine;
+
+/**
+ * @param count set to the number of engines
+ * @return the engines of the plugin. They live as long as the plugin is loaded
+ */
+typedef const SortPluginEngine* (*SortPluginEntryPoint)(size_t* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SORTPLUGIN_H_ */
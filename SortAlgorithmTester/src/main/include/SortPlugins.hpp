@@ -0,0 +1,80 @@
+#ifndef SORTPLUGINS_HPP_
+#define SORTPLUGINS_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SortAlgorithms.hpp"
+#include "SortPlugin.h"
+
+/**
+ * An engine of a plugin, seen as a built-in one
+ */
+class PluginSortAlgorithm : public ISortAlgorithm {
+public:
+    /**
+     * @throws std::domain_error if the plugin can't create the engine
+     */
+    PluginSortAlgorithm(const SortPluginEngine& descriptor, int upperBound, const std::string& options);
+    virtual ~PluginSortAlgorithm();
+    PluginSortAlgorithm(const PluginSortAlgorithm& other) = delete;
+    PluginSortAlgorithm& operator=(const PluginSortAlgorithm& other) = delete;
+
+    /**
+     * the plugin ABI has no room for the size: plugins size their buffers in sort, if they need to
+     */
+    virtual void reset(std::size_t sequenceSize);
+    /**
+     * @throws std::domain_error if the plugin reports an error
+     */
+    virtual std::vector<int>& sort(std::vector<int>& sequence);
+private:
+    const SortPluginEngine& descriptor;
+    void* engine;
+};
+
+/**
+ * The plugins loaded (see SortPlugin.h) and the engines they provide.
+ *
+ * Plugins stay loaded as long as the registry exists: engines created by it can't outlive it
+ */
+class SortPluginRegistry {
+public:
+    SortPluginRegistry();
+    virtual ~SortPluginRegistry();
+    SortPluginRegistry(const SortPluginRegistry& other) = delete;
+    SortPluginRegistry& operator=(const SortPluginRegistry& other) = delete;
+
+    /**
+     * load a plugin and register its engines. Loading again the same file does nothing
+     *
+     * @throws std::domain_error if the plugin can't be loaded, it has been compiled with another ABI or one of its
+     *  engines has the name of an engine already registered (or of a built-in one)
+     */
+    void load(const std::string& fileName);
+    /**
+     * @return the descriptor of the engine with the given name, nullptr if no plugin provides it
+     */
+    const SortPluginEngine* find(const std::string& algorithm) const;
+    /**
+     * @return the names of the engines registered, in the order they have been loaded
+     */
+    std::vector<std::string> getAlgorithmNames() const;
+    /**
+     * @param options the value of --pluginOptions
+     * @return a new engine, provided by a plugin if any has the algorithm, built-in otherwise. The caller owns it
+     * @throws std::domain_error as createSortAlgorithm does
+     */
+    ISortAlgorithm* create(const std::string& algorithm, int upperBound, const EngineParameters& parameters, const std::string& options) const;
+private:
+    struct Plugin {
+        std::string fileName;
+        void* handle;
+        std::vector<const SortPluginEngine*> engines;
+    };
+private:
+    std::vector<Plugin> plugins;
+};
+
+#endif /* SORTPLUGINS_HPP_ */
@@ -0,0 +1,79 @@
+#ifndef SPSCRINGBUFFER_HPP_
+#define SPSCRINGBUFFER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * Bounded lock-free queue with a single producer thread and a single consumer thread.
+ *
+ * Slots are allocated once, in the constructor: pushing never allocates. The indices live on different cache lines
+ * so that the producer and the consumer don't invalidate each other's line on every operation
+ */
+template <typename T>
+class SpscRingBuffer {
+public:
+    /**
+     * @param capacity number of slots. Needs to be a power of 2
+     */
+    SpscRingBuffer(std::size_t capacity) : slots(capacity), mask{capacity - 1}, head{0}, tail{0} {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::domain_error{"ring buffer capacity needs to be a power of 2"};
+        }
+    }
+    SpscRingBuffer(const SpscRingBuffer& other) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer& other) = delete;
+
+    /**
+     * called only by the producer
+     *
+     * @return false if the buffer is full
+     */
+    bool tryPush(const T& value) {
+        std::size_t t = this->tail.load(std::memory_order_relaxed);
+        if (t - this->head.load(std::memory_order_acquire) > this->mask) {
+            return false;
+        }
+        this->slots[t & this->mask] = value;
+        this->tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * called only by the consumer
+     *
+     * @return false if the buffer is empty
+     */
+    bool tryPop(T& value) {
+        std::size_t h = this->head.load(std::memory_order_relaxed);
+        if (h == this->tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = this->slots[h & this->mask];
+        this->head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t getCapacity() const {
+        return this->slots.size();
+    }
+private:
+    std::vector<T> slots;
+    std::size_t mask;
+    // padding rather than alignas: C++11 operator new doesn't honour over-aligned types
+    char headPadding[64];
+    /**
+     * next slot to pop. Written only by the consumer
+     */
+    std::atomic<std::size_t> head;
+    char tailPadding[64];
+    /**
+     * next slot to push. Written only by the producer
+     */
+    std::atomic<std::size_t> tail;
+    char endPadding[64];
+};
+
+#endif /* SPSCRINGBUFFER_HPP_ */
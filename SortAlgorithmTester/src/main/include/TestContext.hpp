@@ -0,0 +1,180 @@
+#ifndef TESTCONTEXT_HPP_
+#define TESTCONTEXT_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CLI11.hpp"
+#include "Json.hpp"
+#include "MachineTopology.hpp"
+#include "ResultWriter.hpp"
+#include "SequenceValidator.hpp"
+#include "SequenceGenerators.hpp"
+#include "SortPlugins.hpp"
+
+/**
+ * exit code of a test context when the algorithm got slower than the baseline
+ */
+const int REGRESSION_EXIT_CODE = 2;
+
+/**
+ * Everything the command line of the tester describes: the algorithm, the sequences it sorts and how the runs are
+ * executed and stored
+ */
+struct TestContext {
+    int sequenceSize = 0;
+    std::string algorithm;
+    std::string sequenceType;
+    unsigned long seed = 0;
+    int lowerBound = 0;
+    int upperBound = 0;
+    int runs = 0;
+    std::string outputTemplate;
+    std::string outputFormat = "csv";
+    bool asyncResults = false;
+    std::string resultShm;
+    std::string resultDb;
+    std::string compression = "none";
+    bool skipIfComplete = false;
+    bool noResultFiles = false;
+
+    double shrinkFactor = 0;
+    int smallSortThreshold = 0;
+    int radixDigitBits = 0;
+    std::string topologyCache;
+    bool tune = false;
+    std::string tuningProfile;
+    std::vector<std::string> plugins;
+    std::string pluginOptions;
+
+    bool discardPreempted = false;
+    int maxRetries = 10;
+    int validationThreads = std::max(1U, std::thread::hardware_concurrency());
+    std::string numa = "none";
+    std::string pages = "default";
+    bool profile = false;
+    int profileFrequency = 997;
+    double runTimeout = 0;
+    std::string isolation = "none";
+    std::string baseline;
+    std::string regressionThreshold = "5%";
+    double regressionSignificance = 0.05;
+};
+
+/**
+ * add to app an option for each field of context, which is set when the command line is parsed
+ */
+void addTestContextOptions(CLI::App& app, TestContext& context);
+
+/**
+ * @return every option of the command line with the value it has been given, its default value or null
+ */
+JsonValue describeCommandLine(const CLI::App& app);
+
+/**
+ * fill context with the options described by a json object, as if they were given on the command line. Its members
+ * are the options without the leading "--": strings and numbers are their values, true enables a flag while false and
+ * null are ignored
+ *
+ * @param ignored members which are not options
+ * @return the options the context has been built from (see describeCommandLine)
+ * @throws std::domain_error if options is not an object or the options are invalid
+ */
+JsonValue parseTestContext(const JsonValue& options, const std::set<std::string>& ignored, TestContext& context);
+
+/**
+ * What stays the same from a test context to the next one, when a process executes many of them (see --serve):
+ * the machine topology, the validation threads, the plugins, the buffers the runs sort and the sequences already
+ * generated.
+ *
+ * Sequences are cached by (sequenceType, sequenceSize, lowerBound, upperBound, seed): a context whose runs are
+ * already cached doesn't generate them again. The least recently used sequences are dropped when the cache is full
+ */
+class TestEnvironment {
+public:
+    /**
+     * @param sequenceCacheBytes bytes of sequences kept between contexts. 0 disables the cache
+     */
+    TestEnvironment(std::size_t sequenceCacheBytes = 0);
+    virtual ~TestEnvironment() {}
+    TestEnvironment(const TestEnvironment& other) = delete;
+    TestEnvironment& operator=(const TestEnvironment& other) = delete;
+
+    const MachineTopology& getTopology(const std::string& cacheFileName);
+    SequenceValidator& getValidator(int threads);
+    /**
+     * @return the plugins loaded so far (see --plugin)
+     */
+    SortPluginRegistry& getPlugins();
+    /**
+     * prepare the sequences sorted by the runs of context: nextSequence returns them in order. If they are not
+     * cached, they are generated by a RandomGenerator seeded with context.seed: the very sequences srand(context.seed)
+     * would give, without touching the state of rand()
+     */
+    void startSequences(const TestContext& context);
+    /**
+     * @return the sequence of the next run. Valid until the next call
+     */
+    const std::vector<int>& nextSequence();
+    /**
+     * @return the buffer every run sorts, reused so that it keeps its capacity (and its pages) from a context to the
+     *  next one
+     */
+    std::vector<int>& getSortBuffer();
+    std::size_t getCachedSequenceBytes() const;
+private:
+    struct CachedSequences {
+        std::string key;
+        std::vector<std::vector<int>> sequences;
+        std::size_t bytes;
+    };
+private:
+    std::size_t sequenceCacheBytes;
+    std::size_t cachedSequenceBytes;
+    /**
+     * most recently used first
+     */
+    std::list<CachedSequences> cachedSequences;
+    /**
+     * the cached sequences of the current context, if any
+     */
+    const CachedSequences* replayed;
+    std::size_t nextRun;
+    /**
+     * what the current context needs to generate. Generated sequences are recorded only if they fit the cache
+     */
+    std::string sequenceType;
+    int sequenceSize;
+    int lowerBound;
+    int upperBound;
+    std::size_t runs;
+    std::unique_ptr<CachedSequences> recorded;
+    std::unique_ptr<RandomGenerator> random;
+    std::vector<int> generated;
+    std::map<std::string, MachineTopology> topologies;
+    std::unique_ptr<SequenceValidator> validator;
+    SortPluginRegistry plugins;
+    std::vector<int> sortBuffer;
+};
+
+/**
+ * execute a test context: tune the algorithm (with --tune) or run it and write the result files. Once every file has
+ * been written, the completion marker of the context records their integrity (see writeCompletionMarker)
+ *
+ * @param parameters the options the context has been built from (see describeCommandLine), stored as metadata
+ * @param observer if not null, receives each record written in the main file as well. The caller closes it. Required
+ *  by noResultFiles, where it is the only one receiving them
+ * @return 0, or REGRESSION_EXIT_CODE if the algorithm got slower than the baseline. With skipIfComplete, what the
+ *  previous execution returned
+ * @throws std::domain_error if the context is invalid or its execution fails
+ */
+int executeTestContext(const TestContext& context, const JsonValue& parameters, TestEnvironment& environment, ResultWriter* observer = nullptr);
+
+#endif /* TESTCONTEXT_HPP_ */
@@ -0,0 +1,69 @@
+#ifndef TESTSERVER_HPP_
+#define TESTSERVER_HPP_
+
+#include <cstdio>
+#include <string>
+
+#include "Checkpoint.hpp"
+#include "TestContext.hpp"
+
+/**
+ * Executes test contexts sent as requests, so that a campaign of many short contexts doesn't pay a process (and a
+ * cold environment) for each of them.
+ *
+ * A request is a json object on a line. Its members are the options of the command line (without the leading "--"):
+ * strings and numbers are their values, true enables a flag while false and null are ignored. Besides them:
+ *  - "id": echoed in every answer to the request;
+ *  - "streamRuns": if false (default true), the runs are not sent back;
+ *  - "shutdown": if true, the server stops (after answering).
+ *
+ * Each request is answered with json lines with the "id" and an "event":
+ *  - "run": a run of the context, with the same members of a line of the jsonl main file;
+ *  - "done": the context has been executed. "exitCode" is what the tester would have returned, "runs" the number of
+ *    runs executed;
+ *  - "error": the context couldn't be executed, as "message" explains;
+ *  - "shutdown": the server is stopping.
+ * The result files are written as if the tester had been executed with the options of the request.
+ *
+ * With a journal, the contexts executed are journaled, and a request whose context the journal has as finished is
+ * answered right away with a "done" event whose "skipped" is true
+ */
+class TestServer {
+public:
+    /**
+     * @param environment kept from a request to the next one
+     * @param journal of the contexts executed. May be null
+     */
+    TestServer(TestEnvironment& environment, CampaignJournal* journal = nullptr);
+    virtual ~TestServer() {}
+
+    /**
+     * serve the requests read from stdin until it ends, answering on stdout. Whatever else would be printed on stdout
+     * goes to stderr
+     */
+    void serveStdio();
+    /**
+     * serve the connections to a Unix socket, one at a time, until a shutdown request. The socket is created at path
+     * (replacing a stale one) and removed when the server stops
+     *
+     * @throws std::domain_error if the socket can't be created
+     */
+    void serveSocket(const std::string& path);
+    /**
+     * serve the requests read from requests until it ends or a shutdown request
+     *
+     * @return false if the server needs to stop
+     */
+    bool serve(FILE* requests, FILE* responses);
+    /**
+     * execute a request, answering on responses
+     *
+     * @return false if the server needs to stop
+     */
+    bool handle(const std::string& request, FILE* responses);
+private:
+    TestEnvironment& environment;
+    CampaignJournal* journal;
+};
+
+#endif /* TESTSERVER_HPP_ */
@@ -0,0 +1,71 @@
+#ifndef THREADPOOL_HPP_
+#define THREADPOOL_HPP_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of threads running batches of jobs, so that parallel work doesn't pay a thread creation each time.
+ *
+ * Only one batch runs at a time: runAll can't be called concurrently
+ */
+class ThreadPool {
+public:
+    /**
+     * @param workers threads created upfront. 0 is allowed: every job is run by the calling thread
+     */
+    ThreadPool(int workers);
+    virtual ~ThreadPool();
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    int getWorkerCount() const;
+    /**
+     * pin each worker on some CPUs. From now on, a batch with no more jobs than threads is run in a fixed way: jobs[0]
+     * by the calling thread and jobs[i] by worker i-1, so that each job runs where its worker has been pinned
+     *
+     * @param cpus the CPUs of each worker. Workers without an entry (or with an empty one) are not pinned
+     * @throws std::domain_error if a worker can't be pinned
+     */
+    void bindWorkers(const std::vector<std::vector<int>>& cpus);
+    /**
+     * run every job and return when all of them completed. The calling thread runs jobs[0] (and whatever the workers
+     * didn't pick up yet), the workers the others. Jobs must not throw
+     */
+    void runAll(const std::vector<std::function<void()>>& jobs);
+private:
+    void workerLoop(int worker);
+    /**
+     * @param worker index of the worker, -1 for the calling thread
+     * @return the job of the batch the thread should run next, -1 if there's none
+     */
+    long findNextJob(int worker) const;
+    /**
+     * run the next job of the batch for the thread, if any
+     *
+     * @return false if there's nothing left for it
+     */
+    bool runNextJob(std::unique_lock<std::mutex>& lock, int worker);
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable batchReady;
+    std::condition_variable batchDone;
+    const std::vector<std::function<void()>>* jobs;
+    std::size_t nextJob;
+    std::size_t pendingJobs;
+    bool stopping;
+    /**
+     * true once the workers have been pinned: see bindWorkers
+     */
+    bool bound;
+    /**
+     * jobs of the batch already picked up, when they are assigned in the fixed way
+     */
+    std::vector<bool> taken;
+};
+
+#endif /* THREADPOOL_HPP_ */
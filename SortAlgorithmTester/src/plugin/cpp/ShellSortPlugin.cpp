@@ -0,0 +1,76 @@
+/*
+ * Example of a sort plugin (see SortPlugin.h): shell sort with the gaps of Ciura and the std::sort of the standard
+ * library, as they would be provided by code living outside the tester.
+ *
+ * Build it, then: SortAlgorithmTester --plugin plugins/libShellSortPlugin.so --algorithm SHELLSORT ...
+ */
+#include "SortPlugin.h"
+
+#include <algorithm>
+#include <new>
+
+namespace {
+
+/**
+ * gaps of Ciura, extended by a factor of 2.25
+ */
+const size_t SHELL_SORT_GAPS[] = {
+    1, 4, 10, 23, 57, 132, 301, 701, 1577, 3548, 7983, 17961, 40412, 90927, 204585, 460316, 1035711, 2330349,
+    5243285, 11797391, 26544129, 59724290, 134379652, 302354217, 680296988
+};
+
+struct Engine {
+    long sorts;
+};
+
+void* create(int upperBound, const char* options) {
+    (void)upperBound;
+    (void)options;
+    return new (std::nothrow) Engine{0};
+}
+
+void reset(void* engine) {
+    (void)engine;
+}
+
+int shellSort(void* engine, int* sequence, size_t size) {
+    static_cast<Engine*>(engine)->sorts += 1;
+    int gapIndex = static_cast<int>(sizeof(SHELL_SORT_GAPS) / sizeof(SHELL_SORT_GAPS[0])) - 1;
+    for (; gapIndex >= 0; --gapIndex) {
+        size_t gap = SHELL_SORT_GAPS[gapIndex];
+        if (gap >= size) {
+            continue;
+        }
+        for (size_t i=gap; i<size; ++i) {
+            int value = sequence[i];
+            size_t j = i;
+            for (; j >= gap && sequence[j - gap] > value; j -= gap) {
+                sequence[j] = sequence[j - gap];
+            }
+            sequence[j] = value;
+        }
+    }
+    return 0;
+}
+
+int standardSort(void* engine, int* sequence, size_t size) {
+    static_cast<Engine*>(engine)->sorts += 1;
+    std::sort(sequence, sequence + size);
+    return 0;
+}
+
+void destroy(void* engine) {
+    delete static_cast<Engine*>(engine);
+}
+
+const SortPluginEngine ENGINES[] = {
+    {SORT_PLUGIN_ABI_VERSION, "SHELLSORT", SORT_PLUGIN_ABANDONABLE, create, reset, shellSort, destroy},
+    {SORT_PLUGIN_ABI_VERSION, "STDSORT", SORT_PLUGIN_ABANDONABLE, create, reset, standardSort, destroy}
+};
+
+}
+
+extern "C" const SortPluginEngine* sortPluginEngines(size_t* count) {
+    *count = sizeof(ENGINES) / sizeof(ENGINES[0]);
+    return ENGINES;
+}
@@ -0,0 +1,512 @@
+/*
+ * The Python module "sortbench": the engines, the generators and the runner of libsortbench (see SortBench.h), called
+ * in process by the Python harness.
+ *
+ * The runs of an execution are never copied: each column of the results (e.g., results.time) is a strided view on the
+ * records the library collected, exported with the buffer protocol. With numpy installed the columns are numpy arrays
+ * on that very memory, otherwise they are objects numpy.asarray (or memoryview) wraps without copying.
+ *
+ * The GIL is released while the library works, so other Python threads go on during a run.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "SortBench.h"
+
+/**
+ * raised when the library refuses a configuration or fails to execute it
+ */
+static PyObject* SortBenchError = nullptr;
+/**
+ * numpy.asarray, null if numpy is not installed
+ */
+static PyObject* numpyAsArray = nullptr;
+
+// ******************************* Column *******************************
+
+/**
+ * A one dimensional buffer on memory owned by someone else (owner) or by the column itself (storage)
+ */
+typedef struct {
+    PyObject_HEAD
+    PyObject* owner;
+    std::vector<int>* storage;
+    char* data;
+    Py_ssize_t shape;
+    Py_ssize_t stride;
+    Py_ssize_t itemsize;
+    const char* format;
+    int readonly;
+} ColumnObject;
+
+static PyTypeObject ColumnType = {PyVarObject_HEAD_INIT(NULL, 0)};
+
+/**
+ * the buffer of an empty column must not be null
+ */
+static char emptyColumn[sizeof(long)];
+
+static PyObject* newColumn(PyObject* owner, std::vector<int>* storage, const void* data, Py_ssize_t shape, Py_ssize_t stride, Py_ssize_t itemsize, const char* format, int readonly) {
+    ColumnObject* self = PyObject_New(ColumnObject, &ColumnType);
+    if (self == nullptr) {
+        delete storage;
+        return nullptr;
+    }
+    Py_XINCREF(owner);
+    self->owner = owner;
+    self->storage = storage;
+    self->data = shape > 0 ? static_cast<char*>(const_cast<void*>(data)) : emptyColumn;
+    self->shape = shape;
+    self->stride = stride;
+    self->itemsize = itemsize;
+    self->format = format;
+    self->readonly = readonly;
+    return reinterpret_cast<PyObject*>(self);
+}
+
+static void columnDealloc(ColumnObject* self) {
+    Py_XDECREF(self->owner);
+    delete self->storage;
+    PyObject_Del(self);
+}
+
+static Py_ssize_t columnLength(ColumnObject* self) {
+    return self->shape;
+}
+
+static int columnGetBuffer(ColumnObject* self, Py_buffer* view, int flags) {
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE && self->readonly) {
+        PyErr_SetString(PyExc_BufferError, "the column is read only");
+        return -1;
+    }
+    if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && self->stride != self->itemsize) {
+        PyErr_SetString(PyExc_BufferError, "the column is not contiguous");
+        return -1;
+    }
+    view->buf = self->data;
+    view->obj = reinterpret_cast<PyObject*>(self);
+    Py_INCREF(self);
+    view->len = self->shape * self->itemsize;
+    view->readonly = self->readonly;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(self->format) : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &self->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &self->stride : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+static PySequenceMethods columnSequenceMethods = {};
+static PyBufferProcs columnBufferProcs = {};
+
+/**
+ * @return the column as a numpy array when numpy is there, the column itself otherwise
+ */
+static PyObject* asArray(PyObject* column) {
+    if (column == nullptr || numpyAsArray == nullptr) {
+        return column;
+    }
+    PyObject* array = PyObject_CallFunctionObjArgs(numpyAsArray, column, nullptr);
+    Py_DECREF(column);
+    return array;
+}
+
+// ******************************* Environment *******************************
+
+typedef struct {
+    PyObject_HEAD
+    sb_environment* environment;
+    /**
+     * an environment is used by one execution at a time, and the GIL is released during the executions
+     */
+    int busy;
+} EnvironmentObject;
+
+static PyTypeObject EnvironmentType = {PyVarObject_HEAD_INIT(NULL, 0)};
+
+static int environmentInit(EnvironmentObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"sequenceCache", nullptr};
+    Py_ssize_t sequenceCache = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|n", const_cast<char**>(keywords), &sequenceCache)) {
+        return -1;
+    }
+    if (sequenceCache < 0) {
+        PyErr_SetString(PyExc_ValueError, "sequenceCache must not be negative");
+        return -1;
+    }
+    sb_environment_destroy(self->environment);
+    self->environment = sb_environment_create(static_cast<size_t>(sequenceCache));
+    if (self->environment == nullptr) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    self->busy = 0;
+    return 0;
+}
+
+static void environmentDealloc(EnvironmentObject* self) {
+    sb_environment_destroy(self->environment);
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+}
+
+// ******************************* Results *******************************
+
+typedef struct {
+    PyObject_HEAD
+    sb_results* results;
+} ResultsObject;
+
+static PyTypeObject ResultsType = {PyVarObject_HEAD_INIT(NULL, 0)};
+
+static void resultsDealloc(ResultsObject* self) {
+    sb_results_destroy(self->results);
+    PyObject_Del(self);
+}
+
+static Py_ssize_t resultsLength(ResultsObject* self) {
+    return static_cast<Py_ssize_t>(sb_results_count(self->results));
+}
+
+/**
+ * a column of the records of the results, as in the main result file
+ */
+struct ResultsColumn {
+    const char* name;
+    std::size_t offset;
+    Py_ssize_t itemsize;
+    const char* format;
+};
+
+static const ResultsColumn RESULTS_COLUMNS[] = {
+    {"run", offsetof(sb_run_record, run), sizeof(long), "l"},
+    {"time", offsetof(sb_run_record, time), sizeof(long), "l"},
+    {"voluntaryContextSwitches", offsetof(sb_run_record, voluntaryContextSwitches), sizeof(long), "l"},
+    {"involuntaryContextSwitches", offsetof(sb_run_record, involuntaryContextSwitches), sizeof(long), "l"},
+    {"cpuMigrations", offsetof(sb_run_record, cpuMigrations), sizeof(long), "l"},
+    {"runQueueDelay", offsetof(sb_run_record, runQueueDelay), sizeof(long), "l"},
+    {"preempted", offsetof(sb_run_record, preempted), sizeof(int), "i"},
+    {"validationTime", offsetof(sb_run_record, validationTime), sizeof(long), "l"},
+    {"status", offsetof(sb_run_record, status), sizeof(int), "i"},
+};
+static const int RESULTS_COLUMN_COUNT = sizeof(RESULTS_COLUMNS) / sizeof(RESULTS_COLUMNS[0]);
+
+static PyObject* resultsGetColumn(ResultsObject* self, void* closure) {
+    const ResultsColumn* column = static_cast<const ResultsColumn*>(closure);
+    const char* records = reinterpret_cast<const char*>(sb_results_records(self->results));
+    return asArray(newColumn(
+        reinterpret_cast<PyObject*>(self), nullptr, records + column->offset,
+        static_cast<Py_ssize_t>(sb_results_count(self->results)), sizeof(sb_run_record), column->itemsize, column->format, 1
+    ));
+}
+
+static PyObject* resultsGetExitCode(ResultsObject* self, void* closure) {
+    return PyLong_FromLong(sb_results_exit_code(self->results));
+}
+
+static PyObject* resultsGetColumns(ResultsObject* self, void* closure) {
+    PyObject* names = PyTuple_New(RESULTS_COLUMN_COUNT);
+    if (names == nullptr) {
+        return nullptr;
+    }
+    for (int i=0; i<RESULTS_COLUMN_COUNT; ++i) {
+        PyObject* name = PyUnicode_FromString(RESULTS_COLUMNS[i].name);
+        if (name == nullptr) {
+            Py_DECREF(names);
+            return nullptr;
+        }
+        PyTuple_SET_ITEM(names, i, name);
+    }
+    return names;
+}
+
+static PySequenceMethods resultsSequenceMethods = {};
+static PyGetSetDef resultsGetSet[RESULTS_COLUMN_COUNT + 3] = {};
+
+// ******************************* functions *******************************
+
+/**
+ * set an option of config from a value of a Python dictionary: booleans are flags, lists and tuples repeated
+ * options, anything else is given as its str()
+ *
+ * @return false, with a Python exception, if the value can't be set
+ */
+static bool setOption(sb_config* config, const char* option, PyObject* value) {
+    if (value == Py_None) {
+        return true;
+    }
+    if (PyBool_Check(value)) {
+        if (sb_config_set(config, option, value == Py_True ? "true" : "false") != SB_OK) {
+            PyErr_Format(PyExc_ValueError, "%s is not a flag of the tester", option);
+            return false;
+        }
+        return true;
+    }
+    if (PyList_Check(value) || PyTuple_Check(value)) {
+        Py_ssize_t size = PySequence_Size(value);
+        for (Py_ssize_t i=0; i<size; ++i) {
+            PyObject* item = PySequence_GetItem(value, i);
+            if (item == nullptr) {
+                return false;
+            }
+            bool ok = setOption(config, option, item);
+            Py_DECREF(item);
+            if (!ok) {
+                return false;
+            }
+        }
+        return true;
+    }
+    PyObject* string = PyObject_Str(value);
+    if (string == nullptr) {
+        return false;
+    }
+    const char* utf8 = PyUnicode_AsUTF8(string);
+    bool ok = utf8 != nullptr;
+    if (ok && sb_config_set(config, option, utf8) != SB_OK) {
+        PyErr_Format(PyExc_ValueError, "%s is not an option of the tester, or %s is not a valid value for it", option, utf8);
+        ok = false;
+    }
+    Py_DECREF(string);
+    return ok;
+}
+
+static void destroyConfig(sb_config* config) {
+    sb_config_destroy(config);
+}
+
+static PyObject* sortbenchRun(PyObject* module, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"options", "environment", nullptr};
+    PyObject* options = nullptr;
+    PyObject* environment = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|O", const_cast<char**>(keywords), &PyDict_Type, &options, &environment)) {
+        return nullptr;
+    }
+    if (environment != Py_None && !PyObject_TypeCheck(environment, &EnvironmentType)) {
+        PyErr_SetString(PyExc_TypeError, "environment must be a sortbench.Environment or None");
+        return nullptr;
+    }
+
+    std::unique_ptr<sb_config, void(*)(sb_config*)> config{sb_config_create(), destroyConfig};
+    if (!config) {
+        return PyErr_NoMemory();
+    }
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t position = 0;
+    while (PyDict_Next(options, &position, &key, &value)) {
+        if (!PyUnicode_Check(key)) {
+            PyErr_SetString(PyExc_TypeError, "the options must be str");
+            return nullptr;
+        }
+        const char* option = PyUnicode_AsUTF8(key);
+        if (option == nullptr || !setOption(config.get(), option, value)) {
+            return nullptr;
+        }
+    }
+
+    EnvironmentObject* env = environment == Py_None ? nullptr : reinterpret_cast<EnvironmentObject*>(environment);
+    if (env != nullptr) {
+        if (env->environment == nullptr) {
+            PyErr_SetString(PyExc_RuntimeError, "the environment has not been initialized");
+            return nullptr;
+        }
+        if (env->busy) {
+            PyErr_SetString(PyExc_RuntimeError, "the environment is already used by another execution");
+            return nullptr;
+        }
+        env->busy = 1;
+        Py_INCREF(env);
+    }
+    sb_results* results = nullptr;
+    Py_BEGIN_ALLOW_THREADS
+    if (env != nullptr) {
+        sb_run_in(env->environment, config.get(), &results);
+    } else {
+        sb_run(config.get(), &results);
+    }
+    Py_END_ALLOW_THREADS
+    if (env != nullptr) {
+        env->busy = 0;
+        Py_DECREF(env);
+    }
+
+    if (results == nullptr) {
+        return PyErr_NoMemory();
+    }
+    if (sb_results_exit_code(results) == SB_ERROR) {
+        const char* error = sb_results_error(results);
+        PyErr_SetString(SortBenchError, error != nullptr ? error : "the execution failed");
+        sb_results_destroy(results);
+        return nullptr;
+    }
+    ResultsObject* self = PyObject_New(ResultsObject, &ResultsType);
+    if (self == nullptr) {
+        sb_results_destroy(results);
+        return nullptr;
+    }
+    self->results = results;
+    return reinterpret_cast<PyObject*>(self);
+}
+
+static PyObject* sortbenchGenerate(PyObject* module, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"sequenceType", "sequenceSize", "lowerBound", "upperBound", "seed", nullptr};
+    const char* sequenceType = nullptr;
+    Py_ssize_t size = 0;
+    int lowerBound = 0;
+    int upperBound = 0;
+    unsigned int seed = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "snii|I", const_cast<char**>(keywords), &sequenceType, &size, &lowerBound, &upperBound, &seed)) {
+        return nullptr;
+    }
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError, "sequenceSize must not be negative");
+        return nullptr;
+    }
+    std::vector<int>* sequence = new (std::nothrow) std::vector<int>{};
+    if (sequence == nullptr) {
+        return PyErr_NoMemory();
+    }
+    int result = SB_ERROR;
+    try {
+        sequence->resize(static_cast<std::size_t>(size));
+    } catch (const std::bad_alloc&) {
+        delete sequence;
+        return PyErr_NoMemory();
+    }
+    Py_BEGIN_ALLOW_THREADS
+    result = sb_generate(sequenceType, sequence->size(), lowerBound, upperBound, seed, sequence->data());
+    Py_END_ALLOW_THREADS
+    if (result != SB_OK) {
+        delete sequence;
+        PyErr_Format(PyExc_ValueError, "cannot generate a %s sequence in [%d, %d]", sequenceType, lowerBound, upperBound);
+        return nullptr;
+    }
+    return asArray(newColumn(nullptr, sequence, sequence->data(), size, sizeof(int), sizeof(int), "i", 0));
+}
+
+/**
+ * @return a list of the names get returns, until it returns null
+ */
+static PyObject* listNames(const char* (*get)(size_t)) {
+    PyObject* names = PyList_New(0);
+    for (std::size_t i=0; names != nullptr && get(i) != nullptr; ++i) {
+        PyObject* name = PyUnicode_FromString(get(i));
+        if (name == nullptr || PyList_Append(names, name) != 0) {
+            Py_XDECREF(name);
+            Py_DECREF(names);
+            return nullptr;
+        }
+        Py_DECREF(name);
+    }
+    return names;
+}
+
+static PyObject* sortbenchAlgorithms(PyObject* module, PyObject* args) {
+    return listNames(sb_algorithm_name);
+}
+
+static PyObject* sortbenchSequenceTypes(PyObject* module, PyObject* args) {
+    return listNames(sb_sequence_type_name);
+}
+
+static PyMethodDef sortbenchMethods[] = {
+    {"run", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(sortbenchRun)), METH_VARARGS | METH_KEYWORDS,
+        "run(options, environment=None) -> Results\n\n"
+        "Execute a test context, whose options are the ones of the tester (without the leading \"--\"), writing its "
+        "result files as the tester does. With noResultFiles=True the runs are only in the results: neither the main "
+        "nor the summary file is written. Raises sortbench.Error if the context can't be executed"},
+    {"generate", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(sortbenchGenerate)), METH_VARARGS | METH_KEYWORDS,
+        "generate(sequenceType, sequenceSize, lowerBound, upperBound, seed=0) -> int32 array\n\n"
+        "The sequence sorted by the first run of a test context with these options"},
+    {"algorithms", sortbenchAlgorithms, METH_NOARGS, "algorithms() -> the names of the built-in engines"},
+    {"sequence_types", sortbenchSequenceTypes, METH_NOARGS, "sequence_types() -> the names of the sequence types"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static struct PyModuleDef sortbenchModule = {
+    PyModuleDef_HEAD_INIT,
+    "sortbench",
+    "In process access to the engines, the generators and the runner of SortAlgorithmTester",
+    -1,
+    sortbenchMethods,
+};
+
+PyMODINIT_FUNC PyInit_sortbench(void) {
+    columnSequenceMethods.sq_length = reinterpret_cast<lenfunc>(columnLength);
+    columnBufferProcs.bf_getbuffer = reinterpret_cast<getbufferproc>(columnGetBuffer);
+    ColumnType.tp_name = "sortbench.Column";
+    ColumnType.tp_basicsize = sizeof(ColumnObject);
+    ColumnType.tp_dealloc = reinterpret_cast<destructor>(columnDealloc);
+    ColumnType.tp_as_sequence = &columnSequenceMethods;
+    ColumnType.tp_as_buffer = &columnBufferProcs;
+    ColumnType.tp_flags = Py_TPFLAGS_DEFAULT;
+    ColumnType.tp_doc = "A column of numbers, exported with the buffer protocol: numpy.asarray(column) doesn't copy it";
+
+    EnvironmentType.tp_name = "sortbench.Environment";
+    EnvironmentType.tp_basicsize = sizeof(EnvironmentObject);
+    EnvironmentType.tp_dealloc = reinterpret_cast<destructor>(environmentDealloc);
+    EnvironmentType.tp_init = reinterpret_cast<initproc>(environmentInit);
+    EnvironmentType.tp_new = PyType_GenericNew;
+    EnvironmentType.tp_flags = Py_TPFLAGS_DEFAULT;
+    EnvironmentType.tp_doc = "Environment(sequenceCache=0)\n\n"
+        "What stays the same between the test contexts run with it, as the sequenceCache bytes of sequences kept "
+        "from a context to the next one. Used by one run at a time";
+
+    resultsSequenceMethods.sq_length = reinterpret_cast<lenfunc>(resultsLength);
+    for (int i=0; i<RESULTS_COLUMN_COUNT; ++i) {
+        resultsGetSet[i].name = const_cast<char*>(RESULTS_COLUMNS[i].name);
+        resultsGetSet[i].get = reinterpret_cast<getter>(resultsGetColumn);
+        resultsGetSet[i].closure = const_cast<ResultsColumn*>(&RESULTS_COLUMNS[i]);
+    }
+    resultsGetSet[RESULTS_COLUMN_COUNT].name = const_cast<char*>("exit_code");
+    resultsGetSet[RESULTS_COLUMN_COUNT].get = reinterpret_cast<getter>(resultsGetExitCode);
+    resultsGetSet[RESULTS_COLUMN_COUNT + 1].name = const_cast<char*>("columns");
+    resultsGetSet[RESULTS_COLUMN_COUNT + 1].get = reinterpret_cast<getter>(resultsGetColumns);
+    ResultsType.tp_name = "sortbench.Results";
+    ResultsType.tp_basicsize = sizeof(ResultsObject);
+    ResultsType.tp_dealloc = reinterpret_cast<destructor>(resultsDealloc);
+    ResultsType.tp_as_sequence = &resultsSequenceMethods;
+    ResultsType.tp_getset = resultsGetSet;
+    ResultsType.tp_flags = Py_TPFLAGS_DEFAULT;
+    ResultsType.tp_doc = "The runs of an execution: one read only column per field of the main result file "
+        "(see columns), viewing the memory of the library. exit_code is 0, or 2 if the algorithm regressed";
+
+    if (PyType_Ready(&ColumnType) < 0 || PyType_Ready(&EnvironmentType) < 0 || PyType_Ready(&ResultsType) < 0) {
+        return nullptr;
+    }
+    PyObject* module = PyModule_Create(&sortbenchModule);
+    if (module == nullptr) {
+        return nullptr;
+    }
+    SortBenchError = PyErr_NewException("sortbench.Error", nullptr, nullptr);
+    Py_XINCREF(SortBenchError);
+    Py_INCREF(&EnvironmentType);
+    Py_INCREF(&ResultsType);
+    Py_INCREF(&ColumnType);
+    if (SortBenchError == nullptr
+            || PyModule_AddObject(module, "Error", SortBenchError) < 0
+            || PyModule_AddObject(module, "Environment", reinterpret_cast<PyObject*>(&EnvironmentType)) < 0
+            || PyModule_AddObject(module, "Results", reinterpret_cast<PyObject*>(&ResultsType)) < 0
+            || PyModule_AddObject(module, "Column", reinterpret_cast<PyObject*>(&ColumnType)) < 0) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+
+    // numpy is optional: without it the columns are handed out as they are
+    PyObject* numpy = PyImport_ImportModule("numpy");
+    if (numpy != nullptr) {
+        numpyAsArray = PyObject_GetAttrString(numpy, "asarray");
+        Py_DECREF(numpy);
+    }
+    PyErr_Clear();
+    return module;
+}
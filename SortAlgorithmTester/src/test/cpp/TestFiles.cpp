@@ -0,0 +1,53 @@
+#define CATCH_CONFIG_EXTERNAL_INTERFACES // Catch::TestEventListenerBase
+#include "catch.hpp"
+
+#include "TestFiles.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ftw.h>
+#include <sstream>
+#include <vector>
+
+/**
+ * the directories created by the running test case
+ */
+static std::vector<std::string> temporaryDirectories{};
+
+static int removeEntry(const char* path, const struct stat* status, int type, struct FTW* walk) {
+    remove(path);
+    return 0;
+}
+
+/**
+ * Removes the directories of makeTemplate once the test case which created them ends, whatever its outcome
+ */
+struct TemporaryDirectoryCleaner : Catch::TestEventListenerBase {
+    using TestEventListenerBase::TestEventListenerBase;
+
+    void testCaseEnded(const Catch::TestCaseStats& stats) override {
+        for (auto& directory : temporaryDirectories) {
+            // children first: a directory can be removed only once empty
+            nftw(directory.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+        }
+        temporaryDirectories.clear();
+    }
+};
+CATCH_REGISTER_LISTENER(TemporaryDirectoryCleaner)
+
+std::string makeTemplate(const std::string& prefix) {
+    std::string pattern = "/tmp/" + prefix + "XXXXXX";
+    std::vector<char> directory(pattern.begin(), pattern.end());
+    directory.push_back('\0');
+    REQUIRE(mkdtemp(directory.data()) != nullptr);
+    temporaryDirectories.push_back(directory.data());
+    return std::string{directory.data()} + "/";
+}
+
+std::string readFile(const std::string& fileName) {
+    std::ifstream file{fileName, std::ios::binary};
+    std::stringstream content{};
+    content << file.rdbuf();
+    return content.str();
+}
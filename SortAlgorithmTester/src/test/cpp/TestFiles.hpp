@@ -0,0 +1,20 @@
+#ifndef TESTFILES_HPP_
+#define TESTFILES_HPP_
+
+#include <string>
+
+/**
+ * create a directory in /tmp for the files of the running test case. It is removed, with everything inside, when the
+ * test case ends
+ *
+ * @param prefix name of the directory, followed by random characters (e.g., the name of the test file)
+ * @return the path of the directory followed by "/": an --outputTemplate writing there
+ */
+std::string makeTemplate(const std::string& prefix);
+
+/**
+ * @return the whole content of a file, as bytes. Empty if it can't be read
+ */
+std::string readFile(const std::string& fileName);
+
+#endif /* TESTFILES_HPP_ */
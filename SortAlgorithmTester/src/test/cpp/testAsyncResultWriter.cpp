@@ -0,0 +1,114 @@
+#include "catch.hpp"
+
+#include "AsyncResultWriter.hpp"
+#include "TestFiles.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int countLines(const std::string& s) {
+    int result = 0;
+    for (char c : s) {
+        if (c == '\n') {
+            ++result;
+        }
+    }
+    return result;
+}
+
+static RunRecord makeRecord(long run) {
+    return RunRecord{run, run, 0, 0, 0, 0, false, 0, RunStatus::OK};
+}
+
+TEST_CASE("ring buffer", "[async]") {
+    REQUIRE_THROWS_AS(SpscRingBuffer<int>{3}, std::domain_error);
+
+    SpscRingBuffer<int> buffer{4};
+    int value;
+    REQUIRE_FALSE(buffer.tryPop(value));
+    for (int i=0; i<4; ++i) {
+        REQUIRE(buffer.tryPush(i));
+    }
+    REQUIRE_FALSE(buffer.tryPush(4));
+    REQUIRE(buffer.tryPop(value));
+    REQUIRE(value == 0);
+    REQUIRE(buffer.tryPush(4));
+    for (int i=1; i<=4; ++i) {
+        REQUIRE(buffer.tryPop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(buffer.tryPop(value));
+}
+
+TEST_CASE("asynchronous results", "[async]") {
+    std::string fileName = makeTemplate("testAsyncResultWriter") + "main.csv";
+
+    {
+        // a small buffer, so that the producer has to wait for the writer thread
+        AsyncResultWriter writer{new CsvResultWriter{fileName}, 8, -1};
+        for (long run=0; run<1000; ++run) {
+            writer.write(makeRecord(run));
+        }
+        REQUIRE_THROWS_AS((AsyncResultWriter{new CsvResultWriter{fileName + ".other"}, 8, -1}), std::domain_error);
+        writer.close();
+    }
+    std::string content = readFile(fileName);
+    REQUIRE(countLines(content) == 1001);
+    REQUIRE(content.find("\n999,999,") != std::string::npos);
+}
+
+/**
+ * a sink on a full disk
+ */
+class FailingResultWriter : public ResultWriter {
+public:
+    virtual void write(const RunRecord& record) {
+        throw std::domain_error{"no space left on device"};
+    }
+    virtual void close() {}
+};
+
+TEST_CASE("failing sink", "[async]") {
+    AsyncResultWriter writer{new FailingResultWriter{}, 16, -1};
+    // once the writer thread has given up, the buffer fills up and stays full
+    REQUIRE_THROWS_AS([&writer]() {
+        for (long run=0; run<100; ++run) {
+            writer.write(makeRecord(run));
+        }
+    }(), std::domain_error);
+    REQUIRE_THROWS_AS(writer.close(), std::domain_error);
+}
+
+TEST_CASE("results survive a signal", "[async]") {
+    std::string fileName = makeTemplate("testAsyncResultWriter") + "main.csv";
+
+    pid_t child = fork();
+    REQUIRE(child >= 0);
+    if (child == 0) {
+        AsyncResultWriter writer{new CsvResultWriter{fileName}, 1 << 10, -1};
+        for (long run=0; run<100; ++run) {
+            writer.write(makeRecord(run));
+        }
+        raise(SIGTERM);
+        _exit(0);
+    }
+    int status;
+    waitpid(child, &status, 0);
+    REQUIRE(WIFSIGNALED(status));
+    REQUIRE(WTERMSIG(status) == SIGTERM);
+    REQUIRE(countLines(readFile(fileName)) == 101);
+}
+
+TEST_CASE("writer cpu", "[async]") {
+    MachineTopology topology{};
+    // 2 cores with 2 threads each: cpu 0 and 2 share a core, so do 1 and 3
+    topology.cpus = {{0, 0, 0, 0}, {1, 1, 0, 0}, {2, 0, 0, 0}, {3, 1, 0, 0}};
+    REQUIRE(chooseWriterCpu(topology, {0, 1, 2, 3}, 0) == 3);
+    REQUIRE(chooseWriterCpu(topology, {0, 2}, 0) == 2);
+    REQUIRE(chooseWriterCpu(topology, {0}, 0) == -1);
+    REQUIRE_FALSE(getAllowedCpus().empty());
+}
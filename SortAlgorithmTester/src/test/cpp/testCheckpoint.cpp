@@ -0,0 +1,141 @@
+#include "catch.hpp"
+
+#include "Checkpoint.hpp"
+#include "TestFiles.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @return the names of the files in directory
+ */
+static std::vector<std::string> listFiles(const std::string& directory) {
+    std::vector<std::string> result{};
+    DIR* dir = opendir(directory.c_str());
+    REQUIRE(dir != nullptr);
+    while (struct dirent* entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+            result.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    return result;
+}
+
+static void writeFile(const std::string& fileName, const std::string& content, const char* mode = "w") {
+    FILE* file = fopen(fileName.c_str(), mode);
+    REQUIRE(file != nullptr);
+    fwrite(content.data(), 1, content.size(), file);
+    fclose(file);
+}
+
+TEST_CASE("crc32", "[checkpoint]") {
+    // the check value of CRC-32
+    REQUIRE(crc32("123456789", 9) == 0xCBF43926U);
+    REQUIRE(crc32("", 0) == 0);
+    // a piece at a time
+    REQUIRE(crc32("6789", 4, crc32("12345", 5)) == 0xCBF43926U);
+
+    std::string outputTemplate = makeTemplate("testCheckpoint");
+    std::string content(100000, 'x');
+    writeFile(outputTemplate + "big", content);
+    uint64_t size;
+    REQUIRE(fileCrc32(outputTemplate + "big", size) == crc32(content.data(), content.size()));
+    REQUIRE(size == content.size());
+    REQUIRE_THROWS_AS(fileCrc32(outputTemplate + "missing", size), std::domain_error);
+}
+
+TEST_CASE("completion marker", "[checkpoint]") {
+    std::string outputTemplate = makeTemplate("testCheckpoint");
+    int exitCode = -1;
+    REQUIRE_FALSE(isOutputComplete(outputTemplate, exitCode));
+
+    writeFile(outputTemplate + "kind:type=main|.csv", "run,time\n0,1\n");
+    writeFile(outputTemplate + "kind:type=summary|.csv", "p50\n1\n");
+    writeCompletionMarker(outputTemplate, {"kind:type=main|.csv", "kind:type=summary|.csv"}, 1, 2);
+    // the temporary marker has been renamed
+    REQUIRE(listFiles(outputTemplate).size() == 3);
+    REQUIRE(isOutputComplete(outputTemplate, exitCode));
+    REQUIRE(exitCode == 2);
+
+    // a file of the same size with a different content
+    writeFile(outputTemplate + "kind:type=summary|.csv", "p50\n2\n");
+    REQUIRE_FALSE(isOutputComplete(outputTemplate, exitCode));
+    writeFile(outputTemplate + "kind:type=summary|.csv", "p50\n1\n");
+    REQUIRE(isOutputComplete(outputTemplate, exitCode));
+    // a truncated file
+    writeFile(outputTemplate + "kind:type=main|.csv", "run,time\n");
+    REQUIRE_FALSE(isOutputComplete(outputTemplate, exitCode));
+    writeFile(outputTemplate + "kind:type=main|.csv", "run,time\n0,1\n");
+    REQUIRE(isOutputComplete(outputTemplate, exitCode));
+
+    removeCompletionMarker(outputTemplate);
+    REQUIRE_FALSE(isOutputComplete(outputTemplate, exitCode));
+    REQUIRE_THROWS_AS(writeCompletionMarker(outputTemplate, {"kind:type=missing|.csv"}, 0, 0), std::domain_error);
+}
+
+TEST_CASE("concurrent completion markers", "[checkpoint]") {
+    std::string outputTemplate = makeTemplate("testCheckpoint");
+    writeFile(outputTemplate + "kind:type=main|.csv", "run,time\n0,1\n");
+    // executions writing the same outputTemplate don't touch each other's temporary marker
+    std::vector<std::thread> writers{};
+    std::vector<int> failures(4, 0);
+    for (int i=0; i<4; ++i) {
+        writers.emplace_back([&, i]() {
+            for (int repetition=0; repetition<50; ++repetition) {
+                try {
+                    writeCompletionMarker(outputTemplate, {"kind:type=main|.csv"}, 1, 0);
+                } catch (const std::domain_error& e) {
+                    ++failures[i];
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    REQUIRE(failures == std::vector<int>(4, 0));
+    int exitCode = -1;
+    REQUIRE(isOutputComplete(outputTemplate, exitCode));
+    REQUIRE(listFiles(outputTemplate).size() == 2);
+}
+
+TEST_CASE("campaign journal", "[checkpoint]") {
+    std::string directory = makeTemplate("testCheckpoint");
+    std::string journalName = directory + "journal.jsonl";
+    std::string first = directory + "first_";
+    std::string second = directory + "second_";
+    writeFile(first + "kind:type=main|.csv", "run\n");
+    writeCompletionMarker(first, {"kind:type=main|.csv"}, 0, 0);
+    writeFile(second + "kind:type=main|.csv", "run\n");
+    writeCompletionMarker(second, {"kind:type=main|.csv"}, 0, 2);
+
+    int exitCode = -1;
+    {
+        CampaignJournal journal{journalName};
+        REQUIRE(journal.getFinishedCount() == 0);
+        REQUIRE_FALSE(journal.isFinished(first, exitCode));
+        journal.record(first, 0);
+        journal.record(second, 2);
+        REQUIRE(journal.isFinished(first, exitCode));
+        REQUIRE(exitCode == 0);
+    }
+    // a crash while the third context was being journaled
+    writeFile(journalName, "{\"outputTemplate\": \"third", "a");
+
+    CampaignJournal journal{journalName};
+    REQUIRE(journal.getFinishedCount() == 2);
+    REQUIRE(journal.isFinished(second, exitCode));
+    REQUIRE(exitCode == 2);
+    // journaled, but its files are gone
+    removeCompletionMarker(first);
+    REQUIRE_FALSE(journal.isFinished(first, exitCode));
+    journal.record(directory + "fourth_", 0);
+
+    CampaignJournal reloaded{journalName};
+    REQUIRE(reloaded.getFinishedCount() == 3);
+}
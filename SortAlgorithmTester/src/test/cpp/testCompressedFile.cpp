@@ -0,0 +1,163 @@
+#include "catch.hpp"
+
+#include "CompressedFile.hpp"
+#include "ResultWriter.hpp"
+#include "Json.hpp"
+#include "TestFiles.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+#ifdef WITH_LZ4
+#include <lz4frame.h>
+#endif
+
+/**
+ * @return the index at the end of a compressed file
+ */
+static JsonValue readIndex(const std::string& content) {
+    REQUIRE(content.size() > 12);
+    REQUIRE(content.substr(content.size() - 8) == "SORTCHK1");
+    uint32_t length;
+    memcpy(&length, content.data() + content.size() - 12, sizeof(length));
+    return JsonValue::parse(content.substr(content.size() - 12 - length, length));
+}
+
+static std::string decompress(const std::string& codec, const std::string& chunk, std::size_t length) {
+    std::string result(length, '\0');
+#ifdef WITH_ZSTD
+    if (codec == "zstd") {
+        REQUIRE(ZSTD_decompress(&result[0], result.size(), chunk.data(), chunk.size()) == length);
+        return result;
+    }
+#endif
+#ifdef WITH_LZ4
+    if (codec == "lz4") {
+        LZ4F_decompressionContext_t context;
+        REQUIRE(!LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)));
+        std::size_t written = result.size();
+        std::size_t read = chunk.size();
+        std::size_t hint = LZ4F_decompress(context, &result[0], &written, chunk.data(), &read, nullptr);
+        LZ4F_freeDecompressionContext(context);
+        REQUIRE(hint == 0);
+        REQUIRE(written == length);
+        return result;
+    }
+#endif
+    FAIL("codec not available");
+    return result;
+}
+
+/**
+ * @return the decompressed content of each chunk
+ */
+static std::vector<std::string> readChunks(const std::string& content, const JsonValue& index) {
+    std::vector<std::string> result{};
+    for (auto& chunk : index.get("chunks").asArray()) {
+        result.push_back(decompress(
+            index.get("codec").asString(),
+            content.substr(chunk.get("offset").asInt(), chunk.get("size").asInt()),
+            chunk.get("length").asInt()
+        ));
+    }
+    return result;
+}
+
+static std::vector<std::string> getAvailableCodecs() {
+    std::vector<std::string> result{};
+    for (auto& codec : getCompressionNames()) {
+        if (codec != "none" && isCompressionAvailable(codec)) {
+            result.push_back(codec);
+        }
+    }
+    return result;
+}
+
+TEST_CASE("compression names", "[compression]") {
+    REQUIRE(isCompressionAvailable("none"));
+    REQUIRE_FALSE(isCompressionAvailable("gzip"));
+    REQUIRE(getCompressionExtension("zstd") == ".zst");
+    REQUIRE(getCompressionExtension("lz4") == ".lz4");
+    REQUIRE_THROWS_AS(CompressedFile(makeTemplate("testCompressedFile") + "x", "none", JsonValue::object()), std::domain_error);
+}
+
+TEST_CASE("compressed file", "[compression]") {
+    for (auto& codec : getAvailableCodecs()) {
+        SECTION(codec) {
+            std::string fileName = makeTemplate("testCompressedFile") + "file" + getCompressionExtension(codec);
+            {
+                CompressedFile file{fileName, codec, JsonValue::object().set("format", "test")};
+                fprintf(file.getStream(), "header\n");
+                file.endChunk(0);
+                for (int i=0; i<1000; ++i) {
+                    fprintf(file.getStream(), "line %d\n", i);
+                }
+                file.endChunk(1000);
+                fprintf(file.getStream(), "footer\n");
+                fclose(file.getStream());
+                file.close();
+            }
+
+            std::string content = readFile(fileName);
+            JsonValue index = readIndex(content);
+            REQUIRE(index.get("codec").asString() == codec);
+            REQUIRE(index.get("format").asString() == "test");
+            REQUIRE(index.get("chunks").asArray().size() == 3);
+            REQUIRE(index.get("chunks").asArray()[1].get("runs").asInt() == 1000);
+            std::vector<std::string> chunks = readChunks(content, index);
+            REQUIRE(chunks[0] == "header\n");
+            REQUIRE(chunks[1].substr(0, 14) == "line 0\nline 1\n");
+            REQUIRE(chunks[2] == "footer\n");
+            // repetitive text needs to shrink
+            REQUIRE(index.get("chunks").asArray()[1].get("size").asInt() < chunks[1].size() / 2);
+        }
+    }
+}
+
+TEST_CASE("compressed results", "[compression][results]") {
+    REQUIRE_THROWS_AS(createResultWriter("binary", makeTemplate("testCompressedFile"), 10, JsonValue::object(), "zstd"), std::domain_error);
+
+    for (auto& codec : getAvailableCodecs()) {
+        SECTION(codec) {
+            std::string outputTemplate = makeTemplate("testCompressedFile");
+            std::string plainTemplate = makeTemplate("testCompressedFile");
+            // more than a chunk
+            const long runs = 5000;
+            std::unique_ptr<ResultWriter> compressed{createResultWriter("csv", outputTemplate, runs, JsonValue::object(), codec)};
+            std::unique_ptr<ResultWriter> plain{createResultWriter("csv", plainTemplate, runs)};
+            for (long run=0; run<runs; ++run) {
+                RunRecord record{run, 100 + run, 1, 2, 3, 4000, false, 5, RunStatus::OK};
+                compressed->write(record);
+                plain->write(record);
+            }
+            compressed->close();
+            plain->close();
+
+            std::string content = readFile(outputTemplate + "kind:type=main|.csv" + getCompressionExtension(codec));
+            JsonValue index = readIndex(content);
+            REQUIRE(index.get("format").asString() == "csv");
+            std::size_t runsPerChunk = index.get("runsPerChunk").asInt();
+            std::vector<std::string> chunks = readChunks(content, index);
+            REQUIRE(chunks.size() == 2 + (runs - 1) / runsPerChunk);
+
+            std::string whole{};
+            long chunkRuns = 0;
+            for (std::size_t i=0; i<chunks.size(); ++i) {
+                whole += chunks[i];
+                chunkRuns += index.get("chunks").asArray()[i].get("runs").asInt();
+            }
+            REQUIRE(chunkRuns == runs);
+            REQUIRE(whole == readFile(plainTemplate + "kind:type=main|.csv"));
+            // the second chunk starts with the first run
+            REQUIRE(chunks[1].substr(0, 4) == "0,10");
+            // and the third one with the first run after the chunk
+            REQUIRE(chunks[2].substr(0, std::to_string(runsPerChunk).size() + 1) == std::to_string(runsPerChunk) + ",");
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#include "catch.hpp"
+
+#include "EngineTuner.hpp"
+#include "SequenceGenerators.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+TEST_CASE("tunables", "[tuner]") {
+    REQUIRE(EngineTuner::getTunables("MERGESORT") == std::vector<std::string>{"smallSortThreshold"});
+    REQUIRE(EngineTuner::getTunables("COMBSORT") == std::vector<std::string>{"shrinkFactor"});
+    REQUIRE(EngineTuner::getTunables("BUBBLESORT").empty());
+}
+
+TEST_CASE("tune the engines", "[tuner]") {
+    std::vector<int> input = generateRandomSequence(2000, 0, 100000);
+    EngineParameters start{1 / 1.3, 16, 8};
+
+    EngineParameters merge = EngineTuner{"MERGESORT", 100000, input, 3}.tune(start);
+    REQUIRE(merge.smallSortThreshold >= 1);
+    REQUIRE(merge.smallSortThreshold <= 256);
+    REQUIRE(merge.radixDigitBits == start.radixDigitBits);
+
+    EngineParameters radix = EngineTuner{"RADIXSORT", 100000, input, 3}.tune(start);
+    REQUIRE(radix.radixDigitBits >= 4);
+    REQUIRE(radix.radixDigitBits <= 16);
+
+    EngineParameters comb = EngineTuner{"COMBSORT", 100000, input, 3}.tune(start);
+    REQUIRE(comb.shrinkFactor >= 0.5);
+    REQUIRE(comb.shrinkFactor <= 0.95);
+    REQUIRE(comb.smallSortThreshold == start.smallSortThreshold);
+}
+
+TEST_CASE("tuning profiles", "[tuner]") {
+    char fileName[] = "/tmp/testEngineTunerXXXXXX";
+    int fd = mkstemp(fileName);
+    REQUIRE(fd >= 0);
+    close(fd);
+    remove(fileName);
+
+    EngineParameters tuned{0.7, 32, 11};
+    saveTuningProfile(fileName, tuned, {"smallSortThreshold"}, "RANDOM/1000");
+    tuned.radixDigitBits = 6;
+    // profiles of different engines accumulate in the same file
+    saveTuningProfile(fileName, tuned, {"radixDigitBits"}, "RANDOM/1000");
+
+    EngineParameters loaded{0.8, 8, 4};
+    applyTuningProfile(fileName, loaded);
+    REQUIRE(loaded.shrinkFactor == Approx(0.8));
+    REQUIRE(loaded.smallSortThreshold == 32);
+    REQUIRE(loaded.radixDigitBits == 6);
+
+    remove(fileName);
+    REQUIRE_THROWS_AS(applyTuningProfile(fileName, loaded), std::domain_error);
+}
@@ -0,0 +1,77 @@
+#include "catch.hpp"
+
+#include "HugePages.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("page kinds", "[hugePages]") {
+    for (const char* name : {"default", "thp", "hugetlb2M", "hugetlb1G"}) {
+        REQUIRE(getPageKindName(parsePageKind(name)) == name);
+    }
+    REQUIRE_THROWS_AS(parsePageKind("hugetlb4M"), std::domain_error);
+    REQUIRE(getHugePageSize(PageKind::HUGETLB_2M) == 2UL << 20);
+    REQUIRE(getHugePageSize(PageKind::HUGETLB_1G) == 1UL << 30);
+    REQUIRE(getHugePageSize(PageKind::THP) >= getHugePageSize(PageKind::DEFAULT));
+}
+
+TEST_CASE("page allocations", "[hugePages]") {
+    const std::size_t bytes = 5UL << 20;
+    for (PageKind kind : {PageKind::DEFAULT, PageKind::THP, PageKind::HUGETLB_2M, PageKind::HUGETLB_1G}) {
+        PageAllocation allocation{kind, bytes};
+        REQUIRE(allocation.getRequested() == kind);
+        REQUIRE(allocation.getBytes() == bytes);
+        // hugetlbfs pages fall back to transparent ones, which fall back to base ones
+        PageKind obtained = allocation.getObtained();
+        if (kind == PageKind::DEFAULT) {
+            REQUIRE(obtained == PageKind::DEFAULT);
+        } else if (kind == PageKind::THP) {
+            REQUIRE(obtained != PageKind::HUGETLB_2M);
+            REQUIRE(obtained != PageKind::HUGETLB_1G);
+        } else {
+            REQUIRE((obtained == kind || obtained == PageKind::THP || obtained == PageKind::DEFAULT));
+        }
+        REQUIRE(reinterpret_cast<uintptr_t>(allocation.getData()) % getHugePageSize(obtained) == 0);
+
+        unsigned char* data = static_cast<unsigned char*>(allocation.getData());
+        REQUIRE(data[0] == 0);
+        memset(data, 0x5a, bytes);
+        REQUIRE(data[bytes - 1] == 0x5a);
+        std::size_t huge = countHugePageBytes(data, bytes);
+        REQUIRE(huge <= bytes);
+        if (obtained == PageKind::DEFAULT) {
+            REQUIRE(huge == 0);
+        }
+    }
+}
+
+TEST_CASE("huge page advice on a vector", "[hugePages]") {
+    std::vector<int> buffer{};
+    REQUIRE(adviseHugePages(buffer.data(), 0) == PageKind::DEFAULT);
+    buffer.reserve(1 << 20);
+    PageKind obtained = adviseHugePages(buffer.data(), buffer.capacity() * sizeof(int));
+    REQUIRE((obtained == PageKind::THP || obtained == PageKind::DEFAULT));
+    buffer.resize(1 << 20, 1);
+    REQUIRE(countHugePageBytes(buffer.data(), buffer.size() * sizeof(int)) <= buffer.size() * sizeof(int));
+}
+
+TEST_CASE("pages report", "[hugePages]") {
+    FILE* file = tmpfile();
+    REQUIRE(file != nullptr);
+    writePagesReport(file, std::vector<PageReport>{
+        PageReport{"sequence", PageKind::HUGETLB_2M, PageKind::THP, 8UL << 20, 4UL << 20},
+        PageReport{"scratch", PageKind::HUGETLB_1G, PageKind::DEFAULT, 4096, 0}
+    });
+    rewind(file);
+    char text[512] = {0};
+    REQUIRE(fread(text, 1, sizeof(text) - 1, file) > 0);
+    fclose(file);
+    std::string report{text};
+    std::size_t thpSize = getHugePageSize(PageKind::THP);
+    REQUIRE(report == "buffer,requested,obtained,bytes,hugePages,hugePageBytes\n"
+        "sequence,hugetlb2M,thp,8388608," + std::to_string((4UL << 20) / thpSize) + ",4194304\n"
+        "scratch,hugetlb1G,default,4096,0,0\n");
+}
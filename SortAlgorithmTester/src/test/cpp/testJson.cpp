@@ -0,0 +1,35 @@
+#include "catch.hpp"
+
+#include "Json.hpp"
+
+#include <stdexcept>
+
+TEST_CASE("parse json", "[json]") {
+    JsonValue value = JsonValue::parse(" {\"a\": 1, \"b\": [true, false, null], \"c\": \"x\\\"y\\n\", \"d\": -2.5e1} ");
+    REQUIRE(value.isObject());
+    REQUIRE(value.get("a").asInt() == 1);
+    REQUIRE(value.get("b").asArray().size() == 3);
+    REQUIRE(value.get("b").asArray()[0].asBool());
+    REQUIRE(value.get("b").asArray()[2].isNull());
+    REQUIRE(value.get("c").asString() == "x\"y\n");
+    REQUIRE(value.get("d").asNumber() == -25);
+    REQUIRE_FALSE(value.has("e"));
+    REQUIRE_THROWS_AS(value.get("e"), std::domain_error);
+    REQUIRE_THROWS_AS(value.get("a").asString(), std::domain_error);
+}
+
+TEST_CASE("invalid json", "[json]") {
+    REQUIRE_THROWS_AS(JsonValue::parse(""), std::domain_error);
+    REQUIRE_THROWS_AS(JsonValue::parse("{\"a\": }"), std::domain_error);
+    REQUIRE_THROWS_AS(JsonValue::parse("[1, 2"), std::domain_error);
+    REQUIRE_THROWS_AS(JsonValue::parse("\"abc"), std::domain_error);
+    REQUIRE_THROWS_AS(JsonValue::parse("1 2"), std::domain_error);
+}
+
+TEST_CASE("dump json", "[json]") {
+    JsonValue value = JsonValue::object();
+    value.set("n", 3).set("x", 0.5).set("s", "a\tb").set("l", JsonValue::array().push(true).push(JsonValue{}));
+    value.set("n", 4);
+    REQUIRE(value.dump() == "{\"n\":4,\"x\":0.5,\"s\":\"a\\tb\",\"l\":[true,null]}");
+    REQUIRE(JsonValue::parse(value.dump()).dump() == value.dump());
+}
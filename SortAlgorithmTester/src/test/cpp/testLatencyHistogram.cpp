@@ -0,0 +1,52 @@
+#include "catch.hpp"
+
+#include "LatencyHistogram.hpp"
+
+TEST_CASE("empty histogram", "[histogram]") {
+    LatencyHistogram h{1000000, 3};
+    REQUIRE(h.getTotalCount() == 0);
+    REQUIRE(h.getValueAtPercentile(50) == 0);
+    REQUIRE(h.getMax() == 0);
+    REQUIRE(h.getStdDev() == 0);
+}
+
+TEST_CASE("percentiles are within the requested precision", "[histogram]") {
+    LatencyHistogram h{3600ULL * 1000000000ULL, 3};
+    for (uint64_t i=1; i<=100000; ++i) {
+        h.record(i * 1000);
+    }
+
+    REQUIRE(h.getTotalCount() == 100000);
+    REQUIRE(h.getMin() == 1000);
+    REQUIRE(h.getMax() == 100000000);
+    REQUIRE(h.getMean() == Approx(50000500));
+    REQUIRE(h.getStdDev() == Approx(28867657).epsilon(0.001));
+
+    REQUIRE(h.getValueAtPercentile(50) == Approx(50000000).epsilon(0.001));
+    REQUIRE(h.getValueAtPercentile(90) == Approx(90000000).epsilon(0.001));
+    REQUIRE(h.getValueAtPercentile(99) == Approx(99000000).epsilon(0.001));
+    REQUIRE(h.getValueAtPercentile(99.9) == Approx(99900000).epsilon(0.001));
+    REQUIRE(h.getValueAtPercentile(100) == 100000000);
+}
+
+TEST_CASE("small values are recorded exactly", "[histogram]") {
+    LatencyHistogram h{1000000, 3};
+    h.record(3);
+    h.record(5);
+    h.record(7);
+    REQUIRE(h.getValueAtPercentile(0) == 3);
+    REQUIRE(h.getValueAtPercentile(50) == 5);
+    REQUIRE(h.getValueAtPercentile(100) == 7);
+
+    h.reset();
+    REQUIRE(h.getTotalCount() == 0);
+}
+
+TEST_CASE("values over the trackable range are clamped", "[histogram]") {
+    LatencyHistogram h{1000, 2};
+    h.record(10);
+    h.record(1000000);
+    REQUIRE(h.getMax() == 1000000);
+    REQUIRE(h.getValueAtPercentile(100) <= 1000000);
+    REQUIRE(h.getValueAtPercentile(100) >= 1000);
+}
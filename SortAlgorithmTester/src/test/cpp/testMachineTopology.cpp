@@ -0,0 +1,94 @@
+#include "catch.hpp"
+
+#include "MachineTopology.hpp"
+#include "EngineParameters.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+static void writeFile(const std::string& fileName, const std::string& content) {
+    system(("mkdir -p \"$(dirname '" + fileName + "')\"").c_str());
+    FILE* f = fopen(fileName.c_str(), "w");
+    fputs(content.c_str(), f);
+    fclose(f);
+}
+
+TEST_CASE("cpu lists", "[topology]") {
+    REQUIRE(parseCpuList("0-3,8,10-11") == std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+    REQUIRE(parseCpuList("5") == std::vector<int>{5});
+    REQUIRE(parseCpuList("") == std::vector<int>{});
+}
+
+TEST_CASE("probe a fake sysfs", "[topology]") {
+    char root[] = "/tmp/testMachineTopologyXXXXXX";
+    REQUIRE(mkdtemp(root) != nullptr);
+    std::string cpu = std::string{root} + "/cpu";
+    std::string node = std::string{root} + "/node";
+
+    // 2 packages, 2 cores each, 2 threads per core
+    writeFile(cpu + "/online", "0-7\n");
+    for (int i=0; i<8; ++i) {
+        std::string topology = cpu + "/cpu" + std::to_string(i) + "/topology/";
+        writeFile(topology + "core_id", std::to_string((i / 2) % 2) + "\n");
+        writeFile(topology + "physical_package_id", std::to_string(i / 4) + "\n");
+    }
+    std::string cache = cpu + "/cpu0/cache/";
+    writeFile(cache + "index0/level", "1\n");
+    writeFile(cache + "index0/type", "Data\n");
+    writeFile(cache + "index0/size", "48K\n");
+    writeFile(cache + "index0/coherency_line_size", "128\n");
+    writeFile(cache + "index1/level", "1\n");
+    writeFile(cache + "index1/type", "Instruction\n");
+    writeFile(cache + "index1/size", "32K\n");
+    writeFile(cache + "index2/level", "2\n");
+    writeFile(cache + "index2/type", "Unified\n");
+    writeFile(cache + "index2/size", "2048K\n");
+    writeFile(cache + "index3/level", "3\n");
+    writeFile(cache + "index3/type", "Unified\n");
+    writeFile(cache + "index3/size", "30M\n");
+    writeFile(node + "/node0/cpulist", "0-3\n");
+    writeFile(node + "/node1/cpulist", "4-7\n");
+
+    MachineTopology topology = probeMachineTopology(cpu, node);
+    REQUIRE(topology.l1DataCacheSize == 48 * 1024);
+    REQUIRE(topology.l2CacheSize == 2048 * 1024);
+    REQUIRE(topology.lastLevelCacheSize == 30 * 1024 * 1024);
+    REQUIRE(topology.cacheLineSize == 128);
+    REQUIRE(topology.numaNodes == 2);
+    REQUIRE(topology.getLogicalCores() == 8);
+    REQUIRE(topology.getPhysicalCores() == 4);
+    REQUIRE(topology.cpus[5].node == 1);
+    REQUIRE(topology.cpus[5].package == 1);
+
+    SECTION("the topology can be cached") {
+        std::string cacheFile = std::string{root} + "/topology.txt";
+        saveMachineTopology(cacheFile, topology);
+        MachineTopology loaded = loadMachineTopology(cacheFile);
+        REQUIRE(loaded.l1DataCacheSize == topology.l1DataCacheSize);
+        REQUIRE(loaded.lastLevelCacheSize == topology.lastLevelCacheSize);
+        REQUIRE(loaded.cacheLineSize == topology.cacheLineSize);
+        REQUIRE(loaded.numaNodes == 2);
+        REQUIRE(loaded.getPhysicalCores() == 4);
+        REQUIRE(loaded.cpus[7].node == 1);
+    }
+
+    SECTION("engine parameters follow the caches") {
+        EngineParameters parameters = deriveEngineParameters(topology);
+        // 128 bytes lines: 2 lines hold 64 ints
+        REQUIRE(parameters.smallSortThreshold == 64);
+        // 48K/2 bytes of int counters: 6144 counters, 2^12 fits
+        REQUIRE(parameters.radixDigitBits == 12);
+    }
+
+    system((std::string{"rm -rf "} + root).c_str());
+}
+
+TEST_CASE("probe this machine", "[topology]") {
+    MachineTopology topology = probeMachineTopology();
+    REQUIRE(topology.getLogicalCores() >= 1);
+    REQUIRE(topology.getPhysicalCores() >= 1);
+    REQUIRE(topology.cacheLineSize > 0);
+    REQUIRE(topology.l1DataCacheSize > 0);
+}
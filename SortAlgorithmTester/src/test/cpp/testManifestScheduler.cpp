@@ -0,0 +1,176 @@
+#include "catch.hpp"
+
+#include "AsyncResultWriter.hpp"
+#include "ManifestScheduler.hpp"
+#include "TestFiles.hpp"
+
+#include <cstdlib>
+#include <unistd.h>
+
+static JsonValue makeContext(const std::string& outputTemplate) {
+    return JsonValue::object()
+        .set("sequenceSize", 100)
+        .set("sequenceType", "RANDOM")
+        .set("algorithm", "MERGESORT")
+        .set("lowerBound", 0)
+        .set("upperBound", 1000)
+        .set("runs", 3)
+        .set("seed", 1)
+        .set("outputTemplate", outputTemplate);
+}
+
+TEST_CASE("core slots", "[manifest]") {
+    MachineTopology topology{};
+    // 2 packages with 2 cores of 2 threads each
+    topology.cpus = {
+        {0, 0, 0, 0}, {1, 1, 0, 0}, {2, 0, 1, 0}, {3, 1, 1, 0},
+        {4, 0, 0, 0}, {5, 1, 0, 0}, {6, 0, 1, 0}, {7, 1, 1, 0}
+    };
+    std::vector<CoreSlot> cores = getCoreSlots(topology, {0, 1, 2, 3, 4, 5, 6, 7, 9});
+    REQUIRE(cores.size() == 5);
+    REQUIRE(cores[0].package == 0);
+    REQUIRE(cores[0].cpus == std::vector<int>{0, 4});
+    REQUIRE(cores[1].cpus == std::vector<int>{1, 5});
+    REQUIRE(cores[2].package == 0);
+    REQUIRE(cores[2].cpus == std::vector<int>{9});
+    REQUIRE(cores[3].package == 1);
+    REQUIRE(cores[3].cpus == std::vector<int>{2, 6});
+
+    // only the allowed cpus count
+    cores = getCoreSlots(topology, {0, 2, 3});
+    REQUIRE(cores.size() == 3);
+    REQUIRE(cores[0].cpus == std::vector<int>{0});
+}
+
+TEST_CASE("core scheduler", "[manifest]") {
+    std::vector<CoreSlot> cores{{0, {0, 4}}, {0, {1, 5}}, {1, {2, 6}}, {1, {3, 7}}};
+    CoreScheduler scheduler{cores};
+
+    std::vector<std::size_t> first = scheduler.acquire(Placement::CORE);
+    REQUIRE(first == std::vector<std::size_t>{0});
+    REQUIRE(scheduler.getCpus(first) == std::vector<int>{0, 4});
+    // package 0 is partially used: the socket is package 1
+    std::vector<std::size_t> socket = scheduler.acquire(Placement::SOCKET);
+    REQUIRE(socket == std::vector<std::size_t>{2, 3});
+    REQUIRE(scheduler.getCpus(socket) == std::vector<int>{2, 6, 3, 7});
+    REQUIRE(scheduler.acquire(Placement::SOCKET).empty());
+    REQUIRE(scheduler.acquire(Placement::CORE) == std::vector<std::size_t>{1});
+    REQUIRE(scheduler.acquire(Placement::CORE).empty());
+    REQUIRE(scheduler.getFreeCoreCount() == 0);
+
+    scheduler.release(first);
+    REQUIRE(scheduler.getFreeCoreCount() == 1);
+    REQUIRE(scheduler.acquire(Placement::SOCKET).empty());
+    scheduler.release(socket);
+    REQUIRE(scheduler.acquire(Placement::SOCKET) == std::vector<std::size_t>{2, 3});
+
+    REQUIRE(parsePlacement("core") == Placement::CORE);
+    REQUIRE_THROWS_AS(parsePlacement("numa"), std::domain_error);
+}
+
+TEST_CASE("manifest", "[manifest]") {
+    std::string directory = makeTemplate("testManifestScheduler");
+    std::string manifestName = directory + "contexts.jsonl";
+    FILE* manifest = fopen(manifestName.c_str(), "w");
+    REQUIRE(manifest != nullptr);
+    fprintf(manifest, "%s\n\n", makeContext(directory + "a_").dump().c_str());
+    fprintf(manifest, "%s\n", makeContext(directory + "b_").set("placement", "socket").set("algorithm", "COMBSORT").dump().c_str());
+    fprintf(manifest, "%s\n", makeContext(directory + "c_").set("sequenceType", "NOPE").dump().c_str());
+    fclose(manifest);
+
+    std::vector<ManifestEntry> entries = readManifest(manifestName);
+    REQUIRE(entries.size() == 3);
+    REQUIRE(entries[0].line == 1);
+    REQUIRE(entries[0].placement == Placement::CORE);
+    REQUIRE(entries[1].line == 3);
+    REQUIRE(entries[1].placement == Placement::SOCKET);
+    REQUIRE(entries[1].context.algorithm == "COMBSORT");
+    REQUIRE(entries[1].parameters.get("outputTemplate").asString() == directory + "b_");
+
+    std::vector<int> allowed = getAllowedCpus();
+    std::vector<CoreSlot> cores = getCoreSlots(MachineTopology{}, {allowed[0]});
+    FILE* report = tmpfile();
+    // the context with an unknown sequence type fails
+    REQUIRE(runManifest(entries, cores, report) == 1);
+    rewind(report);
+    char* line = nullptr;
+    std::size_t capacity = 0;
+    std::vector<JsonValue> lines{};
+    while (getline(&line, &capacity, report) >= 0) {
+        lines.push_back(JsonValue::parse(line));
+    }
+    free(line);
+    fclose(report);
+    // a single core: the contexts run one after the other
+    REQUIRE(lines.size() == 3);
+    REQUIRE(lines[0].get("line").asInt() == 1);
+    REQUIRE(lines[0].get("exitCode").asInt() == 0);
+    REQUIRE(lines[0].get("cpus").asArray().size() == 1);
+    REQUIRE(lines[0].get("cpus").asArray()[0].asInt() == allowed[0]);
+    REQUIRE(lines[1].get("line").asInt() == 3);
+    REQUIRE(lines[1].get("exitCode").asInt() == 0);
+    REQUIRE(lines[2].get("exitCode").asInt() == 1);
+    REQUIRE(access((directory + "a_kind:type=main|.csv").c_str(), F_OK) == 0);
+    REQUIRE(access((directory + "b_kind:type=summary|.csv").c_str(), F_OK) == 0);
+
+    manifest = fopen(manifestName.c_str(), "w");
+    fprintf(manifest, "%s\n{\"runs\": 3}\n", makeContext(directory + "a_").dump().c_str());
+    fclose(manifest);
+    REQUIRE_THROWS_WITH(readManifest(manifestName), Catch::Contains("contexts.jsonl:2"));
+    REQUIRE_THROWS_AS(readManifest(directory + "missing.jsonl"), std::domain_error);
+}
+
+TEST_CASE("resume a manifest", "[manifest]") {
+    std::string directory = makeTemplate("testManifestScheduler");
+    std::string manifestName = directory + "contexts.jsonl";
+    FILE* manifest = fopen(manifestName.c_str(), "w");
+    REQUIRE(manifest != nullptr);
+    fprintf(manifest, "%s\n", makeContext(directory + "a_").dump().c_str());
+    fprintf(manifest, "%s\n", makeContext(directory + "b_").dump().c_str());
+    fclose(manifest);
+    std::vector<ManifestEntry> entries = readManifest(manifestName);
+    std::vector<CoreSlot> cores = getCoreSlots(MachineTopology{}, {getAllowedCpus()[0]});
+
+    {
+        CampaignJournal journal{directory + "journal.jsonl"};
+        FILE* report = tmpfile();
+        REQUIRE(runManifest(entries, cores, report, &journal) == 0);
+        fclose(report);
+        REQUIRE(journal.getFinishedCount() == 2);
+    }
+    // b has been damaged: only b runs again
+    unlink((directory + "b_kind:type=summary|.csv").c_str());
+    CampaignJournal journal{directory + "journal.jsonl"};
+    FILE* report = tmpfile();
+    REQUIRE(runManifest(entries, cores, report, &journal) == 0);
+    rewind(report);
+    char* line = nullptr;
+    std::size_t capacity = 0;
+    std::vector<JsonValue> lines{};
+    while (getline(&line, &capacity, report) >= 0) {
+        lines.push_back(JsonValue::parse(line));
+    }
+    free(line);
+    fclose(report);
+    REQUIRE(lines.size() == 2);
+    REQUIRE(lines[0].get("skipped").asBool());
+    REQUIRE(lines[0].get("exitCode").asInt() == 0);
+    REQUIRE_FALSE(lines[1].has("skipped"));
+    REQUIRE(lines[1].get("exitCode").asInt() == 0);
+    REQUIRE(access((directory + "b_kind:type=summary|.csv").c_str(), F_OK) == 0);
+
+    // every context is journaled: there is nothing to run
+    report = tmpfile();
+    REQUIRE(runManifest(entries, cores, report, &journal) == 0);
+    rewind(report);
+    lines.clear();
+    line = nullptr;
+    while (getline(&line, &capacity, report) >= 0) {
+        lines.push_back(JsonValue::parse(line));
+    }
+    free(line);
+    fclose(report);
+    REQUIRE(lines.size() == 2);
+    REQUIRE(lines[0].get("skipped").asBool());
+    REQUIRE(lines[1].get("skipped").asBool());
+}
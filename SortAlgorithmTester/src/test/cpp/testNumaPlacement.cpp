@@ -0,0 +1,110 @@
+#include "catch.hpp"
+
+#include "NumaPlacement.hpp"
+#include "AsyncResultWriter.hpp"
+#include "SequenceValidator.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+/**
+ * 2 nodes of 2 cpus each
+ */
+static MachineTopology makeTopology() {
+    MachineTopology topology{};
+    topology.numaNodes = 2;
+    topology.cpus = std::vector<CpuLocation>{{0, 0, 0, 0}, {1, 1, 0, 0}, {2, 0, 1, 1}, {3, 1, 1, 1}};
+    return topology;
+}
+
+TEST_CASE("numa policies", "[numa]") {
+    REQUIRE(parseNumaPolicy("none") == NumaPolicy::NONE);
+    REQUIRE(parseNumaPolicy("interleave") == NumaPolicy::INTERLEAVE);
+    REQUIRE(parseNumaPolicy("local") == NumaPolicy::LOCAL);
+    REQUIRE(parseNumaPolicy("firstTouchParallel") == NumaPolicy::FIRST_TOUCH_PARALLEL);
+    REQUIRE_THROWS_AS(parseNumaPolicy("remote"), std::domain_error);
+}
+
+TEST_CASE("numa placement plan", "[numa]") {
+    MachineTopology topology = makeTopology();
+    std::vector<int> allowed{0, 1, 2, 3};
+
+    SECTION("the local node comes first") {
+        NumaPlacement placement{NumaPolicy::LOCAL, topology, allowed, 3};
+        REQUIRE(placement.getNodes() == (std::vector<int>{1, 0}));
+        REQUIRE(placement.getChunkNodes(3) == (std::vector<int>{1, 1, 1}));
+        REQUIRE(placement.getCallerCpus() == (std::vector<int>{2, 3}));
+        REQUIRE(placement.getWorkerCpus(3) == (std::vector<std::vector<int>>{{2, 3}, {2, 3}}));
+    }
+
+    SECTION("parallel chunks are spread over the nodes, in contiguous parts") {
+        NumaPlacement placement{NumaPolicy::FIRST_TOUCH_PARALLEL, topology, allowed, 0};
+        REQUIRE(placement.getChunkNodes(4) == (std::vector<int>{0, 0, 1, 1}));
+        REQUIRE(placement.getChunkNodes(1) == (std::vector<int>{0}));
+        REQUIRE(placement.getCallerCpus() == (std::vector<int>{0, 1}));
+        REQUIRE(placement.getWorkerCpus(4) == (std::vector<std::vector<int>>{{0, 1}, {2, 3}, {2, 3}}));
+    }
+
+    SECTION("interleaved pages don't pin anything") {
+        NumaPlacement placement{NumaPolicy::INTERLEAVE, topology, allowed, 0};
+        REQUIRE(placement.getChunkNodes(2) == (std::vector<int>{-1, -1}));
+        REQUIRE(placement.getCallerCpus().empty());
+        REQUIRE(placement.getWorkerCpus(2) == (std::vector<std::vector<int>>{{}}));
+    }
+
+    SECTION("only allowed cpus are used") {
+        NumaPlacement placement{NumaPolicy::LOCAL, topology, std::vector<int>{0, 1}, 0};
+        REQUIRE(placement.getNodes() == (std::vector<int>{0}));
+    }
+}
+
+TEST_CASE("numa placement on this machine", "[numa]") {
+    MachineTopology topology = probeMachineTopology();
+    std::vector<int> buffer(1 << 20, 1);
+    std::vector<std::pair<std::size_t, std::size_t>> chunks = getValidationChunks(buffer.size(), 4);
+    for (NumaPolicy policy : {NumaPolicy::INTERLEAVE, NumaPolicy::LOCAL, NumaPolicy::FIRST_TOUCH_PARALLEL}) {
+        NumaPlacement placement{policy, topology, getAllowedCpus(), sched_getcpu()};
+        placement.place(buffer, chunks);
+        // the content doesn't change, and every page is on one of our nodes
+        REQUIRE(buffer[buffer.size() / 2] == 1);
+        std::map<int, long> pages = countPagesPerNode(buffer.data(), buffer.size() * sizeof(int));
+        long total = 0;
+        for (auto& node : pages) {
+            REQUIRE(std::find(placement.getNodes().begin(), placement.getNodes().end(), node.first) != placement.getNodes().end());
+            total += node.second;
+        }
+        REQUIRE(total * sysconf(_SC_PAGESIZE) >= static_cast<long>(buffer.size() * sizeof(int)));
+    }
+}
+
+TEST_CASE("thread affinity guard", "[numa]") {
+    std::vector<int> allowed = getAllowedCpus();
+    {
+        ThreadAffinityGuard guard{std::vector<int>{allowed[0]}};
+        REQUIRE(getAllowedCpus() == std::vector<int>{allowed[0]});
+    }
+    REQUIRE(getAllowedCpus() == allowed);
+    {
+        ThreadAffinityGuard guard{std::vector<int>{}};
+        REQUIRE(getAllowedCpus() == allowed);
+    }
+}
+
+TEST_CASE("numa report", "[numa]") {
+    char* content = nullptr;
+    size_t size = 0;
+    FILE* file = open_memstream(&content, &size);
+    std::map<int, long> pages{{0, 3}, {1, 1}};
+    std::map<int, NumaNodeCounters> before{{0, {10, 1}}, {1, {5, 0}}};
+    std::map<int, NumaNodeCounters> after{{0, {15, 1}}, {1, {5, 2}}};
+    writeNumaReport(file, pages, before, after, 2.0, 4);
+    fclose(file);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    std::string expected = "node,pages,bytes,bytesPerSecond,localAllocations,remoteAllocations\n" +
+        std::string{"0,3,"} + std::to_string(3 * pageSize) + "," + std::to_string(6 * pageSize) + ",5,0\n" +
+        "1,1," + std::to_string(pageSize) + "," + std::to_string(2 * pageSize) + ",0,2\n";
+    REQUIRE(std::string{content} == expected);
+    free(content);
+}
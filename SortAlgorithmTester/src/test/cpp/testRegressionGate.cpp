@@ -0,0 +1,73 @@
+#include "catch.hpp"
+
+#include "RegressionGate.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+
+TEST_CASE("thresholds", "[regression]") {
+    REQUIRE(parseThreshold("5%") == Approx(0.05));
+    REQUIRE(parseThreshold("0.1") == Approx(0.1));
+    REQUIRE_THROWS_AS(parseThreshold("five"), std::domain_error);
+    REQUIRE_THROWS_AS(parseThreshold("%"), std::domain_error);
+    REQUIRE_THROWS_AS(parseThreshold("-3%"), std::domain_error);
+}
+
+TEST_CASE("median", "[regression]") {
+    REQUIRE(computeMedian({3, 1, 2}) == 2);
+    REQUIRE(computeMedian({4, 1, 3, 2}) == 2.5);
+    REQUIRE(computeMedian({}) == 0);
+}
+
+TEST_CASE("Mann-Whitney U", "[regression]") {
+    std::vector<double> baseline{10, 11, 12, 10, 11, 12, 10, 11, 12, 11};
+    std::vector<double> same{11, 12, 10, 11, 10, 12, 11, 12, 10, 11};
+    std::vector<double> slower{13, 14, 15, 13, 14, 15, 13, 14, 15, 14};
+
+    REQUIRE(mannWhitneyUGreaterPValue(same, baseline) > 0.3);
+    REQUIRE(mannWhitneyUGreaterPValue(slower, baseline) < 0.001);
+    // the test is one-sided: getting faster is not a regression
+    REQUIRE(mannWhitneyUGreaterPValue(baseline, slower) > 0.99);
+    REQUIRE(mannWhitneyUGreaterPValue({5, 5}, {5, 5}) == 1);
+}
+
+TEST_CASE("regression check", "[regression]") {
+    Baseline baseline{{10, 11, 12, 10, 11, 12, 10, 11, 12, 11}, 11};
+
+    RegressionReport slower = checkRegression(baseline, {13, 14, 15, 13, 14, 15, 13, 14, 15, 14}, 0.05, 0.05);
+    REQUIRE(slower.regression);
+    REQUIRE(slower.relativeChange == Approx(3.0 / 11));
+
+    RegressionReport tolerated = checkRegression(baseline, {13, 14, 15, 13, 14, 15, 13, 14, 15, 14}, 0.5, 0.05);
+    REQUIRE_FALSE(tolerated.regression);
+
+    // with a summary we can only look at the median
+    Baseline summary{{}, 11};
+    RegressionReport fromSummary = checkRegression(summary, {12, 12, 12}, 0.05, 0.05);
+    REQUIRE(fromSummary.pValue == -1);
+    REQUIRE(fromSummary.regression);
+}
+
+TEST_CASE("baseline files", "[regression]") {
+    char mainCsv[] = "/tmp/testRegressionGateMainXXXXXX";
+    int fd = mkstemp(mainCsv);
+    FILE* f = fdopen(fd, "w");
+    fprintf(f, "run,time,preempted\n0,10,0\n1,30,0\n2,20,1\n");
+    fclose(f);
+    Baseline fromMain = loadBaseline(mainCsv);
+    REQUIRE(fromMain.samples.size() == 3);
+    REQUIRE(fromMain.median == 20);
+    remove(mainCsv);
+
+    char summaryCsv[] = "/tmp/testRegressionGateSummaryXXXXXX";
+    fd = mkstemp(summaryCsv);
+    f = fdopen(fd, "w");
+    fprintf(f, "runs,mean,stddev,p50,p90,p99,p999,max\n3,20.000,10.000,20.000,30.000,30.000,30.000,30.000\n");
+    fclose(f);
+    Baseline fromSummary = loadBaseline(summaryCsv);
+    REQUIRE(fromSummary.samples.empty());
+    REQUIRE(fromSummary.median == 20);
+    remove(summaryCsv);
+
+    REQUIRE_THROWS_AS(loadBaseline("/nonexistent/baseline.csv"), std::domain_error);
+}
@@ -0,0 +1,205 @@
+#include "catch.hpp"
+
+#include "ResultWriter.hpp"
+#include "Json.hpp"
+#include "TestFiles.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static RunRecord makeRecord(long run, RunStatus status) {
+    return RunRecord{run, 100 + run, 1, 2, 3, 4000, run % 2 == 0, 5, status};
+}
+
+TEST_CASE("csv results", "[results]") {
+    std::string outputTemplate = makeTemplate("testResultWriter");
+    std::unique_ptr<ResultWriter> writer{createResultWriter("csv", outputTemplate, 2)};
+    writer->write(makeRecord(0, RunStatus::OK));
+    writer->write(makeRecord(1, RunStatus::TIMEOUT));
+    writer->close();
+
+    REQUIRE(readFile(outputTemplate + "kind:type=main|.csv") ==
+        "run,time,voluntaryContextSwitches,involuntaryContextSwitches,cpuMigrations,runQueueDelay,preempted,validationTime,status\n"
+        "0,100,1,2,3,4000,1,5,ok\n"
+        "1,101,1,2,3,4000,0,5,timeout\n"
+    );
+    REQUIRE_THROWS_AS(createResultWriter("xml", outputTemplate, 2), std::domain_error);
+}
+
+TEST_CASE("binary results", "[results]") {
+    std::string outputTemplate = makeTemplate("testResultWriter");
+    // more than a block, less than the capacity
+    const long runs = 5000;
+    std::unique_ptr<ResultWriter> writer{createResultWriter("binary", outputTemplate, runs + 10)};
+    for (long run=0; run<runs; ++run) {
+        writer->write(makeRecord(run, run == runs - 1 ? RunStatus::TIMEOUT : RunStatus::OK));
+    }
+    writer->close();
+
+    std::string content = readFile(outputTemplate + "kind:type=main|.bin");
+    REQUIRE(content.substr(0, 8) == "SORTCOL1");
+    uint64_t length;
+    memcpy(&length, content.data() + 8, sizeof(length));
+    JsonValue header = JsonValue::parse(content.substr(16, length));
+    REQUIRE(header.get("rows").asInt() == runs);
+
+    auto& columns = header.get("columns").asArray();
+    REQUIRE(columns.size() == getRunRecordColumnNames().size());
+    REQUIRE(columns[1].get("name").asString() == "time");
+    REQUIRE(columns[1].get("dtype").asString() == "<i8");
+    const char* time = content.data() + columns[1].get("offset").asInt();
+    for (long run=0; run<runs; ++run) {
+        int64_t value;
+        memcpy(&value, time + run * sizeof(value), sizeof(value));
+        REQUIRE(value == 100 + run);
+    }
+    REQUIRE(columns[8].get("categories").asArray()[1].asString() == "timeout");
+    const char* status = content.data() + columns[8].get("offset").asInt();
+    REQUIRE(status[0] == 0);
+    REQUIRE(status[runs - 1] == 1);
+}
+
+TEST_CASE("binary results can't exceed their capacity", "[results]") {
+    std::string outputTemplate = makeTemplate("testResultWriter");
+    std::unique_ptr<ResultWriter> writer{createResultWriter("binary", outputTemplate, 1)};
+    writer->write(makeRecord(0, RunStatus::OK));
+    writer->write(makeRecord(1, RunStatus::OK));
+    REQUIRE_THROWS_AS(writer->close(), std::domain_error);
+}
+
+TEST_CASE("arrow results", "[results]") {
+    std::string outputTemplate = makeTemplate("testResultWriter");
+    std::unique_ptr<ResultWriter> writer{createResultWriter("arrow", outputTemplate, 3)};
+    for (long run=0; run<3; ++run) {
+        writer->write(makeRecord(run, RunStatus::OK));
+    }
+    writer->close();
+
+    std::string content = readFile(outputTemplate + "kind:type=main|.arrow");
+    REQUIRE(content.substr(0, 6) == "ARROW1");
+    REQUIRE(content.substr(content.size() - 6) == "ARROW1");
+    int32_t footerLength;
+    memcpy(&footerLength, content.data() + content.size() - 10, sizeof(footerLength));
+    REQUIRE(footerLength > 0);
+    REQUIRE(static_cast<std::size_t>(footerLength) + 8 + 10 < content.size());
+    // the schema message follows the magic
+    uint32_t continuation;
+    memcpy(&continuation, content.data() + 8, sizeof(continuation));
+    REQUIRE(continuation == 0xFFFFFFFFU);
+    REQUIRE(content.find("validationTime") != std::string::npos);
+    REQUIRE(content.find("okokok") != std::string::npos);
+}
+
+TEST_CASE("jsonl results", "[results]") {
+    std::string outputTemplate = makeTemplate("testResultWriter");
+    JsonValue metadata = JsonValue::object().set("parameters", JsonValue::object().set("algorithm", "MERGESORT"));
+    std::unique_ptr<ResultWriter> writer{createResultWriter("jsonl", outputTemplate, 2, metadata)};
+    writer->write(makeRecord(0, RunStatus::OK));
+    writer->write(makeRecord(1, RunStatus::TIMEOUT));
+    writer->close();
+
+    std::ifstream file{outputTemplate + "kind:type=main|.jsonl"};
+    std::string line;
+    std::vector<JsonValue> records{};
+    while (std::getline(file, line)) {
+        records.push_back(JsonValue::parse(line));
+    }
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0].get("time").asInt() == 100);
+    REQUIRE(records[0].get("preempted").asBool());
+    REQUIRE(records[1].get("status").asString() == "timeout");
+    REQUIRE(records[1].get("parameters").get("algorithm").asString() == "MERGESORT");
+
+    REQUIRE_THROWS_AS(JsonlResultWriter(outputTemplate + "other.jsonl", JsonValue::array()), std::domain_error);
+}
+
+TEST_CASE("shared memory results", "[results]") {
+    std::string name = "testResultWriter" + std::to_string(getpid());
+    ShmResultWriter writer{name, 10};
+
+    int fd = shm_open(("/" + name).c_str(), O_RDONLY, 0);
+    REQUIRE(fd >= 0);
+    struct stat info;
+    REQUIRE(fstat(fd, &info) == 0);
+    char* memory = static_cast<char*>(mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0));
+    close(fd);
+    REQUIRE(memory != MAP_FAILED);
+    shm_unlink(("/" + name).c_str());
+
+    REQUIRE(std::string(memory, 8) == "SORTSHM1");
+    uint64_t header[3];
+    memcpy(header, memory + 8, sizeof(header));
+    REQUIRE(header[0] == 0);
+    REQUIRE(header[1] == 0);
+    JsonValue layout = JsonValue::parse(std::string(memory + 32, header[2]));
+    REQUIRE(layout.get("capacity").asInt() == 10);
+
+    // the reader sees the rows while they are written
+    writer.write(makeRecord(0, RunStatus::OK));
+    writer.write(makeRecord(1, RunStatus::TIMEOUT));
+    memcpy(header, memory + 8, sizeof(header));
+    REQUIRE(header[0] == 2);
+    int64_t time;
+    memcpy(&time, memory + layout.get("columns").asArray()[1].get("offset").asInt() + sizeof(int64_t), sizeof(time));
+    REQUIRE(time == 101);
+    REQUIRE(memory[layout.get("columns").asArray()[8].get("offset").asInt() + 1] == 1);
+
+    writer.close();
+    memcpy(header, memory + 8, sizeof(header));
+    REQUIRE(header[1] == 1);
+    munmap(memory, info.st_size);
+}
+
+#ifdef WITH_SQLITE
+#include <sqlite3.h>
+
+static long queryLong(sqlite3* database, const std::string& sql) {
+    sqlite3_stmt* statement;
+    REQUIRE(sqlite3_prepare_v2(database, sql.c_str(), -1, &statement, nullptr) == SQLITE_OK);
+    REQUIRE(sqlite3_step(statement) == SQLITE_ROW);
+    long result = static_cast<long>(sqlite3_column_int64(statement, 0));
+    sqlite3_finalize(statement);
+    return result;
+}
+
+TEST_CASE("sqlite results", "[results]") {
+    std::string fileName = makeTemplate("testResultWriter") + "results.sqlite";
+    JsonValue metadata = JsonValue::object().set("parameters", JsonValue::object()
+        .set("algorithm", "MERGESORT")
+        .set("sequenceSize", 1000)
+        .set("seed", JsonValue{})
+    );
+    long first;
+    {
+        // more than a transaction
+        SqliteResultWriter writer{fileName, metadata};
+        for (long run=0; run<5000; ++run) {
+            writer.write(makeRecord(run, RunStatus::OK));
+        }
+        writer.close();
+        first = writer.getConfigurationId();
+    }
+    {
+        // a second execution appends to the same database
+        SqliteResultWriter writer{fileName, metadata};
+        writer.write(makeRecord(0, RunStatus::TIMEOUT));
+        REQUIRE(writer.getConfigurationId() != first);
+    }
+
+    sqlite3* database;
+    REQUIRE(sqlite3_open(fileName.c_str(), &database) == SQLITE_OK);
+    REQUIRE(queryLong(database, "SELECT COUNT(*) FROM configurations WHERE algorithm = 'MERGESORT' AND sequenceSize = 1000 AND seed IS NULL;") == 2);
+    REQUIRE(queryLong(database, "SELECT COUNT(*) FROM runs WHERE configuration = " + std::to_string(first) + ";") == 5000);
+    REQUIRE(queryLong(database, "SELECT time FROM runs WHERE configuration = " + std::to_string(first) + " AND run = 4999;") == 5099);
+    REQUIRE(queryLong(database, "SELECT COUNT(*) FROM runs WHERE status = 'timeout';") == 1);
+    sqlite3_close(database);
+}
+#endif
@@ -0,0 +1,44 @@
+#include "catch.hpp"
+
+#include "RunMetadata.hpp"
+#include "TestFiles.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sched.h>
+#include <string>
+
+TEST_CASE("build metadata", "[metadata]") {
+    JsonValue build = getBuildMetadata();
+    REQUIRE_FALSE(build.get("gitRevision").asString().empty());
+    REQUIRE_FALSE(build.get("compiler").asString().empty());
+    REQUIRE(build.get("flags").asString().find("-std=c++11") != std::string::npos);
+    REQUIRE(build.has("buildType"));
+}
+
+TEST_CASE("host metadata from a fake procfs", "[metadata]") {
+    std::string root = makeTemplate("testRunMetadata");
+    std::string cpuinfo = root + "cpuinfo";
+    int cpu = sched_getcpu();
+    FILE* f = fopen(cpuinfo.c_str(), "w");
+    REQUIRE(f != nullptr);
+    // the same model for every processor, but a different frequency for ours
+    for (int i=0; i<=cpu + 1; ++i) {
+        fprintf(f, "processor\t: %d\nmodel name\t: Fake CPU @ 3.00GHz\ncpu MHz\t\t: %d.500\n\n", i, i == cpu ? 2999 : 1000);
+    }
+    fclose(f);
+
+    // no cpufreq in the fake sysfs: the frequency comes from cpuinfo
+    JsonValue host = getHostMetadata(root, root + "cpu");
+    REQUIRE(host.get("cpuModel").asString() == "Fake CPU @ 3.00GHz");
+    REQUIRE(host.get("cpuFrequency").asNumber() == Approx(2999.5));
+    REQUIRE(host.get("cpu").asInt() == cpu);
+    REQUIRE(host.get("timestamp").asString().size() == 20);
+    REQUIRE_FALSE(host.get("kernel").isNull());
+}
+
+TEST_CASE("host metadata without procfs", "[metadata]") {
+    JsonValue host = getHostMetadata("/nonexistent", "/nonexistent");
+    REQUIRE(host.get("cpuModel").isNull());
+    REQUIRE(host.get("cpuFrequency").isNull());
+}
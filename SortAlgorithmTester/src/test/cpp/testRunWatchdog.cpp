@@ -0,0 +1,33 @@
+#include "catch.hpp"
+
+#include "RunWatchdog.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+static volatile long sink;
+
+TEST_CASE("watchdog", "[watchdog]") {
+    REQUIRE_THROWS_AS(RunWatchdog(0), std::domain_error);
+
+    RunWatchdog watchdog{0.05};
+    REQUIRE_THROWS_AS(RunWatchdog(1), std::domain_error);
+
+    SECTION("a quick job completes") {
+        bool done = false;
+        REQUIRE(watchdog.run([&done]() { done = true; }));
+        REQUIRE(done);
+    }
+
+    SECTION("an endless job is abandoned, and the watchdog can be used again") {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE_FALSE(watchdog.run([]() {
+            while (true) {
+                sink = sink + 1;
+            }
+        }));
+        REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds{50});
+
+        REQUIRE(watchdog.run([]() {}));
+    }
+}
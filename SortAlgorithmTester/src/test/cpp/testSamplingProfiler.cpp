@@ -0,0 +1,49 @@
+#include "catch.hpp"
+
+#include "SamplingProfiler.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+static volatile long sink;
+
+static void spin(int milliseconds) {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds{milliseconds}) {
+        for (long i=0; i<1000; ++i) {
+            sink = sink + i;
+        }
+    }
+}
+
+TEST_CASE("profiler samples only while armed", "[profiler]") {
+    SamplingProfiler profiler{1000, 1000, 32};
+    REQUIRE_THROWS_AS(SamplingProfiler(1000, 10, 8), std::domain_error);
+
+    spin(50);
+    REQUIRE(profiler.getSampleCount() == 0);
+
+    profiler.arm();
+    spin(100);
+    profiler.disarm();
+    std::size_t samples = profiler.getSampleCount();
+    REQUIRE(samples > 0);
+
+    spin(50);
+    REQUIRE(profiler.getSampleCount() == samples);
+
+    FILE* f = tmpfile();
+    profiler.writeFoldedStacks(f);
+    rewind(f);
+    char line[4096];
+    std::size_t total = 0;
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        const char* count = strrchr(line, ' ');
+        REQUIRE(count != nullptr);
+        total += strtoul(count + 1, nullptr, 10);
+    }
+    fclose(f);
+    REQUIRE(total == samples);
+}
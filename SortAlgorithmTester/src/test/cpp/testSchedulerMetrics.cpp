@@ -0,0 +1,49 @@
+#include "catch.hpp"
+
+#include "SchedulerMetrics.hpp"
+
+#include <chrono>
+#include <thread>
+
+TEST_CASE("scheduler samples are monotonic", "[scheduler]") {
+    SchedulerProbe probe{};
+    SchedulerSample before = probe.sample();
+    volatile long x = 0;
+    for (long i=0; i<1000000; ++i) {
+        x += i;
+    }
+    SchedulerSample delta = probe.sample() - before;
+
+    REQUIRE(delta.voluntaryContextSwitches >= 0);
+    REQUIRE(delta.involuntaryContextSwitches >= 0);
+    // -1 means "not available on this system"
+    REQUIRE(delta.cpuMigrations >= -1);
+    REQUIRE(delta.runQueueDelay >= -1);
+}
+
+TEST_CASE("scheduler samples of another thread", "[scheduler]") {
+    // the probe of a thread reads the counters of that thread, not of the main one
+    int64_t runQueueDelay = -2;
+    std::thread other{[&runQueueDelay]() {
+        SchedulerProbe probe{};
+        SchedulerSample before = probe.sample();
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        runQueueDelay = (probe.sample() - before).runQueueDelay;
+    }};
+    other.join();
+    REQUIRE(runQueueDelay >= -1);
+}
+
+TEST_CASE("preemption flag", "[scheduler]") {
+    SchedulerSample quiet{3, 0, 0, 0};
+    REQUIRE_FALSE(quiet.isPreempted());
+
+    SchedulerSample preempted{0, 1, 0, 0};
+    REQUIRE(preempted.isPreempted());
+
+    SchedulerSample migrated{0, 0, 1, 0};
+    REQUIRE(migrated.isPreempted());
+
+    SchedulerSample unavailable{0, 0, -1, -1};
+    REQUIRE_FALSE(unavailable.isPreempted());
+}
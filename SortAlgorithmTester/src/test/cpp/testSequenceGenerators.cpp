@@ -0,0 +1,46 @@
+#include "catch.hpp"
+
+#include "SequenceGenerators.hpp"
+
+#include <algorithm>
+
+TEST_CASE("generated sequences have the requested size", "[generators]") {
+    for (auto& sequenceType : getSequenceTypeNames()) {
+        SECTION(sequenceType) {
+            REQUIRE(generateSequence(sequenceType, 0, 0, 100).size() == 0);
+            REQUIRE(generateSequence(sequenceType, 42, 0, 100).size() == 42);
+        }
+    }
+}
+
+TEST_CASE("generated sequences have the requested shape", "[generators]") {
+    std::vector<int> random = generateRandomSequence(1000, 5, 10);
+    REQUIRE(*std::min_element(random.begin(), random.end()) >= 5);
+    REQUIRE(*std::max_element(random.begin(), random.end()) <= 10);
+
+    std::vector<int> same = generateSameSequence(10, 5, 10);
+    REQUIRE(std::count(same.begin(), same.end(), same[0]) == 10);
+
+    REQUIRE(generateSortedSequence(3, 5, 10) == std::vector<int>{5, 6, 7});
+    REQUIRE(generateReverseSortedSequence(3, 5, 10) == std::vector<int>{10, 9, 8});
+
+    REQUIRE_THROWS_AS(generateSequence("ZIGZAG", 3, 5, 10), std::domain_error);
+}
+
+TEST_CASE("seeded generators", "[generators]") {
+    // the same numbers as rand(), with a state of their own
+    srand(42);
+    std::vector<int> expected = generateSequence("RANDOM", 1000, -5000, 5000);
+    RandomGenerator first{42};
+    RandomGenerator second{42};
+    srand(7);
+    int next = rand();
+    srand(7);
+    REQUIRE(generateSequence("RANDOM", 1000, -5000, 5000, first) == expected);
+    // rand() has not been touched
+    REQUIRE(rand() == next);
+    REQUIRE(generateSequence("RANDOM", 1000, -5000, 5000, second) == expected);
+
+    RandomGenerator other{43};
+    REQUIRE(generateSequence("RANDOM", 1000, -5000, 5000, other) != expected);
+}
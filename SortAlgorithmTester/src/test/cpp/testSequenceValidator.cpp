@@ -0,0 +1,65 @@
+#include "catch.hpp"
+
+#include "SequenceValidator.hpp"
+#include "SequenceGenerators.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+TEST_CASE("sortedness", "[validator]") {
+    REQUIRE(isSorted(std::vector<int>{}));
+    REQUIRE(isSorted(std::vector<int>{3}));
+    REQUIRE(isSorted(std::vector<int>{1, 1, 2, 3}));
+    REQUIRE_FALSE(isSorted(std::vector<int>{2, 1}));
+    REQUIRE_FALSE(isSorted(std::vector<int>{1, 2, 3, 0}));
+
+    SECTION("a single unordered pair is found wherever it is, with any number of threads") {
+        std::vector<int> sequence = generateSortedSequence(1 << 20, 0, 0);
+        REQUIRE(isSorted(sequence, 1));
+        REQUIRE(isSorted(sequence, 4));
+        for (std::size_t position : std::vector<std::size_t>{0, 15, 16, 17, (1 << 18) - 1, 1 << 18, sequence.size() - 2}) {
+            std::vector<int> broken{sequence};
+            std::swap(broken[position], broken[position + 1]);
+            REQUIRE_FALSE(isSorted(broken, 1));
+            REQUIRE_FALSE(isSorted(broken, 4));
+        }
+    }
+}
+
+TEST_CASE("multiset hash", "[validator]") {
+    srand(0);
+    std::vector<int> sequence = generateRandomSequence(1 << 20, -1000, 1000);
+    std::vector<int> sorted{sequence};
+    std::sort(sorted.begin(), sorted.end());
+
+    REQUIRE(multisetHash(sequence, 1) == multisetHash(sorted, 1));
+    REQUIRE(multisetHash(sequence, 1) == multisetHash(sequence, 4));
+
+    std::vector<int> altered{sorted};
+    altered[10] += 1;
+    REQUIRE(multisetHash(altered, 1) != multisetHash(sorted, 1));
+}
+
+TEST_CASE("validator catches outputs which are not a permutation of the input", "[validator]") {
+    SequenceValidator validator{2};
+    std::vector<int> input{300, 5, 200, 5};
+    validator.recordInput(input);
+
+    REQUIRE(validator.validate(std::vector<int>{5, 5, 200, 300}));
+    // e.g., numbers truncated to char
+    REQUIRE_FALSE(validator.validate(std::vector<int>{5, 5, 44, 200}));
+    REQUIRE_FALSE(validator.validate(std::vector<int>{5, 200, 300}));
+    REQUIRE_FALSE(validator.validate(std::vector<int>{5, 5, 300, 200}));
+}
+
+TEST_CASE("validation threads are kept in a pool", "[validator]") {
+    std::vector<int> sequence = generateSortedSequence(1 << 20, 0, 0);
+    ThreadPool pool{3};
+    REQUIRE(isSorted(sequence, pool));
+    REQUIRE(multisetHash(sequence, pool) == multisetHash(sequence, 1));
+    std::swap(sequence[1 << 19], sequence[(1 << 19) + 1]);
+    REQUIRE_FALSE(isSorted(sequence, pool));
+
+    SequenceValidator validator{4};
+    REQUIRE(validator.getThreadCount() == 4);
+}
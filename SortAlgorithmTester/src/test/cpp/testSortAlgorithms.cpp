@@ -0,0 +1,151 @@
+#include "catch.hpp"
+
+#include "SortAlgorithms.hpp"
+#include "SequenceGenerators.hpp"
+#include "SequenceValidator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+static const EngineParameters parameters{10.0/13, 8, 8};
+
+TEST_CASE("engines sort every sequence type", "[engines]") {
+    for (auto& algorithm : getSortAlgorithmNames()) {
+        for (auto& sequenceType : getSequenceTypeNames()) {
+            SECTION(algorithm + " " + sequenceType) {
+                srand(0);
+                std::vector<int> sequence = generateSequence(sequenceType, 500, 0, 1000);
+                std::vector<int> expected{sequence};
+                std::sort(expected.begin(), expected.end());
+
+                std::unique_ptr<ISortAlgorithm> alg{createSortAlgorithm(algorithm, 1000, parameters)};
+                alg->reset(sequence.size());
+                alg->sort(sequence);
+
+                REQUIRE(sequence == expected);
+                REQUIRE(isSorted(sequence));
+            }
+        }
+    }
+}
+
+TEST_CASE("engines handle degenerate sequences", "[engines]") {
+    for (auto& algorithm : getSortAlgorithmNames()) {
+        SECTION(algorithm) {
+            std::unique_ptr<ISortAlgorithm> alg{createSortAlgorithm(algorithm, 10, parameters)};
+            std::vector<int> empty{};
+            std::vector<int> single{7};
+
+            alg->reset(empty.size());
+            REQUIRE(alg->sort(empty).empty());
+            alg->reset(single.size());
+            REQUIRE(alg->sort(single) == std::vector<int>{7});
+        }
+    }
+}
+
+TEST_CASE("engine tunables", "[engines]") {
+    srand(0);
+    std::vector<int> input = generateRandomSequence(2000, -100000, 100000);
+    std::vector<int> expected{input};
+    std::sort(expected.begin(), expected.end());
+
+    for (int bits : std::vector<int>{1, 3, 8, 11, 16}) {
+        SECTION("radix digit of " + std::to_string(bits) + " bits") {
+            std::unique_ptr<ISortAlgorithm> alg{createSortAlgorithm("RADIXSORT", 0, EngineParameters{0.5, 1, bits})};
+            std::vector<int> sequence{input};
+            REQUIRE(alg->sort(sequence) == expected);
+        }
+    }
+    for (int threshold : std::vector<int>{1, 2, 16, 5000}) {
+        SECTION("small sort threshold " + std::to_string(threshold)) {
+            std::unique_ptr<ISortAlgorithm> alg{createSortAlgorithm("MERGESORT", 0, EngineParameters{0.5, threshold, 8})};
+            std::vector<int> sequence{input};
+            REQUIRE(alg->sort(sequence) == expected);
+        }
+    }
+
+    REQUIRE_THROWS_AS(createSortAlgorithm("RADIXSORT", 0, EngineParameters{0.5, 8, 0}), std::domain_error);
+    REQUIRE_THROWS_AS(createSortAlgorithm("MERGESORT", 0, EngineParameters{0.5, 0, 8}), std::domain_error);
+    REQUIRE_THROWS_AS(createSortAlgorithm("COMBSORT", 0, EngineParameters{1.3, 8, 8}), std::domain_error);
+}
+
+TEST_CASE("engines sort sequences beyond the stack", "[engines]") {
+    // 32 MiB of temporaries: more than a default stack holds
+    RandomGenerator random{0};
+    std::vector<int> input = generateRandomSequence(1 << 23, 0, 1 << 20, random);
+    std::vector<int> expected{input};
+    std::sort(expected.begin(), expected.end());
+
+    for (const char* algorithm : {"MERGESORT", "COUNTSORT", "RADIXSORT"}) {
+        SECTION(algorithm) {
+            std::unique_ptr<ISortAlgorithm> alg{createSortAlgorithm(algorithm, 1 << 20, parameters)};
+            std::vector<int> sequence{input};
+            alg->reset(sequence.size());
+            REQUIRE(alg->sort(sequence) == expected);
+        }
+    }
+}
+
+TEST_CASE("engines reuse their scratch arena", "[engines]") {
+    for (auto& algorithm : getSortAlgorithmNames()) {
+        SECTION(algorithm) {
+            std::unique_ptr<ISortAlgorithm> alg{createSortAlgorithm(algorithm, 1000, parameters)};
+            const ScratchArena* scratch = alg->getScratchArena();
+            if (algorithm == "BUBBLESORT" || algorithm == "COMBSORT") {
+                REQUIRE(scratch == nullptr);
+                continue;
+            }
+            REQUIRE(scratch != nullptr);
+            alg->reset(10000);
+            REQUIRE(scratch->getCapacity() >= ScratchArena::footprint<int>(10000));
+            const PageAllocation* memory = scratch->getMemory();
+            REQUIRE(reinterpret_cast<uintptr_t>(memory->getData()) % ScratchArena::ALIGNMENT == 0);
+
+            // smaller sequences, even without reset, sort in the same memory
+            for (int size : {10000, 500, 0, 9999}) {
+                srand(size);
+                std::vector<int> sequence = generateRandomSequence(size, 0, 1000);
+                std::vector<int> expected{sequence};
+                std::sort(expected.begin(), expected.end());
+                if (size != 500) {
+                    alg->reset(sequence.size());
+                }
+                REQUIRE(alg->sort(sequence) == expected);
+                REQUIRE(scratch->getMemory() == memory);
+            }
+            // a bigger one grows it
+            alg->reset(20000);
+            REQUIRE(scratch->getCapacity() >= ScratchArena::footprint<int>(20000));
+        }
+    }
+}
+
+TEST_CASE("scratch arena", "[engines]") {
+    ScratchArena arena{PageKind::THP};
+    REQUIRE(arena.getCapacity() == 0);
+    REQUIRE(arena.getMemory() == nullptr);
+    REQUIRE(ScratchArena::footprint<int>(0) == 0);
+    REQUIRE(ScratchArena::footprint<int>(1) == ScratchArena::ALIGNMENT);
+    REQUIRE(ScratchArena::footprint<char>(ScratchArena::ALIGNMENT + 1) == 2 * ScratchArena::ALIGNMENT);
+
+    arena.reserve(3 * ScratchArena::ALIGNMENT);
+    REQUIRE(arena.getMemory()->getRequested() == PageKind::THP);
+    char* first = arena.take<char>(1);
+    int* second = arena.take<int>(ScratchArena::ALIGNMENT / sizeof(int));
+    REQUIRE(reinterpret_cast<char*>(second) == first + ScratchArena::ALIGNMENT);
+    REQUIRE_THROWS_AS(arena.take<int>(ScratchArena::ALIGNMENT / sizeof(int) + 1), std::domain_error);
+    arena.take<int>(ScratchArena::ALIGNMENT / sizeof(int));
+    REQUIRE_THROWS_AS(arena.take<char>(1), std::domain_error);
+
+    // reserving releases every buffer
+    arena.reserve(ScratchArena::ALIGNMENT);
+    REQUIRE(arena.take<char>(1) == first);
+}
+
+TEST_CASE("unknown engine", "[engines]") {
+    REQUIRE_THROWS_AS(createSortAlgorithm("QUICKSORT", 10, parameters), std::domain_error);
+}
@@ -0,0 +1,137 @@
+#include "catch.hpp"
+
+#include "SortBench.h"
+#include "TestFiles.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+static sb_config* makeConfig(const std::string& outputTemplate) {
+    sb_config* config = sb_config_create();
+    REQUIRE(config != nullptr);
+    REQUIRE(sb_config_set_json(config, "{\"sequenceSize\": 1000, \"sequenceType\": \"RANDOM\", \"lowerBound\": 0, \"upperBound\": 1000}") == SB_OK);
+    REQUIRE(sb_config_set(config, "algorithm", "MERGESORT") == SB_OK);
+    REQUIRE(sb_config_set(config, "runs", "5") == SB_OK);
+    REQUIRE(sb_config_set(config, "seed", "3") == SB_OK);
+    REQUIRE(sb_config_set(config, "validationThreads", "1") == SB_OK);
+    REQUIRE(sb_config_set(config, "outputTemplate", outputTemplate.c_str()) == SB_OK);
+    return config;
+}
+
+TEST_CASE("c api", "[sortbench]") {
+    sb_config* config = makeConfig(makeTemplate("testSortBench"));
+    REQUIRE(sb_config_set(config, "discardPreempted", "true") == SB_OK);
+    REQUIRE(sb_config_set(config, "discardPreempted", "yes") == SB_ERROR);
+    REQUIRE(sb_config_set(config, "nope", "1") == SB_ERROR);
+    REQUIRE(sb_config_set_json(config, "[1, 2]") == SB_ERROR);
+
+    sb_results* results = nullptr;
+    REQUIRE(sb_run(config, &results) == SB_OK);
+    REQUIRE(sb_results_exit_code(results) == SB_OK);
+    REQUIRE(sb_results_error(results) == nullptr);
+    REQUIRE(sb_results_count(results) == 5);
+    for (std::size_t i=0; i<sb_results_count(results); ++i) {
+        sb_run_record record;
+        REQUIRE(sb_results_get(results, i, &record) == SB_OK);
+        REQUIRE(record.run == static_cast<long>(i));
+        REQUIRE(record.status == SB_RUN_OK);
+    }
+    sb_run_record record;
+    REQUIRE(sb_results_get(results, 5, &record) == SB_ERROR);
+    sb_results_destroy(results);
+
+    // an invalid configuration has its reason in the results
+    REQUIRE(sb_config_set(config, "sequenceType", "ZIGZAG") == SB_OK);
+    REQUIRE(sb_run(config, &results) == SB_ERROR);
+    REQUIRE(sb_results_error(results) != nullptr);
+    REQUIRE(sb_results_count(results) == 0);
+    sb_results_destroy(results);
+    REQUIRE(sb_run(config, nullptr) == SB_ERROR);
+    sb_config_destroy(config);
+}
+
+TEST_CASE("concurrent c api runs", "[sortbench]") {
+    const int threads = 4;
+    std::vector<sb_config*> configs{};
+    std::vector<sb_environment*> environments{};
+    for (int i=0; i<threads; ++i) {
+        configs.push_back(makeConfig(makeTemplate("testSortBench")));
+        environments.push_back(sb_environment_create(1 << 20));
+    }
+    std::vector<int> exitCodes(threads, SB_ERROR);
+    std::vector<std::size_t> runs(threads, 0);
+    std::vector<std::thread> workers{};
+    for (int i=0; i<threads; ++i) {
+        workers.emplace_back([&, i]() {
+            sb_results* results = nullptr;
+            // twice: the second execution replays the cached sequences
+            for (int repetition=0; repetition<2; ++repetition) {
+                exitCodes[i] = sb_run_in(environments[i], configs[i], &results);
+                runs[i] += sb_results_count(results);
+                sb_results_destroy(results);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (int i=0; i<threads; ++i) {
+        REQUIRE(exitCodes[i] == SB_OK);
+        REQUIRE(runs[i] == 10);
+        sb_environment_destroy(environments[i]);
+        sb_config_destroy(configs[i]);
+    }
+}
+
+TEST_CASE("c api records and generators", "[sortbench]") {
+    sb_config* config = makeConfig(makeTemplate("testSortBench"));
+    sb_results* results = nullptr;
+    REQUIRE(sb_run(config, &results) == SB_OK);
+    const sb_run_record* records = sb_results_records(results);
+    for (std::size_t i=0; i<sb_results_count(results); ++i) {
+        sb_run_record record;
+        REQUIRE(sb_results_get(results, i, &record) == SB_OK);
+        REQUIRE(records[i].run == record.run);
+        REQUIRE(records[i].time == record.time);
+    }
+    sb_results_destroy(results);
+    sb_config_destroy(config);
+
+    REQUIRE(std::string{sb_algorithm_name(0)} == "BUBBLESORT");
+    std::size_t algorithms = 0;
+    while (sb_algorithm_name(algorithms) != nullptr) {
+        ++algorithms;
+    }
+    REQUIRE(algorithms > 1);
+    REQUIRE(std::string{sb_sequence_type_name(0)} == "RANDOM");
+
+    // the sequence of the first run
+    std::vector<int> first(1000);
+    std::vector<int> second(1000);
+    REQUIRE(sb_generate("RANDOM", first.size(), 0, 1000, 3, first.data()) == SB_OK);
+    REQUIRE(sb_generate("RANDOM", second.size(), 0, 1000, 3, second.data()) == SB_OK);
+    REQUIRE(first == second);
+    REQUIRE(sb_generate("ZIGZAG", second.size(), 0, 1000, 3, second.data()) == SB_ERROR);
+}
+
+TEST_CASE("c api without result files", "[sortbench]") {
+    std::string outputTemplate = makeTemplate("testSortBench");
+    sb_config* config = makeConfig(outputTemplate);
+    REQUIRE(sb_config_set(config, "noResultFiles", "true") == SB_OK);
+    sb_results* results = nullptr;
+    REQUIRE(sb_run(config, &results) == SB_OK);
+    REQUIRE(sb_results_count(results) == 5);
+    sb_results_destroy(results);
+    // the runs are only in the results
+    REQUIRE(readFile(outputTemplate + "kind:type=main|.csv").empty());
+    REQUIRE(readFile(outputTemplate + "kind:type=summary|.csv").empty());
+    REQUIRE(readFile(outputTemplate + "kind:type=complete|.json").empty());
+
+    // nothing could be skipped: there are no files recording the completion
+    REQUIRE(sb_config_set(config, "skipIfComplete", "true") == SB_OK);
+    REQUIRE(sb_run(config, &results) == SB_ERROR);
+    sb_results_destroy(results);
+    sb_config_destroy(config);
+}
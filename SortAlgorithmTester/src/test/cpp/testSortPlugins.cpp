@@ -0,0 +1,79 @@
+#include "catch.hpp"
+
+#include "SortPlugins.hpp"
+#include "TestContext.hpp"
+#include "TestFiles.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef SORT_PLUGIN_EXAMPLE
+
+TEST_CASE("plugin engines", "[plugins]") {
+    SortPluginRegistry registry{};
+    REQUIRE(registry.getAlgorithmNames().empty());
+    registry.load(SORT_PLUGIN_EXAMPLE);
+    // loaded once
+    registry.load(SORT_PLUGIN_EXAMPLE);
+    REQUIRE(registry.getAlgorithmNames() == std::vector<std::string>{"SHELLSORT", "STDSORT"});
+    REQUIRE(registry.find("SHELLSORT")->capabilities == SORT_PLUGIN_ABANDONABLE);
+    REQUIRE(registry.find("MERGESORT") == nullptr);
+
+    EngineParameters parameters{};
+    for (auto& name : registry.getAlgorithmNames()) {
+        std::unique_ptr<ISortAlgorithm> engine{registry.create(name, 1000, parameters, "")};
+        for (std::size_t size : {0, 1, 2, 100, 10000}) {
+            std::vector<int> sequence(size);
+            for (auto& number : sequence) {
+                number = rand() % 1000;
+            }
+            std::vector<int> expected = sequence;
+            std::sort(expected.begin(), expected.end());
+            engine->reset(sequence.size());
+            REQUIRE(engine->sort(sequence) == expected);
+        }
+    }
+    // built-in engines are still there
+    parameters.shrinkFactor = 0.8;
+    std::unique_ptr<ISortAlgorithm> builtIn{registry.create("COMBSORT", 1000, parameters, "")};
+    REQUIRE(builtIn);
+    REQUIRE_THROWS_AS(registry.create("NOSORT", 1000, parameters, ""), std::domain_error);
+}
+
+TEST_CASE("test context with a plugin", "[plugins]") {
+    TestContext context{};
+    context.sequenceSize = 1000;
+    context.sequenceType = "RANDOM";
+    context.algorithm = "SHELLSORT";
+    context.lowerBound = 0;
+    context.upperBound = 1000;
+    context.runs = 3;
+    context.seed = 1;
+    context.outputTemplate = makeTemplate("testSortPlugins");
+    context.validationThreads = 1;
+    TestEnvironment environment{};
+
+    REQUIRE_THROWS_AS(executeTestContext(context, JsonValue::object(), environment), std::domain_error);
+    context.plugins = {SORT_PLUGIN_EXAMPLE};
+    context.runTimeout = 10;
+    REQUIRE(executeTestContext(context, JsonValue::object(), environment) == 0);
+
+    // the options of a request can repeat --plugin
+    TestContext parsed{};
+    JsonValue parameters = parseTestContext(JsonValue::parse(
+        "{\"sequenceSize\": 10, \"sequenceType\": \"RANDOM\", \"algorithm\": \"STDSORT\", \"lowerBound\": 0, "
+        "\"upperBound\": 10, \"runs\": 1, \"seed\": 1, \"outputTemplate\": \"x\", \"plugin\": [\"a.so\", \"b.so\"]}"
+    ), {}, parsed);
+    REQUIRE(parsed.plugins == std::vector<std::string>{"a.so", "b.so"});
+    REQUIRE(parameters.get("plugin").asArray().size() == 2);
+}
+
+#endif
+
+TEST_CASE("invalid plugins", "[plugins]") {
+    SortPluginRegistry registry{};
+    REQUIRE_THROWS_AS(registry.load("/nonexistent/plugin.so"), std::domain_error);
+    // a shared library which is not a plugin
+    REQUIRE_THROWS_WITH(registry.load("libm.so.6"), Catch::Contains("sortPluginEngines"));
+    REQUIRE(registry.getAlgorithmNames().empty());
+}
@@ -0,0 +1,283 @@
+#include "catch.hpp"
+
+#include "TestContext.hpp"
+#include "SequenceGenerators.hpp"
+#include "Checkpoint.hpp"
+#include "TestFiles.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+static TestContext makeContext(const std::string& outputTemplate) {
+    TestContext context{};
+    context.sequenceSize = 100;
+    context.sequenceType = "RANDOM";
+    context.algorithm = "MERGESORT";
+    context.lowerBound = 0;
+    context.upperBound = 1000;
+    context.runs = 5;
+    context.seed = 7;
+    context.outputTemplate = outputTemplate;
+    context.validationThreads = 1;
+    return context;
+}
+
+/**
+ * Collects the records written by a test context
+ */
+class CollectingResultWriter : public ResultWriter {
+public:
+    virtual void write(const RunRecord& record) {
+        this->records.push_back(record);
+    }
+    virtual void close() {
+    }
+    std::vector<RunRecord> records;
+};
+
+TEST_CASE("command line of a test context", "[testContext]") {
+    CLI::App app{"test"};
+    TestContext context{};
+    addTestContextOptions(app, context);
+    const char* argv[] = {"test", "--sequenceSize", "10", "--sequenceType", "SORTED", "--algorithm", "BUBBLESORT",
+        "--lowerBound", "0", "--upperBound", "100", "--runs", "2", "--seed", "1", "--outputTemplate", "x", "--profile"};
+    app.parse(18, argv);
+    REQUIRE(context.sequenceSize == 10);
+    REQUIRE(context.algorithm == "BUBBLESORT");
+    REQUIRE(context.profile);
+
+    JsonValue described = describeCommandLine(app);
+    REQUIRE(described.get("sequenceSize").asInt() == 10);
+    REQUIRE(described.get("sequenceType").asString() == "SORTED");
+    REQUIRE(described.get("profile").asBool());
+    REQUIRE(described.get("outputFormat").asString() == "csv");
+    REQUIRE(described.get("resultDb").isNull());
+}
+
+TEST_CASE("sequences of a test context", "[testContext]") {
+    TestContext context = makeContext("");
+    srand(context.seed);
+    std::vector<std::vector<int>> expected{};
+    for (int run=0; run<context.runs; ++run) {
+        expected.push_back(generateSequence(context.sequenceType, context.sequenceSize, context.lowerBound, context.upperBound));
+    }
+
+    SECTION("without cache") {
+        TestEnvironment environment{};
+        for (int repetition=0; repetition<2; ++repetition) {
+            environment.startSequences(context);
+            for (int run=0; run<context.runs; ++run) {
+                REQUIRE(environment.nextSequence() == expected[run]);
+            }
+        }
+        REQUIRE(environment.getCachedSequenceBytes() == 0);
+    }
+
+    SECTION("with cache") {
+        TestEnvironment environment{1 << 20};
+        environment.startSequences(context);
+        for (int run=0; run<context.runs; ++run) {
+            REQUIRE(environment.nextSequence() == expected[run]);
+        }
+        REQUIRE(environment.getCachedSequenceBytes() == context.runs * context.sequenceSize * sizeof(int));
+
+        // rand would give other numbers now: the sequences need to come from the cache
+        srand(12345);
+        environment.startSequences(context);
+        for (int run=0; run<context.runs; ++run) {
+            REQUIRE(environment.nextSequence() == expected[run]);
+        }
+        // fewer runs can be served by the cache as well
+        context.runs = 2;
+        environment.startSequences(context);
+        REQUIRE(environment.nextSequence() == expected[0]);
+    }
+
+    SECTION("sequences not fitting the cache are dropped") {
+        TestEnvironment environment{context.runs * context.sequenceSize * sizeof(int)};
+        environment.startSequences(context);
+        for (int run=0; run<context.runs; ++run) {
+            environment.nextSequence();
+        }
+        TestContext other = makeContext("");
+        other.seed = 8;
+        environment.startSequences(other);
+        for (int run=0; run<other.runs; ++run) {
+            environment.nextSequence();
+        }
+        REQUIRE(environment.getCachedSequenceBytes() == context.runs * context.sequenceSize * sizeof(int));
+
+        // the first context has been evicted, and is generated again
+        environment.startSequences(context);
+        for (int run=0; run<context.runs; ++run) {
+            REQUIRE(environment.nextSequence() == expected[run]);
+        }
+    }
+}
+
+TEST_CASE("execute a test context", "[testContext]") {
+    std::string outputTemplate = makeTemplate("testTestContext");
+    TestContext context = makeContext(outputTemplate);
+    TestEnvironment environment{1 << 20};
+    CollectingResultWriter observer{};
+
+    REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+    REQUIRE(observer.records.size() == 5);
+    REQUIRE(observer.records[4].run == 4);
+    REQUIRE(observer.records[4].status == RunStatus::OK);
+    std::string main = readFile(outputTemplate + "kind:type=main|.csv");
+    REQUIRE(std::count(main.begin(), main.end(), '\n') == 6);
+    REQUIRE_FALSE(readFile(outputTemplate + "kind:type=summary|.csv").empty());
+
+    // the environment serves another context
+    context.algorithm = "RADIXSORT";
+    REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+    REQUIRE(observer.records.size() == 10);
+
+    context.algorithm = "NOSORT";
+    REQUIRE_THROWS_AS(executeTestContext(context, JsonValue::object(), environment), std::domain_error);
+
+    // without files, nobody but the observer would see the runs
+    context.algorithm = "MERGESORT";
+    context.noResultFiles = true;
+    REQUIRE_THROWS_AS(executeTestContext(context, JsonValue::object(), environment), std::domain_error);
+}
+
+TEST_CASE("isolated runs", "[testContext]") {
+    std::string outputTemplate = makeTemplate("testTestContext");
+    TestContext context = makeContext(outputTemplate);
+    // the children validate without the worker threads of the parent
+    context.validationThreads = 2;
+    TestEnvironment environment{1 << 20};
+
+    for (const char* isolation : {"fork", "fork-per-run"}) {
+        CollectingResultWriter observer{};
+        context.isolation = isolation;
+        REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+        REQUIRE(observer.records.size() == 5);
+        for (int run=0; run<5; ++run) {
+            REQUIRE(observer.records[run].run == run);
+            REQUIRE(observer.records[run].status == RunStatus::OK);
+        }
+        std::string main = readFile(outputTemplate + "kind:type=main|.csv");
+        REQUIRE(std::count(main.begin(), main.end(), '\n') == 6);
+    }
+
+    // a run which times out stops the others, as without isolation
+    CollectingResultWriter observer{};
+    context.algorithm = "BUBBLESORT";
+    context.sequenceSize = 100000;
+    context.runTimeout = 0.05;
+    REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+    REQUIRE(observer.records.size() == 1);
+    REQUIRE(observer.records[0].status == RunStatus::TIMEOUT);
+
+    context.runTimeout = 0;
+    context.profile = true;
+    REQUIRE_THROWS_AS(executeTestContext(context, JsonValue::object(), environment), std::domain_error);
+    context.profile = false;
+    context.isolation = "thread";
+    REQUIRE_THROWS_AS(executeTestContext(context, JsonValue::object(), environment), std::domain_error);
+}
+
+TEST_CASE("numa placement of a test context", "[testContext]") {
+    std::string outputTemplate = makeTemplate("testTestContext");
+    TestContext context = makeContext(outputTemplate);
+    context.sequenceSize = 1 << 19;
+    context.validationThreads = 2;
+    TestEnvironment environment{};
+
+    for (const char* policy : {"interleave", "local", "firstTouchParallel"}) {
+        CollectingResultWriter observer{};
+        context.numa = policy;
+        REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+        REQUIRE(observer.records.size() == 5);
+        // a line per node, every page of the buffer on one of them
+        std::stringstream numa{readFile(outputTemplate + "kind:type=numa|.csv")};
+        std::string line;
+        std::getline(numa, line);
+        REQUIRE(line == "node,pages,bytes,bytesPerSecond,localAllocations,remoteAllocations");
+        long pages = 0;
+        while (std::getline(numa, line)) {
+            std::size_t comma = line.find(',');
+            pages += atol(line.c_str() + comma + 1);
+        }
+        REQUIRE(pages * sysconf(_SC_PAGESIZE) >= static_cast<long>(context.sequenceSize * sizeof(int)));
+    }
+
+    // forked children have none of the worker threads of the parent: they pin their own ones
+    for (const char* isolation : {"fork", "fork-per-run"}) {
+        for (const char* policy : {"local", "firstTouchParallel"}) {
+            CollectingResultWriter observer{};
+            context.numa = policy;
+            context.isolation = isolation;
+            REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+            REQUIRE(observer.records.size() == 5);
+        }
+    }
+    context.isolation = "none";
+
+    context.numa = "remote";
+    REQUIRE_THROWS_AS(executeTestContext(context, JsonValue::object(), environment), std::domain_error);
+}
+
+TEST_CASE("huge pages of a test context", "[testContext]") {
+    std::string outputTemplate = makeTemplate("testTestContext");
+    TestContext context = makeContext(outputTemplate);
+    context.sequenceSize = 1 << 20;
+    TestEnvironment environment{};
+
+    context.algorithm = "RADIXSORT";
+    for (const char* pages : {"thp", "hugetlb2M", "hugetlb1G"}) {
+        CollectingResultWriter observer{};
+        context.pages = pages;
+        REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+        REQUIRE(observer.records.size() == 5);
+        std::stringstream report{readFile(outputTemplate + "kind:type=pages|.csv")};
+        std::string line;
+        std::getline(report, line);
+        REQUIRE(line == "buffer,requested,obtained,bytes,hugePages,hugePageBytes");
+        std::getline(report, line);
+        REQUIRE(line.compare(0, 9 + strlen(pages), std::string{"sequence,"} + pages) == 0);
+        // the scratch buffers of the engine
+        std::getline(report, line);
+        REQUIRE(line.compare(0, 8 + strlen(pages), std::string{"scratch,"} + pages) == 0);
+    }
+
+    context.pages = "hugetlb4M";
+    REQUIRE_THROWS_AS(executeTestContext(context, JsonValue::object(), environment), std::domain_error);
+}
+
+TEST_CASE("skip complete test contexts", "[testContext]") {
+    std::string outputTemplate = makeTemplate("testTestContext");
+    TestContext context = makeContext(outputTemplate);
+    context.skipIfComplete = true;
+    TestEnvironment environment{};
+    CollectingResultWriter observer{};
+
+    REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+    REQUIRE(observer.records.size() == 5);
+    int exitCode = -1;
+    REQUIRE(isOutputComplete(outputTemplate, exitCode));
+    REQUIRE(exitCode == 0);
+
+    // nothing to do the second time
+    REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+    REQUIRE(observer.records.size() == 5);
+
+    // a damaged main file is written again
+    FILE* main = fopen((outputTemplate + "kind:type=main|.csv").c_str(), "a");
+    fputs("garbage\n", main);
+    fclose(main);
+    REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+    REQUIRE(observer.records.size() == 10);
+    REQUIRE(isOutputComplete(outputTemplate, exitCode));
+
+    // without the flag, the context runs anyway
+    context.skipIfComplete = false;
+    REQUIRE(executeTestContext(context, JsonValue::object(), environment, &observer) == 0);
+    REQUIRE(observer.records.size() == 15);
+}
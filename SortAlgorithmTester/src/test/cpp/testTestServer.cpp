@@ -0,0 +1,79 @@
+#include "catch.hpp"
+
+#include "TestServer.hpp"
+#include "TestFiles.hpp"
+
+#include <cstdlib>
+#include <unistd.h>
+
+/**
+ * @return every line the server wrote in responses, parsed
+ */
+static std::vector<JsonValue> readResponses(FILE* responses) {
+    std::vector<JsonValue> result{};
+    rewind(responses);
+    char* line = nullptr;
+    std::size_t capacity = 0;
+    while (getline(&line, &capacity, responses) >= 0) {
+        result.push_back(JsonValue::parse(line));
+    }
+    free(line);
+    return result;
+}
+
+static std::string makeRequest(const std::string& outputTemplate, int id, bool streamRuns) {
+    return JsonValue::object()
+        .set("id", id)
+        .set("sequenceSize", 100)
+        .set("sequenceType", "RANDOM")
+        .set("algorithm", "MERGESORT")
+        .set("lowerBound", 0)
+        .set("upperBound", 1000)
+        .set("runs", 3)
+        .set("seed", 1)
+        .set("outputTemplate", outputTemplate)
+        .set("validationThreads", 1)
+        .set("profile", false)
+        .set("tuningProfile", JsonValue{})
+        .set("streamRuns", streamRuns)
+        .dump();
+}
+
+TEST_CASE("server answers requests", "[server]") {
+    std::string outputTemplate = makeTemplate("testTestServer");
+    TestEnvironment environment{1 << 20};
+    TestServer server{environment};
+    FILE* requests = tmpfile();
+    FILE* responses = tmpfile();
+    fprintf(requests, "%s\n", makeRequest(outputTemplate, 1, true).c_str());
+    fprintf(requests, "\n%s\n", makeRequest(outputTemplate, 2, false).c_str());
+    fprintf(requests, "[1, 2]\n");
+    fprintf(requests, "{\"id\": \"bad\", \"algorithm\": \"MERGESORT\"}\n");
+    fprintf(requests, "{\"id\": 4, \"shutdown\": true}\n");
+    fprintf(requests, "%s\n", makeRequest(outputTemplate, 5, true).c_str());
+    rewind(requests);
+
+    REQUIRE_FALSE(server.serve(requests, responses));
+    std::vector<JsonValue> answers = readResponses(responses);
+    REQUIRE(answers.size() == 8);
+    for (int run=0; run<3; ++run) {
+        REQUIRE(answers[run].get("id").asInt() == 1);
+        REQUIRE(answers[run].get("event").asString() == "run");
+        REQUIRE(answers[run].get("run").asInt() == run);
+        REQUIRE(answers[run].get("status").asString() == "ok");
+    }
+    REQUIRE(answers[3].get("event").asString() == "done");
+    REQUIRE(answers[3].get("exitCode").asInt() == 0);
+    REQUIRE(answers[3].get("runs").asInt() == 3);
+    REQUIRE(answers[4].get("id").asInt() == 2);
+    REQUIRE(answers[4].get("event").asString() == "done");
+    REQUIRE(answers[5].get("event").asString() == "error");
+    REQUIRE(answers[5].get("id").isNull());
+    REQUIRE(answers[6].get("id").asString() == "bad");
+    REQUIRE(answers[6].get("event").asString() == "error");
+    REQUIRE(answers[7].get("event").asString() == "shutdown");
+    REQUIRE(access((outputTemplate + "kind:type=main|.csv").c_str(), F_OK) == 0);
+
+    fclose(requests);
+    fclose(responses);
+}
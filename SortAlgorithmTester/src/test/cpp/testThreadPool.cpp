@@ -0,0 +1,63 @@
+#include "catch.hpp"
+
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+TEST_CASE("thread pool", "[threadPool]") {
+    for (int workers : {0, 1, 3}) {
+        ThreadPool pool{workers};
+        REQUIRE(pool.getWorkerCount() == workers);
+        // batches reuse the same threads
+        for (int batch=0; batch<50; ++batch) {
+            std::vector<int> results(7, 0);
+            std::vector<std::function<void()>> jobs{};
+            for (int i=0; i<7; ++i) {
+                jobs.emplace_back([&results, i, batch]() { results[i] = i * batch; });
+            }
+            pool.runAll(jobs);
+            for (int i=0; i<7; ++i) {
+                REQUIRE(results[i] == i * batch);
+            }
+        }
+    }
+
+    SECTION("the first job is run by the calling thread") {
+        ThreadPool pool{2};
+        std::thread::id caller{};
+        std::vector<std::function<void()>> jobs{[&caller]() { caller = std::this_thread::get_id(); }};
+        pool.runAll(jobs);
+        REQUIRE(caller == std::this_thread::get_id());
+        pool.runAll(std::vector<std::function<void()>>{});
+    }
+}
+
+TEST_CASE("bound thread pool", "[threadPool]") {
+    ThreadPool pool{2};
+    pool.bindWorkers(std::vector<std::vector<int>>{std::vector<int>{}, std::vector<int>{}});
+    // with no more jobs than threads, each job always runs on the same thread
+    std::vector<std::thread::id> first(3);
+    for (int batch=0; batch<20; ++batch) {
+        std::vector<std::thread::id> threads(3);
+        std::vector<std::function<void()>> jobs{};
+        for (int i=0; i<3; ++i) {
+            jobs.emplace_back([&threads, i]() { threads[i] = std::this_thread::get_id(); });
+        }
+        pool.runAll(jobs);
+        REQUIRE(threads[0] == std::this_thread::get_id());
+        REQUIRE(std::set<std::thread::id>(threads.begin(), threads.end()).size() == 3);
+        if (batch == 0) {
+            first = threads;
+        }
+        REQUIRE(threads == first);
+    }
+    // bigger batches are shared as usual
+    std::atomic<int> done{0};
+    std::vector<std::function<void()>> jobs(10, [&done]() { ++done; });
+    pool.runAll(jobs);
+    REQUIRE(done.load() == 10);
+
+    REQUIRE_THROWS_AS(pool.bindWorkers(std::vector<std::vector<int>>{std::vector<int>{CPU_SETSIZE - 1}}), std::domain_error);
+}
@@ -0,0 +1,97 @@
+import os
+import tempfile
+import threading
+import unittest
+
+import sortbench
+
+
+class TestSortBench(unittest.TestCase):
+
+    def setUp(self):
+        # the files of the runs are removed with the directory when the test ends
+        directory = tempfile.TemporaryDirectory(prefix="testSortBench")
+        self.addCleanup(directory.cleanup)
+        self.directory = directory.name
+
+    def _options(self, **overrides):
+        options = {
+            "algorithm": "MERGESORT",
+            "sequenceType": "RANDOM",
+            "sequenceSize": 1000,
+            "lowerBound": 0,
+            "upperBound": 1000,
+            "runs": 5,
+            "seed": 3,
+            "validationThreads": 1,
+            "outputTemplate": self.directory + "/",
+        }
+        options.update(overrides)
+        return options
+
+    def test_run(self):
+        results = sortbench.run(self._options(discardPreempted=False))
+        self.assertEqual(results.exit_code, 0)
+        self.assertEqual(len(results), 5)
+        self.assertIn("time", results.columns)
+        # the columns view the records of the library, one every sizeof(sb_run_record) bytes
+        runs = memoryview(results.run)
+        self.assertTrue(runs.readonly)
+        self.assertEqual(runs.tolist(), [0, 1, 2, 3, 4])
+        self.assertEqual(memoryview(results.status).tolist(), [0] * 5)
+        self.assertTrue(all(t >= 0 for t in memoryview(results.time).tolist()))
+
+    def test_no_result_files(self):
+        results = sortbench.run(self._options(noResultFiles=True))
+        self.assertEqual(len(results), 5)
+        # the runs are only in the returned columns
+        self.assertEqual(os.listdir(self.directory), [])
+
+    def test_invalid_options(self):
+        with self.assertRaises(ValueError):
+            sortbench.run(self._options(nope=1))
+        with self.assertRaises(sortbench.Error):
+            sortbench.run(self._options(sequenceType="ZIGZAG"))
+
+    def test_environment(self):
+        environment = sortbench.Environment(sequenceCache=1 << 20)
+        options = self._options()
+        # the second execution replays the cached sequences
+        first = sortbench.run(options, environment)
+        second = sortbench.run(options, environment)
+        self.assertEqual(len(first), len(second))
+
+    def test_concurrent_runs(self):
+        errors = []
+
+        def worker(index):
+            # runs in process are independent: each one has its own environment and its own files
+            directory = os.path.join(self.directory, str(index))
+            os.mkdir(directory)
+            try:
+                sortbench.run(self._options(outputTemplate=directory + "/"), sortbench.Environment())
+            except Exception as e:
+                errors.append(e)
+
+        threads = [threading.Thread(target=worker, args=(index,)) for index in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(errors, [])
+
+    def test_generate(self):
+        self.assertIn("MERGESORT", sortbench.algorithms())
+        self.assertIn("RANDOM", sortbench.sequence_types())
+        sequence = memoryview(sortbench.generate("SORTED", 10, 0, 100))
+        self.assertEqual(sequence.tolist(), sorted(sequence.tolist()))
+        self.assertEqual(
+            memoryview(sortbench.generate("RANDOM", 100, 0, 1000, 3)).tolist(),
+            memoryview(sortbench.generate("RANDOM", 100, 0, 1000, 3)).tolist(),
+        )
+        with self.assertRaises(ValueError):
+            sortbench.generate("ZIGZAG", 10, 0, 100)
+
+
+if __name__ == "__main__":
+    unittest.main()